@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 
+class RTCMSettings;
+
 struct systemCalibration {
   float touchCal[6] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0 };   // Touchscreen calibration
 };
@@ -14,5 +16,28 @@ void beginFileSystem();
 
 void systemReset();
 
-void beginRTCMLink();
+void beginRTCMLink(RTCMSettings& settings);
+void updateRTCMLink();
+void reportLinkStatus();
+void rtcmFrameReady(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t epoch);
+
+bool beginGNSS();
+bool configureGNSS(bool wait = true);
+bool beginBaseMode();
+void updateBaseMode();
+bool beginPositionAverage();
+void updatePositionAverage();
+bool applyPositionAverage();
+void resetPositionAverage();
+void beginRTCMPlanner();
+void updateRTCMPlan();
+bool beginRTCMEncoder();
+bool beginNavDatabase();
+void updateNavDatabase();
+bool beginRawLogger();
+void updateRawLogger();
+void beginGNSSClock();
+void updateGNSSClock();
+void beginBusBudget();
+void updateBusBudget();
 #endif
\ No newline at end of file
@@ -2,11 +2,11 @@
 #define _SCREEN_MANAGER_H_
 
 #include <lvgl.h>
-#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <gnss_telemetry.h>
 #include "screens/screen.h"
 #include "status_bar.h"
 
-extern SFE_UBLOX_GNSS zedf9p;
+extern GNSSTelemetry gnssTelemetry;
 
 class Screen;
 
@@ -7,6 +7,7 @@
 #include "settings.h"
 #include "ui/screens/screen.h"
 #include "ui/widgets/spinbox_widgets.h"
+#include "ui/widgets/dropdown_widgets.h"
 
 extern gnssBaseSettings systemSettings;
 
@@ -31,6 +32,7 @@ private:
   lv_obj_t* glonass_cb;
   lv_obj_t* galileo_cb;
   lv_obj_t* beidou_cb;
+  Dropdown baseMode;
   SpinboxInt32 lat;
   SpinboxInt8 latHP;
   SpinboxInt32 lon;
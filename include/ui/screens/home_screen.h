@@ -3,10 +3,13 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
-#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <gnss_telemetry.h>
+#include <gnss_base_mode.h>
 #include "screen.h"
+#include "ui/widgets/sky_widgets.h"
 
-extern SFE_UBLOX_GNSS zedf9p;
+extern GNSSTelemetry gnssTelemetry;
+extern GNSSBaseMode gnssBaseMode;
 
 class ScreenManager;
 
@@ -25,6 +28,10 @@ private:
   lv_obj_t* _latVal;
   lv_obj_t* _lonVal;
   lv_obj_t* _accVal;
+  lv_obj_t* _baseVal;
+  lv_obj_t* _rtcmVal;
+  lv_obj_t* _satVal;
+  SkyView _skyView;
   
   elapsedMillis _lastUpdate = 0;
 };
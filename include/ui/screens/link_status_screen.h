@@ -0,0 +1,33 @@
+#ifndef _LINK_STATUS_SCREEN_H_
+#define _LINK_STATUS_SCREEN_H_
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <rtcm_link.h>
+#include "screen.h"
+#include "settings.h"
+
+extern RTCM_Link radioLink;
+extern gnssBaseSettings systemSettings;
+
+class ScreenManager;
+
+class LinkStatusScreen : public Screen {
+public:
+  void enter(ScreenManager* screenManager);
+  void update(ScreenManager* screenManager);
+  void exit(ScreenManager* screenManager);
+  static Screen& getInstance();
+ 
+private:
+  LinkStatusScreen() {}
+  LinkStatusScreen(const LinkStatusScreen& other);
+  LinkStatusScreen& operator=(const LinkStatusScreen& other);
+
+  lv_obj_t* _linkVal;
+  lv_obj_t* _roverTable;
+
+  elapsedMillis _lastUpdate = 0;
+};
+
+#endif
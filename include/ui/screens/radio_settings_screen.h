@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
+#include <rtcm_link.h>
 
 #include "settings.h"
 #include "ui/screens/screen.h"
@@ -10,6 +11,7 @@
 #include "ui/widgets/dropdown_widgets.h"
 
 extern gnssBaseSettings systemSettings;
+extern RTCM_Link radioLink;
 
 class ScreenManager;
 
@@ -21,7 +23,7 @@ class SettingsScreen : public Screen {
   static Screen& getInstance();
  
   void updateControls();
-  void updateSettings();
+  void updateSettings(RTCMSettings& settings);
 
  private:
   SettingsScreen() {}
@@ -3,8 +3,14 @@
 
 #include <Arduino.h>
 #include <lvgl.h>
+#include <gnss_averager.h>
+#include <gnss_bus_budget.h>
 #include "screen.h"
 
+extern GNSSAverager gnssAverager;
+extern GNSSBusBudget busBudget;
+extern GNSSTransport gnssTransport;
+
 class ScreenManager;
 
 
@@ -19,6 +25,11 @@ class SystemScreen : public Screen {
   SystemScreen() {}
   SystemScreen(const SystemScreen& other);
   SystemScreen& operator=(const SystemScreen& other);
+
+  lv_obj_t* _averageVal;
+  lv_obj_t* _busVal;
+
+  elapsedMillis _lastUpdate = 0;
 };
 
 #endif
\ No newline at end of file
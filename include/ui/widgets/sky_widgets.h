@@ -0,0 +1,17 @@
+#ifndef _SKY_WIDGETS_H_
+#define _SKY_WIDGETS_H_
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <gnss_sky_summary.h>
+
+struct SkyView{
+  lv_obj_t* sky;
+  lv_obj_t* satellites[SKY_MAX_SATELLITES];
+  lv_coord_t radius;
+};
+
+SkyView skyView(lv_obj_t* parent, lv_coord_t size);
+void skyViewUpdate(SkyView& view, const SkySummary& summary);
+
+#endif
@@ -71,7 +71,10 @@ SFE_UBLOX_GNSS::~SFE_UBLOX_GNSS(void)
 
   if (payloadCfg != NULL)
   {
-    delete[] payloadCfg; // Created with new[]
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (payloadCfg != staticPayloadCfg) // Static storage is never deleted
+#endif
+      delete[] payloadCfg; // Created with new[]
     payloadCfg = NULL;   // Redundant?
   }
 
@@ -86,11 +89,22 @@ SFE_UBLOX_GNSS::~SFE_UBLOX_GNSS(void)
     delete[] spiBuffer; // Created with new[]
     spiBuffer = NULL;   // Redundant?
   }
+
+  if (rtcmFrameBuffer != NULL)
+  {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (rtcmFrameBuffer != staticRTCMFrameBuffer) // Static storage is never deleted
+#endif
+      delete[] rtcmFrameBuffer; // Created with new[]
+    rtcmFrameBuffer = NULL;
+  }
 }
 
 // Stop all automatic message processing. Free all used RAM
 void SFE_UBLOX_GNSS::end(void)
 {
+  clearCommandQueue();
+
   // Note: payloadCfg is not deleted
 
   // Note: payloadAuto is not deleted
@@ -105,12 +119,27 @@ void SFE_UBLOX_GNSS::end(void)
       _debugSerial->println(F("end: the file buffer has been deleted. You will need to call setFileBufferSize before .begin to create a new one."));
     }
 #endif
-    delete[] ubxFileBuffer; // Created with new[]
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (ubxFileBuffer != staticFileBuffer) // Static storage is never deleted
+#endif
+      delete[] ubxFileBuffer; // Created with new[]
     ubxFileBuffer = NULL;   // Redundant?
     fileBufferSize = 0;     // Reset file buffer size. User will have to call setFileBufferSize again
     fileBufferMaxAvail = 0;
   }
 
+  if (i2cRxBuffer != NULL) // Check if RAM has been allocated for the I2C read buffer
+  {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (i2cRxBuffer != staticI2CRxBuffer) // Static storage is never deleted
+#endif
+      delete[] i2cRxBuffer; // Created with new[]
+    i2cRxBuffer = NULL;
+    i2cBufferSize = 0; // User will have to call setI2CBufferSize again
+    i2cBufferMaxAvail = 0;
+    i2cBytesPending = 0;
+  }
+
   if (moduleSWVersion != NULL)
   {
     delete moduleSWVersion; // Created with new moduleSWVersion_t
@@ -173,6 +202,9 @@ void SFE_UBLOX_GNSS::end(void)
   {
     if (packetUBXNAVPVT->callbackData != NULL)
     {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+      if (packetUBXNAVPVT->callbackData != &staticUBXNAVPVTcallbackData) // Static storage is never deleted
+#endif
       delete packetUBXNAVPVT->callbackData;
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
       if (_printDebug == true)
@@ -181,6 +213,9 @@ void SFE_UBLOX_GNSS::end(void)
       }
 #endif
     }
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (packetUBXNAVPVT != &staticUBXNAVPVT) // Static storage is never deleted
+#endif
     delete packetUBXNAVPVT;
     packetUBXNAVPVT = NULL; // Redundant?
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -235,8 +270,14 @@ void SFE_UBLOX_GNSS::end(void)
   {
     if (packetUBXNAVHPPOSLLH->callbackData != NULL)
     {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+      if (packetUBXNAVHPPOSLLH->callbackData != &staticUBXNAVHPPOSLLHcallbackData) // Static storage is never deleted
+#endif
       delete packetUBXNAVHPPOSLLH->callbackData;
     }
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (packetUBXNAVHPPOSLLH != &staticUBXNAVHPPOSLLH) // Static storage is never deleted
+#endif
     delete packetUBXNAVHPPOSLLH;
     packetUBXNAVHPPOSLLH = NULL; // Redundant?
   }
@@ -275,8 +316,14 @@ void SFE_UBLOX_GNSS::end(void)
   {
     if (packetUBXNAVSVIN->callbackData != NULL)
     {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+      if (packetUBXNAVSVIN->callbackData != &staticUBXNAVSVINcallbackData) // Static storage is never deleted
+#endif
       delete packetUBXNAVSVIN->callbackData;
     }
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (packetUBXNAVSVIN != &staticUBXNAVSVIN) // Static storage is never deleted
+#endif
     delete packetUBXNAVSVIN;
     packetUBXNAVSVIN = NULL; // Redundant?
   }
@@ -375,8 +422,14 @@ void SFE_UBLOX_GNSS::end(void)
   {
     if (packetUBXRXMRAWX->callbackData != NULL)
     {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+      if (packetUBXRXMRAWX->callbackData != &staticUBXRXMRAWXcallbackData) // Static storage is never deleted
+#endif
       delete packetUBXRXMRAWX->callbackData;
     }
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (packetUBXRXMRAWX != &staticUBXRXMRAWX) // Static storage is never deleted
+#endif
     delete packetUBXRXMRAWX;
     packetUBXRXMRAWX = NULL; // Redundant?
   }
@@ -581,7 +634,10 @@ bool SFE_UBLOX_GNSS::setPacketCfgPayloadSize(size_t payloadSize)
   if ((payloadSize == 0) && (payloadCfg != NULL))
   {
     // Zero payloadSize? Dangerous! But we'll free the memory anyway...
-    delete[] payloadCfg; // Created with new[]
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (payloadCfg != staticPayloadCfg) // Static storage is never deleted
+#endif
+      delete[] payloadCfg; // Created with new[]
     payloadCfg = NULL;   // Redundant?
     packetCfg.payload = payloadCfg;
     packetCfgPayloadSize = payloadSize;
@@ -591,7 +647,12 @@ bool SFE_UBLOX_GNSS::setPacketCfgPayloadSize(size_t payloadSize)
 
   else if (payloadCfg == NULL) // Memory has not yet been allocated - so use new
   {
-    payloadCfg = new uint8_t[payloadSize];
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if (payloadSize <= sizeof(staticPayloadCfg))
+      payloadCfg = staticPayloadCfg;
+    else
+#endif
+      payloadCfg = new uint8_t[payloadSize];
     packetCfg.payload = payloadCfg;
     if (payloadCfg == NULL)
     {
@@ -606,7 +667,13 @@ bool SFE_UBLOX_GNSS::setPacketCfgPayloadSize(size_t payloadSize)
 
   else // Memory has already been allocated - so resize
   {
-    uint8_t *newPayload = new uint8_t[payloadSize];
+    uint8_t *newPayload;
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    if ((payloadSize <= sizeof(staticPayloadCfg)) && (payloadCfg == staticPayloadCfg))
+      newPayload = staticPayloadCfg; // Already big enough
+    else
+#endif
+      newPayload = new uint8_t[payloadSize];
 
     if (newPayload == NULL) // Check if the alloc was successful
     {
@@ -616,8 +683,14 @@ bool SFE_UBLOX_GNSS::setPacketCfgPayloadSize(size_t payloadSize)
     }
     else
     {
-      memcpy(newPayload, payloadCfg, payloadSize <= packetCfgPayloadSize ? payloadSize : packetCfgPayloadSize); // Copy as much existing data as we can
-      delete[] payloadCfg;                                                                                      // Free payloadCfg. Created with new[]
+      if (newPayload != payloadCfg)
+      {
+        memcpy(newPayload, payloadCfg, payloadSize <= packetCfgPayloadSize ? payloadSize : packetCfgPayloadSize); // Copy as much existing data as we can
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+        if (payloadCfg != staticPayloadCfg) // Static storage is never deleted
+#endif
+          delete[] payloadCfg;                                                                                      // Free payloadCfg. Created with new[]
+      }
       payloadCfg = newPayload;                                                                                  // Point to the newPayload
       packetCfg.payload = payloadCfg;                                                                           // Update the packet pointer
       packetCfgPayloadSize = payloadSize;                                                                       // Update the packet payload size
@@ -651,6 +724,9 @@ bool SFE_UBLOX_GNSS::begin(TwoWire &wirePort, uint8_t deviceAddress, uint16_t ma
   // New in v2.0: allocate memory for the file buffer - if required. (The user should have called setFileBufferSize already)
   createFileBuffer();
 
+  // Allocate memory for the I2C read buffer - if required. (The user should have called setI2CBufferSize already)
+  createI2CBuffer();
+
   // Call isConnected up to three times - tests on the NEO-M8U show the CFG RATE poll occasionally being ignored
   bool connected = isConnected(maxWait);
 
@@ -857,6 +933,104 @@ void SFE_UBLOX_GNSS::setI2CpollingWait(uint8_t newPollingWait_ms)
   i2cPollingWait = newPollingWait_ms;
 }
 
+// Return the I2C polling wait
+uint8_t SFE_UBLOX_GNSS::getI2CpollingWait(void)
+{
+  return (i2cPollingWait);
+}
+
+// Set the I2C read buffer size. This must be called _before_ .begin
+void SFE_UBLOX_GNSS::setI2CBufferSize(uint16_t bufferSize)
+{
+  i2cBufferSize = bufferSize;
+}
+
+// Return the I2C read buffer size
+uint16_t SFE_UBLOX_GNSS::getI2CBufferSize(void)
+{
+  return (i2cBufferSize);
+}
+
+// Set the most bytes read from the module on each call when buffering
+void SFE_UBLOX_GNSS::setI2CReadBudget(uint16_t readBudget)
+{
+  i2cReadBudget = readBudget;
+}
+
+// Set the most time spent processing buffered bytes on each call
+void SFE_UBLOX_GNSS::setProcessTimeBudget(uint16_t processBudget_us)
+{
+  processTimeBudget_us = processBudget_us;
+}
+
+// Use the module's TX-ready output to decide when to poll, instead of i2cPollingWait
+// The module's TX-ready function must be enabled separately (CFG-TXREADY-*)
+void SFE_UBLOX_GNSS::setI2CTxReadyPin(int8_t pin, bool activeHigh)
+{
+  i2cTxReadyPin = pin;
+  i2cTxReadyActiveHigh = activeHigh;
+  if (pin >= 0)
+    pinMode((uint8_t)pin, INPUT);
+}
+
+// Returns the maximum number of bytes which the I2C read buffer contained
+uint16_t SFE_UBLOX_GNSS::getMaxI2CBufferAvail(void)
+{
+  return (i2cBufferMaxAvail);
+}
+
+// Returns the longest time in microseconds a single check of the port has taken
+uint32_t SFE_UBLOX_GNSS::getMaxCheckStall(void)
+{
+  return (maxCheckStall_us);
+}
+
+// Reset i2cBufferMaxAvail and maxCheckStall_us
+void SFE_UBLOX_GNSS::clearI2CStats(void)
+{
+  i2cBufferMaxAvail = 0;
+  maxCheckStall_us = 0;
+}
+
+// PRIVATE: Create the I2C read buffer. Called by .begin
+bool SFE_UBLOX_GNSS::createI2CBuffer(void)
+{
+  if ((i2cBufferSize == 0) || (i2cRxBuffer != NULL)) // Bail if buffering is not wanted, or the buffer already exists
+    return (false);
+
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  if (i2cBufferSize <= sizeof(staticI2CRxBuffer))
+    i2cRxBuffer = staticI2CRxBuffer;
+  else
+#endif
+    i2cRxBuffer = new uint8_t[i2cBufferSize]; // Allocate RAM for the buffer
+
+  if (i2cRxBuffer == NULL) // Check if the new (alloc) was successful
+  {
+    if ((_printDebug == true) || (_printLimitedDebug == true)) // This is important. Print this if doing limited debugging
+    {
+      _debugSerial->println(F("createI2CBuffer: RAM alloc failed!"));
+    }
+    i2cBufferSize = 0;
+    return (false);
+  }
+
+  i2cBufferHead = 0; // Initialize head and tail
+  i2cBufferTail = 0;
+  i2cBytesPending = 0;
+
+  return (true);
+}
+
+// PRIVATE: Check how much of the I2C read buffer is in use
+uint16_t SFE_UBLOX_GNSS::i2cBufferSpaceUsed(void)
+{
+  if (i2cBufferHead >= i2cBufferTail)
+    return (i2cBufferHead - i2cBufferTail);
+  else
+    return ((uint16_t)(((uint32_t)i2cBufferHead + (uint32_t)i2cBufferSize) - (uint32_t)i2cBufferTail));
+}
+
 // Allow the user to change SPI polling wait
 // (the minimum interval between SPI data requests when no data is available - to avoid pounding the bus)
 void SFE_UBLOX_GNSS::setSPIpollingWait(uint8_t newPollingWait_ms)
@@ -1036,19 +1210,31 @@ void SFE_UBLOX_GNSS::disableUBX7Fcheck(bool disabled)
 // Called regularly to check for available bytes on the user' specified port
 bool SFE_UBLOX_GNSS::checkUblox(uint8_t requestedClass, uint8_t requestedID)
 {
-  return checkUbloxInternal(&packetCfg, requestedClass, requestedID);
+  bool result = checkUbloxInternal(&packetCfg, requestedClass, requestedID);
+  checkCommandQueue(); // Only here, not in the blocking waits, so callbacks are never called from inside another command
+  return result;
 }
 
 // PRIVATE: Called regularly to check for available bytes on the user' specified port
 bool SFE_UBLOX_GNSS::checkUbloxInternal(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
 {
+  unsigned long startTime = micros();
+  bool result = false;
   if (commType == COMM_TYPE_I2C)
-    return (checkUbloxI2C(incomingUBX, requestedClass, requestedID));
+  {
+    if (i2cRxBuffer != NULL)
+      result = checkUbloxI2CBuffered(incomingUBX, requestedClass, requestedID);
+    else
+      result = checkUbloxI2C(incomingUBX, requestedClass, requestedID);
+  }
   else if (commType == COMM_TYPE_SERIAL)
-    return (checkUbloxSerial(incomingUBX, requestedClass, requestedID));
+    result = checkUbloxSerial(incomingUBX, requestedClass, requestedID);
   else if (commType == COMM_TYPE_SPI)
-    return (checkUbloxSpi(incomingUBX, requestedClass, requestedID));
-  return false;
+    result = checkUbloxSpi(incomingUBX, requestedClass, requestedID);
+  uint32_t stall = micros() - startTime;
+  if (stall > maxCheckStall_us)
+    maxCheckStall_us = stall;
+  return (result);
 }
 
 // Polls I2C for data, passing any new bytes to process()
@@ -1254,51 +1440,177 @@ bool SFE_UBLOX_GNSS::checkUbloxI2C(ubxPacket *incomingUBX, uint8_t requestedClas
 
 } // end checkUbloxI2C()
 
-// Checks Serial for data, passing any new bytes to process()
+// Budgeted I2C reads into the I2C buffer, passing buffered bytes to process() under a time budget
+// The number of bytes waiting in the module is remembered between calls, so 0xFD/0xFE are only read again once
+// those bytes have been collected. Because the module's address pointer stays at 0xFF, the remaining bytes can be
+// read later with plain requestFroms.
+// Returns true if the module responded (or was not due to be polled)
+bool SFE_UBLOX_GNSS::checkUbloxI2CBuffered(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
+{
+  if (i2cBytesPending == 0)
+  {
+    bool pollDue;
+    if (i2cTxReadyPin >= 0)
+      pollDue = (digitalRead(i2cTxReadyPin) == (i2cTxReadyActiveHigh ? HIGH : LOW)); // The module tells us when it has data
+    else
+      pollDue = (millis() - lastCheck >= i2cPollingWait);
+
+    if (pollDue)
+    {
+      if (readI2CBytesAvailable() == false)
+        return (false); // Sensor did not ACK
+      if (i2cBytesPending == 0)
+        lastCheck = millis(); // Put off checking to avoid I2C bus traffic
+    }
+  }
+
+  // Limit the read to the budget and the free space in the buffer
+  uint16_t bytesToRead = i2cBytesPending;
+  if ((i2cReadBudget > 0) && (bytesToRead > i2cReadBudget))
+    bytesToRead = i2cReadBudget;
+  uint16_t spaceAvailable = i2cBufferSize - i2cBufferSpaceUsed() - 1; // Keep one byte free so full and empty can be told apart
+  if (bytesToRead > spaceAvailable)
+    bytesToRead = spaceAvailable;
+
+  while (bytesToRead)
+  {
+    uint16_t chunk = bytesToRead;
+    if (chunk > i2cTransactionSize)
+      chunk = i2cTransactionSize;
+
+    uint8_t bytesReturned = _i2cPort->requestFrom((uint8_t)_gpsI2Caddress, (uint8_t)chunk);
+    if ((uint16_t)bytesReturned != chunk)
+    {
+      i2cBytesPending = 0; // Start again from 0xFD/0xFE
+      return (false);      // Sensor did not respond
+    }
+    busBytes += chunk + 1; // Address byte and data
+    busTransactions++;
+
+    for (uint16_t x = 0; x < chunk; x++)
+    {
+      i2cRxBuffer[i2cBufferHead++] = _i2cPort->read();
+      if (i2cBufferHead == i2cBufferSize)
+        i2cBufferHead = 0;
+    }
+
+    bytesToRead -= chunk;
+    i2cBytesPending -= chunk;
+  }
+
+  uint16_t bytesUsed = i2cBufferSpaceUsed();
+  if (bytesUsed > i2cBufferMaxAvail)
+    i2cBufferMaxAvail = bytesUsed;
+
+  // Process what we have until the buffer is empty or the time budget runs out.
+  // The buffer is processed a contiguous span at a time, small enough that the budget is still checked often.
+  // The budget starts here: the read above is bounded by i2cReadBudget, and would otherwise use the budget up itself
+  unsigned long startTime = micros();
+  while (i2cBufferTail != i2cBufferHead)
+  {
+    uint16_t span = (i2cBufferHead > i2cBufferTail) ? (i2cBufferHead - i2cBufferTail) : (i2cBufferSize - i2cBufferTail);
+    if (span > 64)
+      span = 64;
+
+    processSpan(&i2cRxBuffer[i2cBufferTail], span, incomingUBX, requestedClass, requestedID);
+    i2cBufferTail += span;
+    if (i2cBufferTail == i2cBufferSize)
+      i2cBufferTail = 0;
+
+    if ((processTimeBudget_us > 0) && (micros() - startTime >= processTimeBudget_us))
+      break;
+  }
+
+  return (true);
+
+} // end checkUbloxI2CBuffered()
+
+// PRIVATE: Read the number of bytes available from registers 0xFD and 0xFE into i2cBytesPending
+bool SFE_UBLOX_GNSS::readI2CBytesAvailable(void)
+{
+  _i2cPort->beginTransmission(_gpsI2Caddress);
+  _i2cPort->write(0xFD);                               // 0xFD (MSB) and 0xFE (LSB) are the registers that contain number of bytes available
+  uint8_t i2cError = _i2cPort->endTransmission(false); // Always send a restart command. Do not release the bus.
+  if (i2cError != 0)
+    return (false); // Sensor did not ACK
+
+  if (_i2cPort->requestFrom((uint8_t)_gpsI2Caddress, static_cast<uint8_t>(2)) != 2)
+    return (false); // Sensor did not return 2 bytes
+  busBytes += 2 + 3; // Address and register, then address and two bytes
+  busTransactions += 2;
+
+  uint8_t msb = _i2cPort->read();
+  uint8_t lsb = _i2cPort->read();
+  i2cBytesPending = ((uint16_t)msb << 8 | lsb) & ~((uint16_t)1 << 15); // Clear the undocumented error bit - see checkUbloxI2C
+
+  return (true);
+}
+
+// Checks Serial for data, passing it to process() a block at a time under the time budget
+// The port's own receive buffer holds whatever is left for the next call
 bool SFE_UBLOX_GNSS::checkUbloxSerial(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
 {
-  while (_serialPort->available())
+  unsigned long startTime = micros();
+  uint8_t block[64];
+
+  int bytesAvailable;
+  while ((bytesAvailable = _serialPort->available()) > 0)
   {
-    process(_serialPort->read(), incomingUBX, requestedClass, requestedID);
+    uint16_t chunk = (bytesAvailable > (int)sizeof(block)) ? sizeof(block) : bytesAvailable;
+    for (uint16_t x = 0; x < chunk; x++)
+      block[x] = _serialPort->read();
+    busBytes += chunk;
+    busTransactions++;
+
+    processSpan(block, chunk, incomingUBX, requestedClass, requestedID);
+
+    if ((processTimeBudget_us > 0) && (micros() - startTime >= processTimeBudget_us))
+      break;
   }
   return (true);
 
 } // end checkUbloxSerial()
 
-// Checks SPI for data, passing any new bytes to process()
+// Checks SPI for data, a whole transaction of spiTransactionSize bytes at a time, passing it to process()
+// The module clocks out 0xFF when it has nothing to send. 0xFF can be data inside a sentence, so the module is only
+// taken to be empty when a transaction ends in 0xFF outside one. Reading then stops until spiPollingWait has passed,
+// without blocking the caller as the byte at a time version did
 bool SFE_UBLOX_GNSS::checkUbloxSpi(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
 {
+  unsigned long startTime = micros();
+
   // Process the contents of the SPI buffer if not empty!
-  for (uint8_t i = 0; i < spiBufferIndex; i++)
+  // These are bytes received while sending
+  if (spiBufferIndex > 0)
   {
-    process(spiBuffer[i], incomingUBX, requestedClass, requestedID);
+    processSpan(spiBuffer, spiBufferIndex, incomingUBX, requestedClass, requestedID);
+    spiBufferIndex = 0;
   }
-  spiBufferIndex = 0;
 
-  _spiPort->beginTransaction(SPISettings(_spiSpeed, MSBFIRST, SPI_MODE0));
-  digitalWrite(_csPin, LOW);
-  uint8_t byteReturned = _spiPort->transfer(0xFF);
-
-  // Note to future self: I think the 0xFF check might cause problems when attempting to process (e.g.) RAWX data
-  // which could legitimately contain 0xFF within the data stream. But the currentSentence check will certainly help!
+  if ((currentSentence == SFE_UBLOX_SENTENCE_TYPE_NONE) && (millis() - lastCheck < spiPollingWait))
+    return (true);
 
-  // If we are not receiving a sentence (currentSentence == NONE) and the byteReturned is 0xFF,
-  // i.e. the module has no data for us, then delay for
-  if ((byteReturned == 0xFF) && (currentSentence == SFE_UBLOX_SENTENCE_TYPE_NONE))
+  while (true)
   {
+    memset(spiBuffer, 0xFF, spiTransactionSize);
+    _spiPort->beginTransaction(SPISettings(_spiSpeed, MSBFIRST, SPI_MODE0));
+    digitalWrite(_csPin, LOW);
+    _spiPort->transfer(spiBuffer, spiTransactionSize);
     digitalWrite(_csPin, HIGH);
     _spiPort->endTransaction();
-    delay(spiPollingWait);
-    return (true);
-  }
+    busBytes += spiTransactionSize;
+    busTransactions++;
 
-  while ((byteReturned != 0xFF) || (currentSentence != SFE_UBLOX_SENTENCE_TYPE_NONE))
-  {
-    process(byteReturned, incomingUBX, requestedClass, requestedID);
-    byteReturned = _spiPort->transfer(0xFF);
+    processSpan(spiBuffer, spiTransactionSize, incomingUBX, requestedClass, requestedID);
+
+    if ((spiBuffer[spiTransactionSize - 1] == 0xFF) && (currentSentence == SFE_UBLOX_SENTENCE_TYPE_NONE))
+    {
+      lastCheck = millis(); // The module is empty
+      break;
+    }
+    if ((processTimeBudget_us > 0) && (micros() - startTime >= processTimeBudget_us))
+      break;
   }
-  digitalWrite(_csPin, HIGH);
-  _spiPort->endTransaction();
   return (true);
 
 } // end checkUbloxSpi()
@@ -1374,7 +1686,7 @@ bool SFE_UBLOX_GNSS::checkAutomatic(uint8_t Class, uint8_t ID)
         result = true;
       break;
     case UBX_NAV_SAT:
-      if (packetUBXNAVSAT != NULL)
+      if ((packetUBXNAVSAT != NULL) || (navSatBlockCallbackPointerPtr != NULL))
         result = true;
       break;
     case UBX_NAV_RELPOSNED:
@@ -1680,6 +1992,147 @@ uint16_t SFE_UBLOX_GNSS::getMaxPayloadSize(uint8_t Class, uint8_t ID)
   return (maxSize);
 }
 
+// Process a buffer of bytes. Gives the same result as calling process for each byte, but takes the long runs a
+// span at a time. The scanner for the current sentence type is picked from spanScanners, a jump table indexed by
+// currentSentence. Each scanner takes as many bytes as it can in bulk and leaves the byte which changes the state
+// (a sync byte, an NMEA '*', the last byte of a frame) to process:
+// * Between sentences, the next sync byte is found with memchr
+// * Inside an NMEA sentence which is not stored, logged or passed to processNMEA, the body is skipped up to the '*'
+// * Inside a UBX payload, the payload is added to the rolling checksum with fletcher8 and copied into the active
+//   packet with memcpy. processUBX's per byte storage decisions are made once per span
+// * Inside an RTCM frame collected for the frame callback, the body is copied into the frame buffer in one go.
+//   The CRC-24Q is calculated over the whole frame when the last byte arrives, as before
+// Echoing to _outputPort needs every byte, so only process is used while it is set
+const SFE_UBLOX_GNSS::spanScanner_t SFE_UBLOX_GNSS::spanScanners[] = {
+    &SFE_UBLOX_GNSS::scanIdleSpan,  // SFE_UBLOX_SENTENCE_TYPE_NONE
+    &SFE_UBLOX_GNSS::scanNMEASpan,  // SFE_UBLOX_SENTENCE_TYPE_NMEA
+    &SFE_UBLOX_GNSS::scanUBXSpan,   // SFE_UBLOX_SENTENCE_TYPE_UBX
+    &SFE_UBLOX_GNSS::scanRTCMSpan}; // SFE_UBLOX_SENTENCE_TYPE_RTCM
+
+uint16_t SFE_UBLOX_GNSS::processSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
+{
+  uint16_t x = 0;
+  while (x < length)
+  {
+    if (_outputPort == NULL)
+    {
+      x += (this->*spanScanners[currentSentence])(&data[x], length - x, incomingUBX);
+      if (x == length)
+        break;
+    }
+    process(data[x++], incomingUBX, requestedClass, requestedID);
+  }
+  return (length);
+}
+
+// The bytes which start a sentence. An NMEA sentence also ends its body with '*'
+static const uint8_t spanStopBytes[] = {UBX_SYNCH_1, '$', 0xD3, '*'};
+
+// Returns the first of the count stop bytes between data and end, or end if there is none.
+// Each memchr only searches up to the closest stop byte found so far
+static const uint8_t *findStopByte(const uint8_t *data, const uint8_t *end, uint8_t count)
+{
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const uint8_t *stop = (const uint8_t *)memchr(data, spanStopBytes[i], end - data);
+    if (stop != NULL)
+      end = stop;
+  }
+  return (end);
+}
+
+// Between sentences: skip to the next sync byte
+uint16_t SFE_UBLOX_GNSS::scanIdleSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX)
+{
+  (void)incomingUBX;
+  return (findStopByte(data, data + length, 3) - data);
+}
+
+// After the address field of an NMEA sentence which nothing wants, skip the body up to the '*' or a sync byte.
+// Stop short of the byte which would take nmeaByteCounter to maxNMEAByteCount, so process can abandon the sentence
+uint16_t SFE_UBLOX_GNSS::scanNMEASpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX)
+{
+  (void)incomingUBX;
+  if (nmeaByteCounter <= 5) // The address field, or the checksum after the '*'
+    return (0);
+#ifndef SFE_UBLOX_DISABLE_AUTO_NMEA
+  if (isThisNMEAauto())
+    return (0);
+#endif
+  if (logThisNMEA() || processThisNMEA())
+    return (0);
+
+  int16_t room = maxNMEAByteCount - 1 - nmeaByteCounter;
+  if (room <= 0)
+    return (0);
+  if (length > room)
+    length = room;
+  uint16_t skipped = findStopByte(data, data + length, 4) - data;
+  nmeaByteCounter += skipped;
+  return (skipped);
+}
+
+// Inside a UBX payload: checksum and store the rest of the payload in this span. The header and the first two payload
+// bytes, where ACKs are matched, go through process, as do streamed NAV SAT blocks and any span which would reach the
+// edge of the stored part of the payload, so process can apply startingSpot and the overrun checks
+uint16_t SFE_UBLOX_GNSS::scanUBXSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX)
+{
+  // packetBuf.len holds the length whichever buffer is active
+  if ((ubxFrameCounter < 8) || (ubxFrameCounter >= packetBuf.len + 6) || navSatStreaming)
+    return (0);
+
+  ubxPacket *packet;
+  uint16_t maximumPayloadSize = 2; // As processUBX
+  if (activePacketBuffer == SFE_UBLOX_PACKET_PACKETACK)
+    packet = &packetAck;
+  else if (activePacketBuffer == SFE_UBLOX_PACKET_PACKETCFG)
+  {
+    packet = incomingUBX;
+    maximumPayloadSize = packetCfgPayloadSize;
+  }
+  else if (activePacketBuffer == SFE_UBLOX_PACKET_PACKETBUF)
+    packet = &packetBuf;
+  else
+  {
+    packet = &packetAuto;
+    maximumPayloadSize = getMaxPayloadSize(packetAuto.cls, packetAuto.id);
+  }
+
+  uint16_t chunk = packetBuf.len + 6 - ubxFrameCounter;
+  if (chunk > length)
+    chunk = length;
+
+  if (ignoreThisPayload == false)
+  {
+    uint16_t startingSpot = checkAutomatic(packet->cls, packet->id) ? 0 : packet->startingSpot;
+    uint16_t offset = packet->counter - 4; // Payload offset of data[0]
+    if ((offset < startingSpot) || (offset - startingSpot + chunk > maximumPayloadSize) || (packet->counter + chunk > maximumPayloadSize + 6))
+      return (0);
+    memcpy(&packet->payload[offset - startingSpot], data, chunk);
+  }
+
+  fletcher8(data, chunk, rollingChecksumA, rollingChecksumB);
+  packet->counter += chunk;
+  ubxFrameCounter += chunk;
+  return (chunk);
+}
+
+// Inside an RTCM frame collected for the frame callback: copy all but the final byte of the frame.
+// The final byte goes through process to check and deliver the frame
+uint16_t SFE_UBLOX_GNSS::scanRTCMSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX)
+{
+  (void)incomingUBX;
+  if ((rtcmFrameCallbackPointerPtr == NULL) || (rtcmFrameCounter < 3))
+    return (0);
+
+  uint16_t chunk = rtcmLen - 1 - rtcmFrameCounter;
+  if (chunk > length)
+    chunk = length;
+  memcpy(&rtcmFrameBuffer[rtcmFrameCounter], data, chunk);
+  rtcmFrameCounter += chunk;
+  return (chunk);
+}
+
 // Processes NMEA and UBX binary sentences one byte at a time
 // Take a given byte and file it into the proper array
 void SFE_UBLOX_GNSS::process(uint8_t incoming, ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID)
@@ -1733,6 +2186,7 @@ void SFE_UBLOX_GNSS::process(uint8_t incoming, ubxPacket *incomingUBX, uint8_t r
       packetBuf.cls = incoming; // (Duplication)
       rollingChecksumA = 0;     // Reset our rolling checksums here (not when we receive the 0xB5)
       rollingChecksumB = 0;
+      navSatStreaming = false;
       packetBuf.counter = 0;                                   // Reset the packetBuf.counter (again)
       packetBuf.valid = SFE_UBLOX_PACKET_VALIDITY_NOT_DEFINED; // Reset the packet validity (redundant?)
       packetBuf.startingSpot = incomingUBX->startingSpot;      // Copy the startingSpot
@@ -1755,6 +2209,12 @@ void SFE_UBLOX_GNSS::process(uint8_t incoming, ubxPacket *incomingUBX, uint8_t r
           incomingUBX->id = packetBuf.id;
           incomingUBX->counter = packetBuf.counter; // Copy over the .counter too
         }
+        // NAV SAT with only the block callback: decode it a block at a time as it arrives, with nothing stored
+        else if ((packetBuf.cls == UBX_CLASS_NAV) && (packetBuf.id == UBX_NAV_SAT) && (navSatBlockCallbackPointerPtr != NULL) && (packetUBXNAVSAT == NULL))
+        {
+          navSatStreaming = true;
+          ignoreThisPayload = true; // Keep diverting data into packetBuf, but do not store it
+        }
         // This is not an ACK and we do not have a complete class and ID match
         // So let's check if this is an "automatic" message which has its own storage defined
         else if (checkAutomatic(packetBuf.cls, packetBuf.id))
@@ -2878,32 +3338,106 @@ nmeaAutomaticFlags *SFE_UBLOX_GNSS::getNMEAFlagsPtr()
 // Example: D3 00 7C 43 F0 ... / 0x7C = 124+6 = 130 bytes in this packet, 0x43F = Msg type 1087
 SFE_UBLOX_GNSS::sfe_ublox_sentence_types_e SFE_UBLOX_GNSS::processRTCMframe(uint8_t incoming, uint16_t *rtcmFrameCounter)
 {
-  static uint16_t rtcmLen = 0;
-
   if (*rtcmFrameCounter == 1)
   {
+    if ((incoming & 0xFC) != 0) // The six reserved bits must be zero. The 0xD3 was not a preamble, or the header was corrupted
+    {
+      rtcmStats.framesTruncated++;
+      return (SFE_UBLOX_SENTENCE_TYPE_NONE);
+    }
     rtcmLen = (incoming & 0x03) << 8; // Get the last two bits of this byte. Bits 8&9 of 10-bit length
   }
   else if (*rtcmFrameCounter == 2)
   {
     rtcmLen |= incoming; // Bits 0-7 of packet length
-    rtcmLen += 6;        // There are 6 additional bytes of what we presume is header, msgType, CRC, and stuff
+    rtcmLen += 6;        // There are 6 additional bytes: preamble, reserved/length (2) and CRC (3)
   }
-  /*else if (rtcmFrameCounter == 3)
+
+  if (rtcmFrameCallbackPointerPtr == NULL)
   {
-    rtcmMsgType = incoming << 4; //Message Type, MS 4 bits
+    *rtcmFrameCounter = *rtcmFrameCounter + 1;
+
+    processRTCM(incoming); // Here is where we expose this byte to the user
+
+    // Reset and start looking for next sentence type when done
+    return (*rtcmFrameCounter == rtcmLen) ? SFE_UBLOX_SENTENCE_TYPE_NONE : SFE_UBLOX_SENTENCE_TYPE_RTCM;
   }
-  else if (rtcmFrameCounter == 4)
-  {
-    rtcmMsgType |= (incoming >> 4); //Message Type, bits 0-7
-  }*/
 
+  // Collect the whole frame, then check it and hand it over in one go
+  rtcmFrameBuffer[*rtcmFrameCounter] = incoming;
   *rtcmFrameCounter = *rtcmFrameCounter + 1;
 
-  processRTCM(incoming); // Here is where we expose this byte to the user
+  if (*rtcmFrameCounter < rtcmLen || *rtcmFrameCounter < 3)
+    return (SFE_UBLOX_SENTENCE_TYPE_RTCM);
 
-  // Reset and start looking for next sentence type when done
-  return (*rtcmFrameCounter == rtcmLen) ? SFE_UBLOX_SENTENCE_TYPE_NONE : SFE_UBLOX_SENTENCE_TYPE_RTCM;
+  uint32_t crc = ((uint32_t)rtcmFrameBuffer[rtcmLen - 3] << 16) | ((uint32_t)rtcmFrameBuffer[rtcmLen - 2] << 8) | rtcmFrameBuffer[rtcmLen - 1];
+  if (crc24q(rtcmFrameBuffer, rtcmLen - 3) != crc)
+  {
+    rtcmStats.framesBadCRC++;
+    return (SFE_UBLOX_SENTENCE_TYPE_NONE);
+  }
+  rtcmStats.framesGood++;
+
+  uint16_t messageNumber = 0;
+  uint32_t epoch = 0;
+  if (rtcmLen >= 6 + 2)
+    messageNumber = ((uint16_t)rtcmFrameBuffer[3] << 4) | (rtcmFrameBuffer[4] >> 4);
+  if (messageMeterCallbackPointerPtr != NULL)
+    messageMeterCallbackPointerPtr(0xF5, (uint8_t)(messageNumber - 1000), rtcmLen);
+
+  // MSM1-7 messages (1071-1137): message number (12 bits), station ID (12 bits), then the 30-bit epoch time
+  if ((messageNumber >= 1071) && (messageNumber <= 1137) && (messageNumber % 10 >= 1) && (messageNumber % 10 <= 7) && (rtcmLen >= 6 + 7))
+  {
+    epoch = (((uint32_t)rtcmFrameBuffer[6] << 24) | ((uint32_t)rtcmFrameBuffer[7] << 16) | ((uint32_t)rtcmFrameBuffer[8] << 8) | rtcmFrameBuffer[9]) >> 2;
+    epoch &= 0x3FFFFFFF;
+  }
+
+  rtcmFrameCallbackPointerPtr(rtcmFrameBuffer, rtcmLen, messageNumber, epoch);
+
+  return (SFE_UBLOX_SENTENCE_TYPE_NONE);
+}
+
+// Set the RTCM frame callback. Pass NULL to go back to calling processRTCM for each byte
+void SFE_UBLOX_GNSS::setRTCMFrameCallbackPtr(void (*callbackPointerPtr)(const uint8_t *frame, uint16_t length, uint16_t messageNumber, uint32_t epoch))
+{
+  if ((callbackPointerPtr != NULL) && (rtcmFrameBuffer == NULL))
+  {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    rtcmFrameBuffer = staticRTCMFrameBuffer;
+#else
+    rtcmFrameBuffer = new uint8_t[SFE_UBLOX_RTCM_MAX_FRAME_SIZE];
+#endif
+    if (rtcmFrameBuffer == NULL)
+    {
+      if ((_printDebug == true) || (_printLimitedDebug == true)) // This is important. Print this if doing limited debugging
+      {
+        _debugSerial->println(F("setRTCMFrameCallbackPtr: RAM alloc failed!"));
+      }
+      return;
+    }
+  }
+  currentSentence = SFE_UBLOX_SENTENCE_TYPE_NONE; // Do not switch over part way through a frame
+  rtcmFrameCallbackPointerPtr = callbackPointerPtr;
+}
+
+// Set the message meter. Pass NULL to stop metering
+void SFE_UBLOX_GNSS::setMessageMeterCallbackPtr(void (*callbackPointerPtr)(uint8_t cls, uint8_t id, uint16_t length))
+{
+  messageMeterCallbackPointerPtr = callbackPointerPtr;
+}
+
+// Reset the RTCM frame counters
+void SFE_UBLOX_GNSS::clearRTCMFrameStats(void)
+{
+  rtcmStats.framesGood = 0;
+  rtcmStats.framesBadCRC = 0;
+  rtcmStats.framesTruncated = 0;
+}
+
+// Calculate the RTCM CRC-24Q of data
+uint32_t SFE_UBLOX_GNSS::crc24q(const uint8_t *data, uint16_t length)
+{
+  return (::crc24q(data, length));
 }
 
 // This function is called for each byte of an RTCM frame
@@ -3002,6 +3536,24 @@ void SFE_UBLOX_GNSS::processUBX(uint8_t incoming, ubxPacket *incomingUBX, uint8_
       incomingUBX->valid = SFE_UBLOX_PACKET_VALIDITY_VALID; // Flag the packet as valid
       _signsOfLife = true;                                  // The checksum is valid, so set the _signsOfLife flag
 
+      if (messageMeterCallbackPointerPtr != NULL)
+        messageMeterCallbackPointerPtr(incomingUBX->cls, incomingUBX->id, incomingUBX->len + 8); // Sync, class, ID, length and checksum
+
+      // Resolve the queued command waiting for its ACK. Only the queue head is ever in flight, and blocking commands
+      // are not sent while the queue holds anything, so an ACK for the head's class and ID is the head's own.
+      // It is not offered to a blocking request as well
+      bool queuedAck = false;
+      if ((incomingUBX->cls == UBX_CLASS_ACK) && (commandQueueCount > 0))
+      {
+        ubxQueuedCommand_t *command = &commandQueue[commandQueueHead];
+        if ((command->sent) && (!command->done) && (incomingUBX->payload[0] == command->cls) && (incomingUBX->payload[1] == command->id))
+        {
+          command->status = (incomingUBX->id == UBX_ACK_ACK) ? SFE_UBLOX_STATUS_DATA_SENT : SFE_UBLOX_STATUS_COMMAND_NACK;
+          command->done = true;
+          queuedAck = true;
+        }
+      }
+
       // Let's check if the class and ID match the requestedClass and requestedID
       // Remember - this could be a data packet or an ACK packet
       if ((incomingUBX->cls == requestedClass) && (incomingUBX->id == requestedID))
@@ -3010,13 +3562,13 @@ void SFE_UBLOX_GNSS::processUBX(uint8_t incoming, ubxPacket *incomingUBX, uint8_
       }
 
       // If this is an ACK then let's check if the class and ID match the requestedClass and requestedID
-      else if ((incomingUBX->cls == UBX_CLASS_ACK) && (incomingUBX->id == UBX_ACK_ACK) && (incomingUBX->payload[0] == requestedClass) && (incomingUBX->payload[1] == requestedID))
+      else if ((incomingUBX->cls == UBX_CLASS_ACK) && (incomingUBX->id == UBX_ACK_ACK) && (!queuedAck) && (incomingUBX->payload[0] == requestedClass) && (incomingUBX->payload[1] == requestedID))
       {
         incomingUBX->classAndIDmatch = SFE_UBLOX_PACKET_VALIDITY_VALID; // If we have a match, set the classAndIDmatch flag to valid
       }
 
       // If this is a NACK then let's check if the class and ID match the requestedClass and requestedID
-      else if ((incomingUBX->cls == UBX_CLASS_ACK) && (incomingUBX->id == UBX_ACK_NACK) && (incomingUBX->payload[0] == requestedClass) && (incomingUBX->payload[1] == requestedID))
+      else if ((incomingUBX->cls == UBX_CLASS_ACK) && (incomingUBX->id == UBX_ACK_NACK) && (!queuedAck) && (incomingUBX->payload[0] == requestedClass) && (incomingUBX->payload[1] == requestedID))
       {
         incomingUBX->classAndIDmatch = SFE_UBLOX_PACKET_NOTACKNOWLEDGED; // If we have a match, set the classAndIDmatch flag to NOTACKNOWLEDGED
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -3079,11 +3631,19 @@ void SFE_UBLOX_GNSS::processUBX(uint8_t incoming, ubxPacket *incomingUBX, uint8_
       {
         processUBXpacket(incomingUBX);
       }
+
+      // The streamed NAV SAT blocks have all been delivered and can now be trusted
+      if (navSatStreaming)
+        navSatBlockCallbackPointerPtr(&navSatStreamHeader, NULL);
     }
     else // Checksum failure
     {
       incomingUBX->valid = SFE_UBLOX_PACKET_VALIDITY_NOT_VALID;
 
+      // Tell the NAV SAT block callback to discard the blocks it has already been given
+      if (navSatStreaming)
+        navSatBlockCallbackPointerPtr(NULL, NULL);
+
       // Let's check if the class and ID match the requestedClass and requestedID.
       // This is potentially risky as we are saying that we saw the requested Class and ID
       // but that the packet checksum failed. Potentially it could be the class or ID bytes
@@ -3135,6 +3695,9 @@ void SFE_UBLOX_GNSS::processUBX(uint8_t incoming, ubxPacket *incomingUBX, uint8_
   }
   else // Load this byte into the payload array
   {
+    if (navSatStreaming)
+      streamNAVSAT(incomingUBX->counter - 4, incoming);
+
     // If an automatic packet comes in asynchronously, we need to fudge the startingSpot
     uint16_t startingSpot = incomingUBX->startingSpot;
     if (checkAutomatic(incomingUBX->cls, incomingUBX->id))
@@ -3753,6 +4316,30 @@ void SFE_UBLOX_GNSS::processUBXpacket(ubxPacket *msg)
           storePacket(msg);
         }
       }
+
+      // Pass each block straight to the streaming callback
+      if (navSatBlockCallbackPointerPtr != NULL)
+      {
+        UBX_NAV_SAT_header_t header;
+        header.iTOW = extractLong(msg, 0);
+        header.version = extractByte(msg, 4);
+        header.numSvs = extractByte(msg, 5);
+
+        UBX_NAV_SAT_block_t block;
+        for (uint16_t i = 0; (i < ((uint16_t)header.numSvs)) && (((i * 12) + 20) <= msg->len); i++)
+        {
+          uint16_t offset = (i * 12) + 8;
+          block.gnssId = extractByte(msg, offset + 0);
+          block.svId = extractByte(msg, offset + 1);
+          block.cno = extractByte(msg, offset + 2);
+          block.elev = extractSignedChar(msg, offset + 3);
+          block.azim = extractSignedInt(msg, offset + 4);
+          block.prRes = extractSignedInt(msg, offset + 6);
+          block.flags.all = extractLong(msg, offset + 8);
+          navSatBlockCallbackPointerPtr(&header, &block);
+        }
+        navSatBlockCallbackPointerPtr(&header, NULL); // End of the message
+      }
     }
     else if (msg->id == UBX_NAV_RELPOSNED && ((msg->len == UBX_NAV_RELPOSNED_LEN) || (msg->len == UBX_NAV_RELPOSNED_LEN_F9)))
     {
@@ -4521,23 +5108,9 @@ void SFE_UBLOX_GNSS::calcChecksum(ubxPacket *msg)
   msg->checksumA = 0;
   msg->checksumB = 0;
 
-  msg->checksumA += msg->cls;
-  msg->checksumB += msg->checksumA;
-
-  msg->checksumA += msg->id;
-  msg->checksumB += msg->checksumA;
-
-  msg->checksumA += (msg->len & 0xFF);
-  msg->checksumB += msg->checksumA;
-
-  msg->checksumA += (msg->len >> 8);
-  msg->checksumB += msg->checksumA;
-
-  for (uint16_t i = 0; i < msg->len; i++)
-  {
-    msg->checksumA += msg->payload[i];
-    msg->checksumB += msg->checksumA;
-  }
+  uint8_t header[4] = {msg->cls, msg->id, (uint8_t)(msg->len & 0xFF), (uint8_t)(msg->len >> 8)};
+  fletcher8(header, 4, msg->checksumA, msg->checksumB);
+  fletcher8(msg->payload, msg->len, msg->checksumA, msg->checksumB);
 }
 
 // Given a message and a byte, add to rolling "8-Bit Fletcher" checksum
@@ -4553,6 +5126,28 @@ sfe_ublox_status_e SFE_UBLOX_GNSS::sendCommand(ubxPacket *outgoingUBX, uint16_t
 {
   sfe_ublox_status_e retVal = SFE_UBLOX_STATUS_SUCCESS;
 
+  // Queued commands are matched to their ACKs by class and ID alone, so a blocking command must not be in flight
+  // alongside them. Give the queue up to maxWait to empty, then refuse
+  if ((maxWait > 0) && (commandQueueCount > 0))
+  {
+    unsigned long startTime = millis();
+    while ((commandQueueCount > 0) && (millis() - startTime < maxWait))
+    {
+      checkUblox();
+      delay(1);
+    }
+    if (commandQueueCount > 0)
+    {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+      if (_printDebug == true)
+      {
+        _debugSerial->println(F("sendCommand: command queue busy"));
+      }
+#endif
+      return (SFE_UBLOX_STATUS_INVALID_OPERATION);
+    }
+  }
+
   calcChecksum(outgoingUBX); // Sets checksum A and B bytes of the packet
 
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -4579,38 +5174,153 @@ sfe_ublox_status_e SFE_UBLOX_GNSS::sendCommand(ubxPacket *outgoingUBX, uint16_t
   }
   else if (commType == COMM_TYPE_SERIAL)
   {
-    sendSerialCommand(outgoingUBX);
+    sendSerialCommand(outgoingUBX);
+  }
+  else if (commType == COMM_TYPE_SPI)
+  {
+    sendSpiCommand(outgoingUBX);
+  }
+
+  if (maxWait > 0)
+  {
+    // Depending on what we just sent, either we need to look for an ACK or not
+    if ((outgoingUBX->cls == UBX_CLASS_CFG) || (expectACKonly == true))
+    {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+      if (_printDebug == true)
+      {
+        _debugSerial->println(F("sendCommand: Waiting for ACK response"));
+      }
+#endif
+      retVal = waitForACKResponse(outgoingUBX, outgoingUBX->cls, outgoingUBX->id, maxWait); // Wait for Ack response
+    }
+    else
+    {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+      if (_printDebug == true)
+      {
+        _debugSerial->println(F("sendCommand: Waiting for No ACK response"));
+      }
+#endif
+      retVal = waitForNoACKResponse(outgoingUBX, outgoingUBX->cls, outgoingUBX->id, maxWait); // Wait for Ack response
+    }
+  }
+  return retVal;
+}
+
+// Copy a command into the queue. It is sent from checkUblox once the commands ahead of it have completed
+bool SFE_UBLOX_GNSS::sendCommandAsync(ubxPacket *outgoingUBX, sfe_ublox_command_callback_t callback, uint16_t maxWait)
+{
+  if ((commandQueueCount >= SFE_UBLOX_COMMAND_QUEUE_SIZE) || (outgoingUBX->len > SFE_UBLOX_COMMAND_PAYLOAD_SIZE))
+    return (false);
+
+  // Each queue entry has its own slot in the payload pool
+  uint8_t slot = (commandQueueHead + commandQueueCount) % SFE_UBLOX_COMMAND_QUEUE_SIZE;
+  if (outgoingUBX->len > 0)
+    memcpy(commandPayloadPool[slot], outgoingUBX->payload, outgoingUBX->len);
+
+  ubxQueuedCommand_t *command = &commandQueue[slot];
+  command->cls = outgoingUBX->cls;
+  command->id = outgoingUBX->id;
+  command->len = outgoingUBX->len;
+  command->payload = commandPayloadPool[slot];
+  command->maxWait = maxWait;
+  command->sent = false;
+  command->done = false;
+  command->status = SFE_UBLOX_STATUS_SUCCESS;
+  command->sequence = ++commandSequence;
+  command->callback = callback;
+  commandQueueCount++;
+
+  checkCommandQueue(); // Send it now if the queue was empty
+  return (true);
+}
+
+// Send the command at the head of the queue, or complete it once it has been ACKed, NACKed or has timed out
+void SFE_UBLOX_GNSS::checkCommandQueue(void)
+{
+  if (commandQueueCount == 0)
+    return;
+
+  ubxQueuedCommand_t *command = &commandQueue[commandQueueHead];
+
+  if (!command->sent)
+  {
+    ubxPacket packet = {command->cls, command->id, command->len, 0, 0, command->payload, 0, 0, SFE_UBLOX_PACKET_VALIDITY_NOT_DEFINED, SFE_UBLOX_PACKET_VALIDITY_NOT_DEFINED};
+    sfe_ublox_status_e result = sendCommand(&packet, 0); // maxWait of 0: send only, the ACK is picked up by processUBX
+    command->sent = true;
+    command->sentAt = millis();
+    if (result != SFE_UBLOX_STATUS_SUCCESS)
+    {
+      command->status = result;
+      command->done = true;
+    }
+  }
+
+  if ((!command->done) && (millis() - command->sentAt >= command->maxWait))
+  {
+    command->status = SFE_UBLOX_STATUS_TIMEOUT;
+    command->done = true;
+  }
+
+  if (!command->done)
+    return;
+
+  // Remove the command before calling the callback, so the callback can queue another
+  ubxQueuedCommand_t completed = *command;
+  commandQueueHead = (commandQueueHead + 1) % SFE_UBLOX_COMMAND_QUEUE_SIZE;
+  commandQueueCount--;
+  lastCompletedSequence = completed.sequence;
+  lastCompletedStatus = completed.status;
+
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+  if ((_printDebug == true) && (completed.status != SFE_UBLOX_STATUS_DATA_SENT))
+  {
+    _debugSerial->print(F("checkCommandQueue: command failed: Class: 0x"));
+    _debugSerial->print(completed.cls, HEX);
+    _debugSerial->print(F(" ID: 0x"));
+    _debugSerial->print(completed.id, HEX);
+    _debugSerial->print(F(" Status: "));
+    _debugSerial->println(statusString(completed.status));
   }
-  else if (commType == COMM_TYPE_SPI)
+#endif
+
+  if (completed.callback != NULL)
+    completed.callback(completed.cls, completed.id, completed.status);
+
+  // Start the next command straight away rather than waiting for the next checkUblox
+  if (commandQueueCount > 0)
+    checkCommandQueue();
+}
+
+// The blocking form of a queued command: run checkUblox until the command completes
+sfe_ublox_status_e SFE_UBLOX_GNSS::waitForCommand(uint32_t sequence)
+{
+  while (true)
   {
-    sendSpiCommand(outgoingUBX);
+    if (lastCompletedSequence == sequence)
+      return (lastCompletedStatus);
+    if ((commandQueueCount == 0) || (commandQueue[commandQueueHead].sequence > sequence))
+      return (SFE_UBLOX_STATUS_FAIL); // Already completed and overtaken, or never queued
+    checkUblox();
+    delay(1);
   }
+}
 
-  if (maxWait > 0)
+// A command is pending from when it is queued until it has been ACKed, NACKed or has timed out
+bool SFE_UBLOX_GNSS::commandPending(uint32_t sequence)
+{
+  return ((commandQueueCount > 0) && (commandQueue[commandQueueHead].sequence <= sequence) && (sequence <= commandSequence));
+}
+
+// Drop all queued commands. The callbacks are not called
+void SFE_UBLOX_GNSS::clearCommandQueue(void)
+{
+  while (commandQueueCount > 0)
   {
-    // Depending on what we just sent, either we need to look for an ACK or not
-    if ((outgoingUBX->cls == UBX_CLASS_CFG) || (expectACKonly == true))
-    {
-#ifndef SFE_UBLOX_REDUCED_PROG_MEM
-      if (_printDebug == true)
-      {
-        _debugSerial->println(F("sendCommand: Waiting for ACK response"));
-      }
-#endif
-      retVal = waitForACKResponse(outgoingUBX, outgoingUBX->cls, outgoingUBX->id, maxWait); // Wait for Ack response
-    }
-    else
-    {
-#ifndef SFE_UBLOX_REDUCED_PROG_MEM
-      if (_printDebug == true)
-      {
-        _debugSerial->println(F("sendCommand: Waiting for No ACK response"));
-      }
-#endif
-      retVal = waitForNoACKResponse(outgoingUBX, outgoingUBX->cls, outgoingUBX->id, maxWait); // Wait for Ack response
-    }
+    commandQueueHead = (commandQueueHead + 1) % SFE_UBLOX_COMMAND_QUEUE_SIZE;
+    commandQueueCount--;
   }
-  return retVal;
 }
 
 // Returns false if sensor fails to respond to I2C traffic
@@ -6173,13 +6883,12 @@ size_t SFE_UBLOX_GNSS::pushAssistNowDataInternal(size_t offset, bool skipTime, c
     uint8_t checksumA = 0;
     uint8_t checksumB = 0;
     // Calculate the checksum bytes
-    // Keep going until the end of the packet is reached (payloadPtr == (dataPtr + packetLength))
-    // or we reach the end of the AssistNow data (payloadPtr == offset + numDataBytes)
-    for (size_t payloadPtr = dataPtr + ((size_t)2); (payloadPtr < (dataPtr + packetLength + ((size_t)6))) && (payloadPtr < (offset + numDataBytes)); payloadPtr++)
-    {
-      checksumA += *(dataBytes + payloadPtr);
-      checksumB += checksumA;
-    }
+    // Stop at the end of the packet or at the end of the AssistNow data, whichever comes first
+    size_t checksumEnd = dataPtr + packetLength + ((size_t)6);
+    if (checksumEnd > (offset + numDataBytes))
+      checksumEnd = offset + numDataBytes;
+    if (checksumEnd > (dataPtr + ((size_t)2)))
+      fletcher8(dataBytes + dataPtr + ((size_t)2), checksumEnd - (dataPtr + ((size_t)2)), checksumA, checksumB);
     // Check the checksum bytes
     dataIsOK &= (checksumA == *(dataBytes + dataPtr + packetLength + ((size_t)6)));
     dataIsOK &= (checksumB == *(dataBytes + dataPtr + packetLength + ((size_t)7)));
@@ -6495,6 +7204,31 @@ bool SFE_UBLOX_GNSS::setPositionAssistanceLLH(int32_t lat, int32_t lon, int32_t
   return (pushAssistNowDataInternal(0, false, iniPosLLH, 28, mgaAck, maxWait) == 28);
 }
 
+// Count the UBX-MGA-ACK-DATA0 messages received so far, emptying the ringbuffer. Returns at once
+uint16_t SFE_UBLOX_GNSS::readMGAACKs(uint16_t *accepted)
+{
+  if (accepted != NULL)
+    *accepted = 0;
+  if (packetUBXMGAACK == NULL)
+    initPacketUBXMGAACK();     // Check that RAM has been allocated for the MGA_ACK data
+  if (packetUBXMGAACK == NULL) // Bail if the RAM allocation failed
+    return (0);
+
+  uint16_t acks = 0;
+  while (packetUBXMGAACK->head != packetUBXMGAACK->tail) // Does the MGA ACK ringbuffer contain any ACK's?
+  {
+    if ((accepted != NULL) && (packetUBXMGAACK->data[packetUBXMGAACK->tail].type == (uint8_t)1) && (packetUBXMGAACK->data[packetUBXMGAACK->tail].infoCode == (uint8_t)SFE_UBLOX_MGA_ACK_INFOCODE_ACCEPTED))
+      (*accepted)++;
+    acks++;
+
+    // Increment the tail
+    packetUBXMGAACK->tail++;
+    if (packetUBXMGAACK->tail == UBX_MGA_ACK_DATA0_RINGBUFFER_LEN)
+      packetUBXMGAACK->tail = 0;
+  }
+  return (acks);
+}
+
 // Find the start of the AssistNow Offline (UBX_MGA_ANO) data for the chosen day
 // The daysIntoFture parameter makes it easy to get the data for (e.g.) tomorrow based on today's date
 // Returns numDataBytes if unsuccessful
@@ -6855,6 +7589,163 @@ size_t SFE_UBLOX_GNSS::readNavigationDatabase(uint8_t *dataBytes, size_t maxNumD
   return (numBytesReceived);
 }
 
+// Start a non-blocking read of the navigation database.
+// Allocates the MGA ACK and DBD storage, enables ackAiding and sends the UBX-MGA-DBD poll.
+// Returns true if the poll was sent.
+bool SFE_UBLOX_GNSS::startNavigationDatabaseRead(uint16_t maxWait)
+{
+  if (navDBDReadInProgress)
+    return (false);
+
+  // Record what ackAiding is currently set to so we can restore it, then enable it
+  uint8_t ackAiding = getAckAiding(maxWait);
+  if (ackAiding == 255)
+    ackAiding = 0; // If the get failed, disable the ACKs when finishing
+  setAckAiding(1, maxWait);
+
+  return (pollNavigationDatabase(ackAiding));
+}
+
+// Start a non-blocking read of the navigation database with ackAiding already enabled.
+// restoreAckAiding is put back, through the command queue, when the read finishes.
+// Returns true if the poll was sent.
+bool SFE_UBLOX_GNSS::pollNavigationDatabase(uint8_t restoreAckAiding)
+{
+  if (navDBDReadInProgress)
+    return (false);
+
+  if (packetUBXMGAACK == NULL)
+    initPacketUBXMGAACK();     // Check that RAM has been allocated for the MGA_ACK data
+  if (packetUBXMGADBD == NULL)
+    initPacketUBXMGADBD();     // Check that RAM has been allocated for the MGA_DBD data
+  if ((packetUBXMGAACK == NULL) || (packetUBXMGADBD == NULL)) // Bail if the RAM allocation failed
+  {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+    if ((_printDebug == true) || (_printLimitedDebug == true)) // This is important. Print this if doing limited debugging
+    {
+      _debugSerial->println(F("pollNavigationDatabase: RAM allocation failed!"));
+    }
+#endif
+    return (false);
+  }
+  packetUBXMGAACK->tail = packetUBXMGAACK->head; // Discard any unprocessed data
+  packetUBXMGADBD->tail = packetUBXMGADBD->head;
+
+  navDBDAckAiding = restoreAckAiding;
+
+  // Record what i2cPollingWait is currently set to so we can restore it
+  navDBDI2cPollingWait = i2cPollingWait;
+  i2cPollingWait = 1;
+
+  // Construct the poll message:
+  uint8_t pollNaviDatabase[8];       // Create the UBX-MGA-DBD message by hand
+  memset(pollNaviDatabase, 0x00, 8); // Set all unused / reserved bytes and the checksum to zero
+
+  pollNaviDatabase[0] = UBX_SYNCH_1;   // Sync char 1
+  pollNaviDatabase[1] = UBX_SYNCH_2;   // Sync char 2
+  pollNaviDatabase[2] = UBX_CLASS_MGA; // Class
+  pollNaviDatabase[3] = UBX_MGA_DBD;   // ID
+
+  for (uint8_t i = 2; i < 6; i++) // Calculate the checksum
+  {
+    pollNaviDatabase[6] += pollNaviDatabase[i];
+    pollNaviDatabase[7] += pollNaviDatabase[6];
+  }
+
+  navDBDEntriesRX = 0;
+  navDBDReadInProgress = true;
+
+  // Do not Wait for an ACK - the DBD data will start arriving immediately.
+  if (pushAssistNowDataInternal(0, false, pollNaviDatabase, (size_t)8, SFE_UBLOX_MGA_ASSIST_ACK_NO, 0) != 8)
+  {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+    if (_printDebug == true)
+    {
+      _debugSerial->println(F("pollNavigationDatabase: pushAssistNowDataInternal failed!"));
+    }
+#endif
+    stopNavigationDatabaseRead();
+    return (false);
+  }
+  return (true);
+}
+
+// Copy the database entries received so far into dataBytes. Only whole entries are copied.
+// Returns the number of bytes written. complete is set to true once the final UBX-MGA-ACK has arrived.
+size_t SFE_UBLOX_GNSS::readNavigationDatabaseEntries(uint8_t *dataBytes, size_t maxNumDataBytes, bool *complete)
+{
+  *complete = false;
+  if (!navDBDReadInProgress)
+    return ((size_t)0);
+
+  size_t numBytesReceived = 0;
+  while (packetUBXMGADBD->head != packetUBXMGADBD->tail) // Does the MGA DBD ringbuffer contain any data?
+  {
+    UBX_MGA_DBD_data_t *entry = &packetUBXMGADBD->data[packetUBXMGADBD->tail];
+    size_t msgLen = (((size_t)entry->dbdEntryLenMSB) << 8) | ((size_t)entry->dbdEntryLenLSB);
+    if ((numBytesReceived + msgLen + ((size_t)8)) > maxNumDataBytes)
+      return (numBytesReceived); // Leave this entry for the next call. The final ACK can only follow it
+
+    // The data will be valid - process will have already checked it
+    uint8_t *dest = dataBytes + numBytesReceived;
+    *(dest++) = entry->dbdEntryHeader1;
+    *(dest++) = entry->dbdEntryHeader2;
+    *(dest++) = entry->dbdEntryClass;
+    *(dest++) = entry->dbdEntryID;
+    *(dest++) = entry->dbdEntryLenLSB;
+    *(dest++) = entry->dbdEntryLenMSB;
+    memcpy(dest, entry->dbdEntry, msgLen);
+    dest += msgLen;
+    *(dest++) = entry->dbdEntryChecksumA;
+    *(dest++) = entry->dbdEntryChecksumB;
+    numBytesReceived += msgLen + ((size_t)8);
+
+    // Increment the tail
+    packetUBXMGADBD->tail++;
+    if (packetUBXMGADBD->tail == UBX_MGA_DBD_RINGBUFFER_LEN)
+      packetUBXMGADBD->tail = 0;
+
+    navDBDEntriesRX++; // Increment the number of entries received
+  }
+
+  // The final MGA-ACK is sent at the end of the DBD packets. So, we need to check the ACK buffer _after_ the DBD buffer.
+  while (packetUBXMGAACK->head != packetUBXMGAACK->tail) // Does the MGA ACK ringbuffer contain any data?
+  {
+    bool idMatch = (packetUBXMGAACK->data[packetUBXMGAACK->tail].msgId == UBX_MGA_DBD); // Check if the message ID matches
+    uint32_t entriesAckd = ((uint32_t)packetUBXMGAACK->data[packetUBXMGAACK->tail].msgPayloadStart[0]) | (((uint32_t)packetUBXMGAACK->data[packetUBXMGAACK->tail].msgPayloadStart[1]) << 8) | (((uint32_t)packetUBXMGAACK->data[packetUBXMGAACK->tail].msgPayloadStart[2]) << 16) | (((uint32_t)packetUBXMGAACK->data[packetUBXMGAACK->tail].msgPayloadStart[3]) << 24);
+
+    // Increment the tail
+    packetUBXMGAACK->tail++;
+    if (packetUBXMGAACK->tail == UBX_MGA_ACK_DATA0_RINGBUFFER_LEN)
+      packetUBXMGAACK->tail = 0;
+
+    if (idMatch && (entriesAckd == navDBDEntriesRX)) // Is the ACK valid?
+    {
+#ifndef SFE_UBLOX_REDUCED_PROG_MEM
+      if ((_printDebug == true) || (_printLimitedDebug == true)) // This is important. Print this if doing limited debugging
+      {
+        _debugSerial->print(F("readNavigationDatabaseEntries: ACK received. navDBDEntriesRX is "));
+        _debugSerial->println(navDBDEntriesRX);
+      }
+#endif
+      stopNavigationDatabaseRead();
+      *complete = true;
+      return (numBytesReceived);
+    }
+  }
+  return (numBytesReceived);
+}
+
+// Finish or abandon a non-blocking navigation database read. Restores ackAiding and the polling wait
+void SFE_UBLOX_GNSS::stopNavigationDatabaseRead(uint16_t maxWait)
+{
+  if (!navDBDReadInProgress)
+    return;
+  navDBDReadInProgress = false;
+  i2cPollingWait = navDBDI2cPollingWait;           // Restore i2cPollingWait
+  setAckAidingAsync(navDBDAckAiding, NULL, maxWait); // Restore Ack Aiding. Queued, as this is called from readNavigationDatabaseEntries
+}
+
 // PRIVATE: Allocate RAM for packetUBXMGADBD and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXMGADBD()
 {
@@ -6914,11 +7805,53 @@ uint16_t SFE_UBLOX_GNSS::extractFileBufferData(uint8_t *destination, uint16_t nu
   else
   {
     fileBufferTail += numBytes; // Only update Tail. The next byte to be read will be read from here.
+    if (fileBufferTail == fileBufferSize)
+      fileBufferTail = 0; // Keep Tail inside the buffer, so it compares correctly with Head
   }
 
   return (numBytes); // Return the number of bytes extracted
 }
 
+// Point first and second at the data waiting in the file buffer, without copying it.
+// The data runs from Tail to the end of the buffer, then continues from the start if it has wrapped around.
+// Returns the total number of bytes available.
+uint16_t SFE_UBLOX_GNSS::peekFileBuffer(const uint8_t **first, uint16_t *firstLength, const uint8_t **second, uint16_t *secondLength)
+{
+  *firstLength = 0;
+  *secondLength = 0;
+  if (ubxFileBuffer == NULL) // Bail if the file buffer has not been created
+    return (0);
+
+  uint16_t bytesAvailable = fileBufferSpaceUsed();
+
+  uint16_t bytesBeforeWrapAround = fileBufferSize - fileBufferTail; // How much data is there 'above' Tail?
+  if (bytesBeforeWrapAround > bytesAvailable)
+    bytesBeforeWrapAround = bytesAvailable; // The data does not wrap around
+
+  *first = &ubxFileBuffer[fileBufferTail];
+  *firstLength = bytesBeforeWrapAround;
+  *second = &ubxFileBuffer[0];
+  *secondLength = bytesAvailable - bytesBeforeWrapAround;
+  return (bytesAvailable);
+}
+
+// Remove numBytes from the file buffer, after they have been used through peekFileBuffer.
+// Returns the number of bytes removed - which may be less than numBytes.
+uint16_t SFE_UBLOX_GNSS::discardFileBufferData(uint16_t numBytes)
+{
+  uint16_t bytesAvailable = fileBufferSpaceUsed();
+  if (numBytes > bytesAvailable) // Limit numBytes if required
+    numBytes = bytesAvailable;
+
+  uint16_t bytesBeforeWrapAround = fileBufferSize - fileBufferTail;
+  if (numBytes >= bytesBeforeWrapAround)
+    fileBufferTail = numBytes - bytesBeforeWrapAround; // Wrap-around
+  else
+    fileBufferTail += numBytes;
+
+  return (numBytes);
+}
+
 // Returns the number of bytes available in file buffer which are waiting to be read
 uint16_t SFE_UBLOX_GNSS::fileBufferAvailable(void)
 {
@@ -6946,6 +7879,12 @@ void SFE_UBLOX_GNSS::clearMaxFileBufferAvail(void)
   fileBufferMaxAvail = 0;
 }
 
+// Returns the number of packets lost because the file buffer was full
+uint32_t SFE_UBLOX_GNSS::getFileBufferDropped(void)
+{
+  return (fileBufferDropped);
+}
+
 // PRIVATE: Create the file buffer. Called by .begin
 bool SFE_UBLOX_GNSS::createFileBuffer(void)
 {
@@ -6971,7 +7910,12 @@ bool SFE_UBLOX_GNSS::createFileBuffer(void)
     return (false);
   }
 
-  ubxFileBuffer = new uint8_t[fileBufferSize]; // Allocate RAM for the buffer
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  if (fileBufferSize <= sizeof(staticFileBuffer))
+    ubxFileBuffer = staticFileBuffer;
+  else
+#endif
+    ubxFileBuffer = new uint8_t[fileBufferSize]; // Allocate RAM for the buffer
 
   if (ubxFileBuffer == NULL) // Check if the new (alloc) was successful
   {
@@ -6997,9 +7941,10 @@ bool SFE_UBLOX_GNSS::createFileBuffer(void)
 }
 
 // PRIVATE: Check how much space is available in the buffer
+// One byte is always left free. A completely full buffer would have Head equal to Tail and look empty.
 uint16_t SFE_UBLOX_GNSS::fileBufferSpaceAvailable(void)
 {
-  return (fileBufferSize - fileBufferSpaceUsed());
+  return (fileBufferSize - fileBufferSpaceUsed() - 1);
 }
 
 // PRIVATE: Check how much space is used in the buffer
@@ -7042,29 +7987,20 @@ bool SFE_UBLOX_GNSS::storePacket(ubxPacket *msg)
       _debugSerial->println(F("storePacket: insufficient space available! Data will be lost!"));
     }
 #endif
+    fileBufferDropped++;
     return (false);
   }
 
-  // Store the two sync chars
-  uint8_t sync_chars[] = {UBX_SYNCH_1, UBX_SYNCH_2};
-  writeToFileBuffer(sync_chars, 2);
-
-  // Store the Class & ID
-  writeToFileBuffer(&msg->cls, 1);
-  writeToFileBuffer(&msg->id, 1);
-
-  // Store the length. Ensure length is little-endian
-  uint8_t msg_length[2];
-  msg_length[0] = msg->len & 0xFF;
-  msg_length[1] = msg->len >> 8;
-  writeToFileBuffer(msg_length, 2);
+  // Store the sync chars, Class, ID and length together. Ensure length is little-endian
+  uint8_t header[6] = {UBX_SYNCH_1, UBX_SYNCH_2, msg->cls, msg->id, (uint8_t)(msg->len & 0xFF), (uint8_t)(msg->len >> 8)};
+  writeToFileBuffer(header, 6);
 
   // Store the payload
   writeToFileBuffer(msg->payload, msg->len);
 
   // Store the checksum
-  writeToFileBuffer(&msg->checksumA, 1);
-  writeToFileBuffer(&msg->checksumB, 1);
+  uint8_t checksum[2] = {msg->checksumA, msg->checksumB};
+  writeToFileBuffer(checksum, 2);
 
   return (true);
 }
@@ -7093,6 +8029,7 @@ bool SFE_UBLOX_GNSS::storeFileBytes(uint8_t *theBytes, uint16_t numBytes)
       _debugSerial->println(F("storeFileBytes: insufficient space available! Data will be lost!"));
     }
 #endif
+    fileBufferDropped++;
     return (false);
   }
 
@@ -7103,7 +8040,7 @@ bool SFE_UBLOX_GNSS::storeFileBytes(uint8_t *theBytes, uint16_t numBytes)
 }
 
 // PRIVATE: Write theBytes to the file buffer
-void SFE_UBLOX_GNSS::writeToFileBuffer(uint8_t *theBytes, uint16_t numBytes)
+void SFE_UBLOX_GNSS::writeToFileBuffer(const uint8_t *theBytes, uint16_t numBytes)
 {
   // Start writing at fileBufferHead. Wrap-around if required.
   uint16_t bytesBeforeWrapAround = fileBufferSize - fileBufferHead; // How much space is available 'above' Head?
@@ -7123,6 +8060,8 @@ void SFE_UBLOX_GNSS::writeToFileBuffer(uint8_t *theBytes, uint16_t numBytes)
   else
   {
     fileBufferHead += numBytes; // Only update Head. The next byte written will be written here.
+    if (fileBufferHead == fileBufferSize)
+      fileBufferHead = 0; // Keep Head inside the buffer, so it compares correctly with Tail
   }
 
   // Update fileBufferMaxAvail if required
@@ -8592,6 +9531,13 @@ bool SFE_UBLOX_GNSS::setAckAiding(uint8_t ackAiding, uint16_t maxWait) // Set th
   return (sendCommand(&packetCfg, maxWait) == SFE_UBLOX_STATUS_DATA_SENT); // We are only expecting an ACK
 }
 
+bool SFE_UBLOX_GNSS::setAckAidingAsync(uint8_t ackAiding, sfe_ublox_command_callback_t callback, uint16_t maxWait) // Set ackAiding through the command queue
+{
+  // The UBX-CFG-NAVX5 set above needs the current message polled first. CFG-VALSET only needs the key
+  newCfgValset8(UBLOX_CFG_NAVSPG_ACKAIDING, ackAiding, VAL_LAYER_RAM);
+  return (sendCfgValsetAsync(callback, maxWait));
+}
+
 // AssistNow Autonomous support
 // UBX-CFG-NAVX5 - get the AssistNow Autonomous configuration (aopCfg) - returns 255 if the sendCommand fails
 uint8_t SFE_UBLOX_GNSS::getAopCfg(uint16_t maxWait)
@@ -9268,6 +10214,93 @@ uint8_t SFE_UBLOX_GNSS::newCfgValset16(uint32_t key, uint16_t value, uint8_t lay
   return (true);
 }
 
+// Read several keys with a single UBX-CFG-VALGET
+// values[i] is set to the value of keys[i]. The size of each value is taken from bits 28-30 of its key
+// Default layer is RAM
+sfe_ublox_status_e SFE_UBLOX_GNSS::getValN(const uint32_t *keys, uint8_t numKeys, uint64_t *values, uint8_t layer, uint16_t maxWait)
+{
+  if ((numKeys == 0) || (numKeys > 64) || (packetCfgPayloadSize < (size_t)(4 + 12 * numKeys)))
+    return (SFE_UBLOX_STATUS_OUT_OF_RANGE); // The receiver accepts at most 64 keys, and the response must fit in payloadCfg
+
+  packetCfg.cls = UBX_CLASS_CFG;
+  packetCfg.id = UBX_CFG_VALGET;
+  packetCfg.len = 4 + 4 * numKeys;
+  packetCfg.startingSpot = 0;
+
+  memset(payloadCfg, 0, packetCfg.len);
+
+  payloadCfg[0] = 0;                                                  // Message Version - set to 0
+  payloadCfg[1] = ((layer & VAL_LAYER_RAM) == VAL_LAYER_RAM) ? 0 : 7; // Layer 0 is RAM, 7 is Default. See getVal
+
+  for (uint8_t k = 0; k < numKeys; k++)
+  {
+    payloadCfg[4 + 4 * k + 0] = keys[k] >> 8 * 0; // Key LSB
+    payloadCfg[4 + 4 * k + 1] = keys[k] >> 8 * 1;
+    payloadCfg[4 + 4 * k + 2] = keys[k] >> 8 * 2;
+    payloadCfg[4 + 4 * k + 3] = keys[k] >> 8 * 3;
+  }
+
+  sfe_ublox_status_e retVal = sendCommand(&packetCfg, maxWait);
+  if (retVal != SFE_UBLOX_STATUS_DATA_RECEIVED)
+    return (retVal);
+
+  // The response is the 4 byte header followed by each key and its value, in the order requested
+  uint16_t offset = 4;
+  for (uint8_t k = 0; k < numKeys; k++)
+  {
+    if (offset + 4 > packetCfg.len)
+      return (SFE_UBLOX_STATUS_OUT_OF_RANGE);
+    uint32_t key = extractLong(&packetCfg, offset);
+    offset += 4;
+
+    uint8_t size;
+    switch ((key >> 28) & 0x07)
+    {
+    case 1: // One bit, stored in a byte
+    case 2:
+      size = 1;
+      break;
+    case 3:
+      size = 2;
+      break;
+    case 4:
+      size = 4;
+      break;
+    default:
+      size = 8;
+      break;
+    }
+    if ((key != keys[k]) || (offset + size > packetCfg.len))
+      return (SFE_UBLOX_STATUS_OUT_OF_RANGE);
+
+    values[k] = 0;
+    for (uint8_t b = 0; b < size; b++)
+      values[k] |= (uint64_t)payloadCfg[offset + b] << (8 * b);
+    offset += size;
+  }
+
+  return (retVal);
+}
+
+// Start defining a new, empty UBX-CFG-VALSET ubxPacket. Add keys with addCfgValset and send it with sendCfgValset
+// Default layer is RAM+BBR+Flash
+uint8_t SFE_UBLOX_GNSS::newCfgValset(uint8_t layer)
+{
+  packetCfg.cls = UBX_CLASS_CFG;
+  packetCfg.id = UBX_CFG_VALSET;
+  packetCfg.len = 4; // 4 byte header
+  packetCfg.startingSpot = 0;
+
+  // Clear all of packet payload
+  memset(payloadCfg, 0, packetCfgPayloadSize);
+
+  payloadCfg[0] = 0;     // Message Version - set to 0
+  payloadCfg[1] = layer; // By default we ask for the BBR layer
+
+  // All done
+  return (true);
+}
+
 // Start defining a new UBX-CFG-VALSET ubxPacket
 // This function takes a full 32-bit key and 8-bit value
 // Default layer is RAM+BBR+Flash
@@ -9433,6 +10466,20 @@ uint8_t SFE_UBLOX_GNSS::sendCfgValset8(uint32_t key, uint8_t value, uint16_t max
   return (sendCommand(&packetCfg, maxWait) == SFE_UBLOX_STATUS_DATA_SENT); // We are only expecting an ACK
 }
 
+// Send the UBX-CFG-VALSET ubxPacket built with newCfgValset and addCfgValset
+uint8_t SFE_UBLOX_GNSS::sendCfgValset(uint16_t maxWait)
+{
+  // A thin wrapper around the queue, so blocking and queued VALSETs are sent in order
+  if (!sendCfgValsetAsync(NULL, maxWait))
+    return (false);
+  return (waitForCommand(commandSequence) == SFE_UBLOX_STATUS_DATA_SENT); // We are only expecting an ACK
+}
+
+bool SFE_UBLOX_GNSS::sendCfgValsetAsync(sfe_ublox_command_callback_t callback, uint16_t maxWait)
+{
+  return (sendCommandAsync(&packetCfg, callback, maxWait));
+}
+
 //=-=-=-=-=-=-=-= "Automatic" Messages =-=-=-=-=-=-=-==-=-=-=-=-=-=-=
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-==-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-
 
@@ -10538,7 +11585,11 @@ bool SFE_UBLOX_GNSS::setAutoPVTcallback(void (*callbackPointer)(UBX_NAV_PVT_data
 
   if (packetUBXNAVPVT->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXNAVPVT->callbackData = &staticUBXNAVPVTcallbackData;
+#else
     packetUBXNAVPVT->callbackData = new UBX_NAV_PVT_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXNAVPVT->callbackData == NULL)
@@ -10564,7 +11615,11 @@ bool SFE_UBLOX_GNSS::setAutoPVTcallbackPtr(void (*callbackPointerPtr)(UBX_NAV_PV
 
   if (packetUBXNAVPVT->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXNAVPVT->callbackData = &staticUBXNAVPVTcallbackData;
+#else
     packetUBXNAVPVT->callbackData = new UBX_NAV_PVT_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXNAVPVT->callbackData == NULL)
@@ -10602,7 +11657,11 @@ bool SFE_UBLOX_GNSS::assumeAutoPVT(bool enabled, bool implicitUpdate)
 // PRIVATE: Allocate RAM for packetUBXNAVPVT and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXNAVPVT()
 {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  packetUBXNAVPVT = &staticUBXNAVPVT; // Placed with the object, not on the heap
+#else
   packetUBXNAVPVT = new UBX_NAV_PVT_t; // Allocate RAM for the main struct
+#endif
   if (packetUBXNAVPVT == NULL)
   {
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -11521,7 +12580,11 @@ bool SFE_UBLOX_GNSS::setAutoHPPOSLLHcallback(void (*callbackPointer)(UBX_NAV_HPP
 
   if (packetUBXNAVHPPOSLLH->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXNAVHPPOSLLH->callbackData = &staticUBXNAVHPPOSLLHcallbackData;
+#else
     packetUBXNAVHPPOSLLH->callbackData = new UBX_NAV_HPPOSLLH_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXNAVHPPOSLLH->callbackData == NULL)
@@ -11546,7 +12609,11 @@ bool SFE_UBLOX_GNSS::setAutoHPPOSLLHcallbackPtr(void (*callbackPointerPtr)(UBX_N
 
   if (packetUBXNAVHPPOSLLH->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXNAVHPPOSLLH->callbackData = &staticUBXNAVHPPOSLLHcallbackData;
+#else
     packetUBXNAVHPPOSLLH->callbackData = new UBX_NAV_HPPOSLLH_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXNAVHPPOSLLH->callbackData == NULL)
@@ -11583,7 +12650,11 @@ bool SFE_UBLOX_GNSS::assumeAutoHPPOSLLH(bool enabled, bool implicitUpdate)
 // PRIVATE: Allocate RAM for packetUBXNAVHPPOSLLH and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXNAVHPPOSLLH()
 {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  packetUBXNAVHPPOSLLH = &staticUBXNAVHPPOSLLH; // Placed with the object, not on the heap
+#else
   packetUBXNAVHPPOSLLH = new UBX_NAV_HPPOSLLH_t; // Allocate RAM for the main struct
+#endif
   if (packetUBXNAVHPPOSLLH == NULL)
   {
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -12318,7 +13389,11 @@ bool SFE_UBLOX_GNSS::setAutoNAVSVINcallbackPtr(void (*callbackPointerPtr)(UBX_NA
 
   if (packetUBXNAVSVIN->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXNAVSVIN->callbackData = &staticUBXNAVSVINcallbackData;
+#else
     packetUBXNAVSVIN->callbackData = new UBX_NAV_SVIN_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXNAVSVIN->callbackData == NULL)
@@ -12355,7 +13430,11 @@ bool SFE_UBLOX_GNSS::assumeAutoNAVSVIN(bool enabled, bool implicitUpdate)
 // PRIVATE: Allocate RAM for packetUBXNAVSVIN and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXNAVSVIN()
 {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  packetUBXNAVSVIN = &staticUBXNAVSVIN; // Placed with the object, not on the heap
+#else
   packetUBXNAVSVIN = new UBX_NAV_SVIN_t; // Allocate RAM for the main struct
+#endif
   if (packetUBXNAVSVIN == NULL)
   {
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -12545,6 +13624,43 @@ bool SFE_UBLOX_GNSS::assumeAutoNAVSAT(bool enabled, bool implicitUpdate)
   return changes;
 }
 
+// Set the streaming NAV SAT callback. Pass NULL to stop it
+void SFE_UBLOX_GNSS::setNAVSATblockCallbackPtr(void (*callbackPointerPtr)(const UBX_NAV_SAT_header_t *header, const UBX_NAV_SAT_block_t *block))
+{
+  navSatBlockCallbackPointerPtr = callbackPointerPtr;
+}
+
+// PRIVATE: Decode a NAV SAT payload byte. The 8 byte header comes first, then a 12 byte block for each satellite
+void SFE_UBLOX_GNSS::streamNAVSAT(uint16_t offset, uint8_t incoming)
+{
+  if (offset < 8)
+  {
+    navSatStreamBytes[offset] = incoming;
+    if (offset == 7)
+    {
+      navSatStreamHeader.iTOW = ((uint32_t)navSatStreamBytes[0]) | ((uint32_t)navSatStreamBytes[1] << 8) | ((uint32_t)navSatStreamBytes[2] << 16) | ((uint32_t)navSatStreamBytes[3] << 24);
+      navSatStreamHeader.version = navSatStreamBytes[4];
+      navSatStreamHeader.numSvs = navSatStreamBytes[5];
+    }
+    return;
+  }
+
+  uint16_t blockOffset = (offset - 8) % 12;
+  navSatStreamBytes[blockOffset] = incoming;
+  if ((blockOffset < 11) || (((offset - 8) / 12) >= navSatStreamHeader.numSvs))
+    return;
+
+  UBX_NAV_SAT_block_t block;
+  block.gnssId = navSatStreamBytes[0];
+  block.svId = navSatStreamBytes[1];
+  block.cno = navSatStreamBytes[2];
+  block.elev = (int8_t)navSatStreamBytes[3];
+  block.azim = (int16_t)(((uint16_t)navSatStreamBytes[4]) | ((uint16_t)navSatStreamBytes[5] << 8));
+  block.prRes = (int16_t)(((uint16_t)navSatStreamBytes[6]) | ((uint16_t)navSatStreamBytes[7] << 8));
+  block.flags.all = ((uint32_t)navSatStreamBytes[8]) | ((uint32_t)navSatStreamBytes[9] << 8) | ((uint32_t)navSatStreamBytes[10] << 16) | ((uint32_t)navSatStreamBytes[11] << 24);
+  navSatBlockCallbackPointerPtr(&navSatStreamHeader, &block);
+}
+
 // PRIVATE: Allocate RAM for packetUBXNAVSAT and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXNAVSAT()
 {
@@ -13457,7 +14573,11 @@ bool SFE_UBLOX_GNSS::setAutoRXMRAWXcallback(void (*callbackPointer)(UBX_RXM_RAWX
 
   if (packetUBXRXMRAWX->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXRXMRAWX->callbackData = &staticUBXRXMRAWXcallbackData;
+#else
     packetUBXRXMRAWX->callbackData = new UBX_RXM_RAWX_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXRXMRAWX->callbackData == NULL)
@@ -13482,7 +14602,11 @@ bool SFE_UBLOX_GNSS::setAutoRXMRAWXcallbackPtr(void (*callbackPointerPtr)(UBX_RX
 
   if (packetUBXRXMRAWX->callbackData == NULL) // Check if RAM has been allocated for the callback copy
   {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+    packetUBXRXMRAWX->callbackData = &staticUBXRXMRAWXcallbackData;
+#else
     packetUBXRXMRAWX->callbackData = new UBX_RXM_RAWX_data_t; // Allocate RAM for the main struct
+#endif
   }
 
   if (packetUBXRXMRAWX->callbackData == NULL)
@@ -13519,7 +14643,11 @@ bool SFE_UBLOX_GNSS::assumeAutoRXMRAWX(bool enabled, bool implicitUpdate)
 // PRIVATE: Allocate RAM for packetUBXRXMRAWX and initialize it
 bool SFE_UBLOX_GNSS::initPacketUBXRXMRAWX()
 {
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  packetUBXRXMRAWX = &staticUBXRXMRAWX; // Placed with the object, not on the heap
+#else
   packetUBXRXMRAWX = new UBX_RXM_RAWX_t; // Allocate RAM for the main struct
+#endif
   if (packetUBXRXMRAWX == NULL)
   {
 #ifndef SFE_UBLOX_REDUCED_PROG_MEM
@@ -56,9 +56,24 @@
 #include "u-blox_config_keys.h"
 #include "u-blox_structs.h"
 
+#include <checksum.h>
+
 // Uncomment the next line (or add SFE_UBLOX_REDUCED_PROG_MEM as a compiler directive) to reduce the amount of program memory used by the library
 //#define SFE_UBLOX_REDUCED_PROG_MEM // Uncommenting this line will delete the minor debug messages to save memory
 
+// Uncomment the next line (or add SFE_UBLOX_STATIC_BASE_MESSAGES as a compiler directive) to place the storage for the
+// base station messages (NAV-PVT, NAV-HPPOSLLH, NAV-SVIN and RXM-RAWX, plus their callback copies) in the object
+// instead of allocating it with new when each message is first used. NAV-SAT is decoded a block at a time with
+// setNAVSATblockCallbackPtr, which needs no storage. The packetCfg payload, the file buffer, the I2C read buffer and
+// the RTCM frame buffer are placed in the object too, up to the sizes below; larger requests still use new
+//#define SFE_UBLOX_STATIC_BASE_MESSAGES
+#ifndef SFE_UBLOX_STATIC_FILE_BUFFER_SIZE
+#define SFE_UBLOX_STATIC_FILE_BUFFER_SIZE 16384
+#endif
+#ifndef SFE_UBLOX_STATIC_I2C_BUFFER_SIZE
+#define SFE_UBLOX_STATIC_I2C_BUFFER_SIZE 2048
+#endif
+
 // Uncomment the next line (or add SFE_UBLOX_DISABLE_AUTO_NMEA as a compiler directive) to reduce the amount of program memory used by the library
 //#define SFE_UBLOX_DISABLE_AUTO_NMEA // Uncommenting this line will disable auto-NMEA support to save memory
 
@@ -615,6 +630,42 @@ typedef struct
   uint32_t rads[4];  // Radii of geofences (in m * 10^-2)
 } geofenceParams_t;
 
+// Struct to hold the RTCM frame counters
+typedef struct
+{
+  uint32_t framesGood;      // Frames that passed CRC-24Q
+  uint32_t framesBadCRC;    // Frames that failed CRC-24Q
+  uint32_t framesTruncated; // Frames abandoned because the header was invalid, so the frame could not be collected in full
+} rtcmFrameStats_t;
+
+// RTCM 3 frame: preamble, 6 reserved bits and 10-bit length, up to 1023 bytes of message, 3 bytes of CRC
+const uint16_t SFE_UBLOX_RTCM_MAX_FRAME_SIZE = 3 + 1023 + 3;
+
+// Asynchronous command queue
+const uint8_t SFE_UBLOX_COMMAND_QUEUE_SIZE = 8; // Commands which can be waiting for an ACK at once
+const uint16_t SFE_UBLOX_VALSET_MAX_PAYLOAD_SIZE = 4 + 64 * (4 + 8); // UBX-CFG-VALSET header plus the most keys the module accepts, each with a 64 bit value
+// Largest payload a queued command can carry. The pool holds one per queue entry, so a full VALSET can always be queued
+const uint16_t SFE_UBLOX_COMMAND_PAYLOAD_SIZE = (MAX_PAYLOAD_SIZE > SFE_UBLOX_VALSET_MAX_PAYLOAD_SIZE) ? MAX_PAYLOAD_SIZE : SFE_UBLOX_VALSET_MAX_PAYLOAD_SIZE;
+
+// Called from checkUblox when a queued command completes: DATA_SENT on ACK, COMMAND_NACK on NACK, TIMEOUT or a send failure
+typedef void (*sfe_ublox_command_callback_t)(uint8_t cls, uint8_t id, sfe_ublox_status_e status);
+
+// Struct to hold a queued command
+typedef struct
+{
+  uint8_t cls;
+  uint8_t id;
+  uint16_t len;
+  uint8_t *payload;           // Copy of the payload, in the command's slot of the payload pool
+  uint16_t maxWait;           // ms to wait for the ACK once the command has been sent
+  unsigned long sentAt;       // millis() when the command was written to the module
+  bool sent;                  // The command has been written to the module
+  bool done;                  // The command has completed. status holds the result
+  sfe_ublox_status_e status;
+  uint32_t sequence;          // Increments with each queued command
+  sfe_ublox_command_callback_t callback;
+} ubxQueuedCommand_t;
+
 // Struct to hold the module software version
 typedef struct
 {
@@ -664,6 +715,7 @@ public:
 
   // New in v2.0: allow the payload size for packetCfg to be changed
   bool setPacketCfgPayloadSize(size_t payloadSize); // Set packetCfgPayloadSize
+  size_t getPacketCfgPayloadSize(void) { return (packetCfgPayloadSize); }
 
   // Begin communication with the GNSS. Advanced users can assume success if required. Useful if the port is already outputting messages at high navigation rate.
   // Begin will then return true if "signs of life" have been seen: reception of _any_ valid UBX packet or _any_ valid NMEA header.
@@ -677,7 +729,26 @@ public:
   void end(void); // Stop all automatic message processing. Free all used RAM
 
   void setI2CpollingWait(uint8_t newPollingWait_ms); // Allow the user to change the I2C polling wait if required
+  uint8_t getI2CpollingWait(void);                   // Return the I2C polling wait
+
+  // Buffered I2C reading: read at most readBudget bytes from the module per checkUblox call into a ring buffer,
+  // then process the buffer until it is empty or processBudget_us has elapsed. This stops a burst of RTCM and UBX
+  // data from stalling the caller for the whole time it takes to drain the module at 400kHz.
+  // The two budgets are separate: the processing budget starts once the read has finished, so a full read never
+  // leaves it used up with nothing parsed and the buffer growing.
+  void setI2CBufferSize(uint16_t bufferSize);                                 // Set the size of the I2C read buffer. This must be called _before_ .begin. 0 disables buffering
+  uint16_t getI2CBufferSize(void);                                            // Return the size of the I2C read buffer
+  void setI2CReadBudget(uint16_t readBudget);                                 // Max bytes read from the module per call. 0 = read everything available
+  void setProcessTimeBudget(uint16_t processBudget_us);                       // Max time spent processing buffered bytes per call. 0 = process everything
+  void setI2CTxReadyPin(int8_t pin, bool activeHigh = true);                  // Only poll the module when its TX-ready pin is asserted (see CFG-TXREADY). -1 disables
+  uint16_t getMaxI2CBufferAvail(void);                                        // Return the most bytes the I2C buffer has held
+  uint32_t getMaxCheckStall(void);                                            // Return the longest time (us) a single check of the port has taken, on any port
+  void clearI2CStats(void);                                                   // Reset the buffer and stall maximums
+  uint32_t getBusBytes(void) { return (busBytes); }                           // Return the bytes clocked in from the module: I2C address bytes included, SPI idle bytes included
+  uint32_t getBusTransactions(void) { return (busTransactions); }             // Return the I2C transactions, SPI transactions or serial reads made to collect them
   void setSPIpollingWait(uint8_t newPollingWait_ms); // Allow the user to change the SPI polling wait if required
+  // Serial and SPI are read a block at a time too: whatever the serial port has received, or a whole SPI transaction
+  // (see setSpiTransactionSize), goes to the parser in one span. setProcessTimeBudget limits both.
 
   // Set the max number of bytes set in a given I2C transaction
   uint8_t i2cTransactionSize = 32; // Default to ATmega328 limit
@@ -740,15 +811,28 @@ public:
   bool checkUblox(uint8_t requestedClass = 0, uint8_t requestedID = 0); // Checks module with user selected commType
 
   bool checkUbloxI2C(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID);    // Method for I2C polling of data, passing any new bytes to process()
+  bool checkUbloxI2CBuffered(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID); // Method for budgeted I2C reads into the I2C buffer, processing the buffer incrementally
   bool checkUbloxSerial(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID); // Method for serial polling of data, passing any new bytes to process()
   bool checkUbloxSpi(ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID);    // Method for spi polling of data, passing any new bytes to process()
 
   // Process the incoming data
 
   void process(uint8_t incoming, ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID);             // Processes NMEA and UBX binary sentences one byte at a time
+  uint16_t processSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID); // Processes a buffer, scanning for sync bytes and taking UBX payloads and RTCM frame bodies in bulk. Returns length
   void processNMEA(char incoming) __attribute__((weak));                                                           // Given a NMEA character, do something with it. User can overwrite if desired to use something like tinyGPS or MicroNMEA libraries
   sfe_ublox_sentence_types_e processRTCMframe(uint8_t incoming, uint16_t *rtcmFrameCounter) __attribute__((weak)); // Monitor the incoming bytes for start and length bytes
   void processRTCM(uint8_t incoming) __attribute__((weak));                                                        // Given rtcm byte, do something with it. User can overwrite if desired to pipe bytes to radio, internet, etc.
+
+  // RTCM frame callback: called with each complete, CRC-validated RTCM frame as soon as its last byte is processed.
+  // frame points to the whole frame (preamble to CRC) and is only valid during the callback. epoch is the raw 30-bit
+  // epoch time field of MSM messages (ms of week, or day and ms of day for GLONASS), and 0 for other messages.
+  // When a frame callback is set, processRTCM is no longer called for each byte.
+  void setRTCMFrameCallbackPtr(void (*callbackPointerPtr)(const uint8_t *frame, uint16_t length, uint16_t messageNumber, uint32_t epoch));
+  // Meter every valid UBX packet and RTCM frame with its length on the wire. RTCM is class 0xF5 and ID message number - 1000, as in CFG-MSG
+  void setMessageMeterCallbackPtr(void (*callbackPointerPtr)(uint8_t cls, uint8_t id, uint16_t length));
+  rtcmFrameStats_t getRTCMFrameStats(void) { return (rtcmStats); } // Return the good, bad CRC and truncated frame counts
+  void clearRTCMFrameStats(void);
+  static uint32_t crc24q(const uint8_t *data, uint16_t length); // Calculate the RTCM CRC-24Q of data
   void processUBX(uint8_t incoming, ubxPacket *incomingUBX, uint8_t requestedClass, uint8_t requestedID);          // Given a character, file it away into the uxb packet structure
   void processUBXpacket(ubxPacket *msg);                                                                           // Once a packet has been received and validated, identify this packet's class/id and update internal flags
 
@@ -756,6 +840,17 @@ public:
 
   void calcChecksum(ubxPacket *msg);                                                                                     // Sets the checksumA and checksumB of a given messages
   sfe_ublox_status_e sendCommand(ubxPacket *outgoingUBX, uint16_t maxWait = defaultMaxWait, bool expectACKonly = false); // Given a packet and payload, send everything including CRC bytes, return true if we got a response
+
+  // Asynchronous commands: the packet is copied into a queue and returns at once. checkUblox sends the queued commands one
+  // at a time and calls the callback when each is ACKed, NACKed or times out, so the caller's loop keeps running meanwhile.
+  // Only commands answered by a plain ACK (CFG sets) can be queued. Polls which return data still use the blocking calls.
+  // A blocking command waits for the queue to empty before it is sent, and fails with INVALID_OPERATION if it does not.
+  bool sendCommandAsync(ubxPacket *outgoingUBX, sfe_ublox_command_callback_t callback = NULL, uint16_t maxWait = defaultMaxWait); // Returns false if the queue is full or the payload is larger than SFE_UBLOX_COMMAND_PAYLOAD_SIZE
+  sfe_ublox_status_e waitForCommand(uint32_t sequence);                   // Block in checkUblox until the queued command with this sequence number completes
+  uint32_t getLastCommandSequence(void) { return (commandSequence); }     // Sequence number of the most recently queued command
+  bool commandPending(uint32_t sequence);                                 // True until the queued command with this sequence number completes
+  uint8_t getCommandQueueCount(void) { return (commandQueueCount); }      // Commands queued or waiting for an ACK
+  void clearCommandQueue(void);                                           // Drop all queued commands without calling their callbacks
   sfe_ublox_status_e sendI2cCommand(ubxPacket *outgoingUBX, uint16_t maxWait = defaultMaxWait);
   void sendSerialCommand(ubxPacket *outgoingUBX);
   void sendSpiCommand(ubxPacket *outgoingUBX);
@@ -812,6 +907,10 @@ public:
   size_t findMGAANOForDate(const String &dataBytes, size_t numDataBytes, uint16_t year, uint8_t month, uint8_t day, uint8_t daysIntoFuture = 0);
   size_t findMGAANOForDate(const uint8_t *dataBytes, size_t numDataBytes, uint16_t year, uint8_t month, uint8_t day, uint8_t daysIntoFuture = 0);
 
+  // Count the UBX-MGA-ACK-DATA0 messages received since the last call, without waiting. Use this to pace data pushed
+  // with SFE_UBLOX_MGA_ASSIST_ACK_NO while checkUblox is being called regularly. accepted counts the ACKs whose data was accepted
+  uint16_t readMGAACKs(uint16_t *accepted = NULL);
+
 // Read the whole navigation data base. The receiver will send all available data from its internal database.
 // Data is written to dataBytes. Set maxNumDataBytes to the (maximum) size of dataBytes.
 // If the database exceeds maxNumDataBytes, the excess bytes will be lost.
@@ -821,6 +920,21 @@ public:
 #define defaultNavDBDMaxWait 3100
   size_t readNavigationDatabase(uint8_t *dataBytes, size_t maxNumDataBytes, uint16_t maxWait = defaultNavDBDMaxWait);
 
+  // Read the navigation database without blocking. Use this when checkUblox is already being called regularly.
+  // startNavigationDatabaseRead enables ackAiding, reduces the polling wait and sends the UBX-MGA-DBD poll.
+  // readNavigationDatabaseEntries copies whole database entries into dataBytes as they arrive. Entries which do not fit
+  // are left in the ringbuffer for the next call. complete is set once the final UBX-MGA-ACK has been received.
+  // stopNavigationDatabaseRead restores ackAiding and the polling wait. It is called automatically on completion.
+  // Call it yourself to abandon a read which has timed out. ackAiding is restored through the command queue, so it does not block.
+  // pollNavigationDatabase starts the read without the blocking ackAiding get and set: the caller has already enabled ackAiding,
+  // e.g. with setAckAidingAsync, and knows the setting restoreAckAiding to put back when the read finishes.
+  bool startNavigationDatabaseRead(uint16_t maxWait = defaultMaxWait);
+  bool pollNavigationDatabase(uint8_t restoreAckAiding);
+  size_t readNavigationDatabaseEntries(uint8_t *dataBytes, size_t maxNumDataBytes, bool *complete);
+  void stopNavigationDatabaseRead(uint16_t maxWait = defaultMaxWait);
+  bool navigationDatabaseReadInProgress(void) { return (navDBDReadInProgress); }
+  uint32_t getNavigationDatabaseEntries(void) { return (navDBDEntriesRX); } // Entries received by the current or last read
+
   // Support for data logging
   void setFileBufferSize(uint16_t bufferSize);                             // Set the size of the file buffer. This must be called _before_ .begin.
   uint16_t getFileBufferSize(void);                                        // Return the size of the file buffer
@@ -829,6 +943,13 @@ public:
   uint16_t getMaxFileBufferAvail(void);                                    // Returns the maximum number of bytes which the file buffer has contained. Handy for checking the buffer is large enough to handle all the incoming data.
   void clearFileBuffer(void);                                              // Empty the file buffer - discard all contents
   void clearMaxFileBufferAvail(void);                                      // Reset fileBufferMaxAvail
+  uint32_t getFileBufferDropped(void);                                     // Returns the number of packets lost because the file buffer was full
+
+  // Zero-copy access to the file buffer. The waiting data may wrap around the end of the buffer, so it is returned as up to two spans.
+  // secondLength is zero if the data does not wrap. Returns the total number of bytes available.
+  // Call discardFileBufferData once the data has been written out.
+  uint16_t peekFileBuffer(const uint8_t **first, uint16_t *firstLength, const uint8_t **second, uint16_t *secondLength);
+  uint16_t discardFileBufferData(uint16_t numBytes); // Remove numBytes from the file buffer. Returns the number of bytes removed
 
   // Specific commands
 
@@ -944,6 +1065,7 @@ public:
   // UBX-CFG-NAVX5 - get/set the ackAiding byte. If ackAiding is 1, UBX-MGA-ACK messages will be sent by the module to acknowledge the MGA data
   uint8_t getAckAiding(uint16_t maxWait = defaultMaxWait);                 // Get the ackAiding byte - returns 255 if the sendCommand fails
   bool setAckAiding(uint8_t ackAiding, uint16_t maxWait = defaultMaxWait); // Set the ackAiding byte
+  bool setAckAidingAsync(uint8_t ackAiding, sfe_ublox_command_callback_t callback = NULL, uint16_t maxWait = defaultMaxWait); // Queue CFG-NAVSPG-ACKAIDING in RAM without waiting for the ACK
 
   // AssistNow Autonomous support
   // UBX-CFG-NAVX5 - get/set the aopCfg byte and set the aopOrdMaxErr word. If aopOrbMaxErr is 0 (default), the max orbit error is reset to the firmware default.
@@ -971,6 +1093,7 @@ public:
   uint32_t getVal32(uint32_t keyID, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait);                            // Returns the value at a given key location
   uint64_t getVal64(uint32_t keyID, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait);                            // Returns the value at a given key location
   uint8_t getVal8(uint16_t group, uint16_t id, uint8_t size, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait);   // Returns the value at a given group/id/size location
+  sfe_ublox_status_e getValN(const uint32_t *keys, uint8_t numKeys, uint64_t *values, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait); // Read up to 64 keys with a single UBX-CFG-VALGET. packetCfg must be large enough for the response
   uint16_t getVal16(uint16_t group, uint16_t id, uint8_t size, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait); // Returns the value at a given group/id/size location
   uint32_t getVal32(uint16_t group, uint16_t id, uint8_t size, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait); // Returns the value at a given group/id/size location
   uint64_t getVal64(uint16_t group, uint16_t id, uint8_t size, uint8_t layer = VAL_LAYER_RAM, uint16_t maxWait = defaultMaxWait); // Returns the value at a given group/id/size location
@@ -979,6 +1102,7 @@ public:
   uint8_t setVal16(uint32_t keyID, uint16_t value, uint8_t layer = VAL_LAYER_ALL, uint16_t maxWait = defaultMaxWait);             // Sets the 16-bit value at a given group/id/size location
   uint8_t setVal32(uint32_t keyID, uint32_t value, uint8_t layer = VAL_LAYER_ALL, uint16_t maxWait = defaultMaxWait);             // Sets the 32-bit value at a given group/id/size location
   uint8_t setVal64(uint32_t keyID, uint64_t value, uint8_t layer = VAL_LAYER_ALL, uint16_t maxWait = defaultMaxWait);             // Sets the 64-bit value at a given group/id/size location
+  uint8_t newCfgValset(uint8_t layer = VAL_LAYER_ALL);                                                                            // Define a new, empty UBX-CFG-VALSET
   uint8_t newCfgValset8(uint32_t keyID, uint8_t value, uint8_t layer = VAL_LAYER_ALL);                                            // Define a new UBX-CFG-VALSET with the given KeyID and 8-bit value
   uint8_t newCfgValset16(uint32_t keyID, uint16_t value, uint8_t layer = VAL_LAYER_ALL);                                          // Define a new UBX-CFG-VALSET with the given KeyID and 16-bit value
   uint8_t newCfgValset32(uint32_t keyID, uint32_t value, uint8_t layer = VAL_LAYER_ALL);                                          // Define a new UBX-CFG-VALSET with the given KeyID and 32-bit value
@@ -991,6 +1115,9 @@ public:
   uint8_t sendCfgValset16(uint32_t keyID, uint16_t value, uint16_t maxWait = defaultMaxWait);                                     // Add the final KeyID and 16-bit value to an existing UBX-CFG-VALSET ubxPacket and send it
   uint8_t sendCfgValset32(uint32_t keyID, uint32_t value, uint16_t maxWait = defaultMaxWait);                                     // Add the final KeyID and 32-bit value to an existing UBX-CFG-VALSET ubxPacket and send it
   uint8_t sendCfgValset64(uint32_t keyID, uint64_t value, uint16_t maxWait = defaultMaxWait);                                     // Add the final KeyID and 64-bit value to an existing UBX-CFG-VALSET ubxPacket and send it
+  uint8_t sendCfgValset(uint16_t maxWait = defaultMaxWait);                                                                       // Send the UBX-CFG-VALSET ubxPacket built with newCfgValset and addCfgValset
+  bool sendCfgValsetAsync(sfe_ublox_command_callback_t callback = NULL, uint16_t maxWait = defaultMaxWait);                       // Queue the UBX-CFG-VALSET ubxPacket and return without waiting for the ACK
+  uint8_t getCfgValsetLen(void) { return (packetCfg.len); }                                                                       // Return the payload length of the UBX-CFG-VALSET being built
 
   // get and set functions for all of the "automatic" message processing
 
@@ -1161,6 +1288,13 @@ public:
   bool assumeAutoNAVSAT(bool enabled, bool implicitUpdate = true);                                                    // In case no config access to the GPS is possible and NAVSAT is send cyclically already
   void flushNAVSAT();                                                                                                 // Mark all the NAVSAT data as read/stale
   void logNAVSAT(bool enabled = true);                                                                                // Log data to file buffer
+  // Streaming NAV SAT. The callback is called for each satellite block as soon as its 12 bytes arrive, before the message
+  // checksum can be checked. It is then called once with block NULL if the checksum is good, or with header and block both
+  // NULL if it is not, in which case the blocks must be discarded. Nothing is stored, so no RAM is allocated for the 255
+  // block message. If NAV SAT storage is also in use (setAutoNAVSAT...), the blocks are instead decoded from the stored
+  // message once it has been checked. The callback is called from checkUblox, not checkCallbacks. The output rate is not
+  // changed: set it with CFG-MSGOUT.
+  void setNAVSATblockCallbackPtr(void (*callbackPointerPtr)(const UBX_NAV_SAT_header_t *header, const UBX_NAV_SAT_block_t *block));
 
   bool getRELPOSNED(uint16_t maxWait = defaultMaxWait);                                                                        // Get Relative Positioning Information of the NED frame
   bool setAutoRELPOSNED(bool enabled, uint16_t maxWait = defaultMaxWait);                                                      // Enable/disable automatic RELPOSNED reports
@@ -1557,6 +1691,23 @@ public:
   UBX_RXM_SFRBX_t *packetUBXRXMSFRBX = NULL;                  // Pointer to struct. RAM will be allocated for this if/when necessary
   UBX_RXM_RAWX_t *packetUBXRXMRAWX = NULL;                    // Pointer to struct. RAM will be allocated for this if/when necessary
 
+#ifdef SFE_UBLOX_STATIC_BASE_MESSAGES
+  // Storage for the messages a base station always uses, placed with the object so they never touch the heap.
+  // The pointers above still select whether a message is enabled: they point here once the message is initialized
+  UBX_NAV_PVT_t staticUBXNAVPVT;
+  UBX_NAV_PVT_data_t staticUBXNAVPVTcallbackData;
+  UBX_NAV_HPPOSLLH_t staticUBXNAVHPPOSLLH;
+  UBX_NAV_HPPOSLLH_data_t staticUBXNAVHPPOSLLHcallbackData;
+  UBX_NAV_SVIN_t staticUBXNAVSVIN;
+  UBX_NAV_SVIN_data_t staticUBXNAVSVINcallbackData;
+  UBX_RXM_RAWX_t staticUBXRXMRAWX;
+  UBX_RXM_RAWX_data_t staticUBXRXMRAWXcallbackData;
+  uint8_t staticPayloadCfg[MAX_PAYLOAD_SIZE];
+  uint8_t staticFileBuffer[SFE_UBLOX_STATIC_FILE_BUFFER_SIZE];
+  uint8_t staticI2CRxBuffer[SFE_UBLOX_STATIC_I2C_BUFFER_SIZE];
+  uint8_t staticRTCMFrameBuffer[SFE_UBLOX_RTCM_MAX_FRAME_SIZE];
+#endif
+
   UBX_CFG_PRT_t *packetUBXCFGPRT = NULL;   // Pointer to struct. RAM will be allocated for this if/when necessary
   UBX_CFG_RATE_t *packetUBXCFGRATE = NULL; // Pointer to struct. RAM will be allocated for this if/when necessary
 
@@ -1587,6 +1738,24 @@ public:
 #endif
 
   uint16_t rtcmFrameCounter = 0; // Tracks the type of incoming byte inside RTCM frame
+  uint16_t rtcmLen = 0;          // Length of the incoming RTCM frame, including the header and CRC
+  uint8_t *rtcmFrameBuffer = NULL; // The incoming RTCM frame. RAM is allocated for this when the frame callback is set
+  rtcmFrameStats_t rtcmStats = {0, 0, 0};
+  void (*rtcmFrameCallbackPointerPtr)(const uint8_t *frame, uint16_t length, uint16_t messageNumber, uint32_t epoch) = NULL;
+  void (*messageMeterCallbackPointerPtr)(uint8_t cls, uint8_t id, uint16_t length) = NULL;
+  void (*navSatBlockCallbackPointerPtr)(const UBX_NAV_SAT_header_t *header, const UBX_NAV_SAT_block_t *block) = NULL;
+  bool navSatStreaming = false;             // The UBX frame being received is NAV SAT, decoded by streamNAVSAT as it arrives
+  UBX_NAV_SAT_header_t navSatStreamHeader;  // Header of the NAV SAT being streamed
+  uint8_t navSatStreamBytes[12];            // The header, then each block, as its bytes arrive
+
+  ubxQueuedCommand_t commandQueue[SFE_UBLOX_COMMAND_QUEUE_SIZE];
+  uint8_t commandPayloadPool[SFE_UBLOX_COMMAND_QUEUE_SIZE][SFE_UBLOX_COMMAND_PAYLOAD_SIZE]; // No heap allocation per command
+  uint8_t commandQueueHead = 0;                                     // The command being sent or waiting for its ACK
+  uint8_t commandQueueCount = 0;
+  uint32_t commandSequence = 0;                                     // Sequence number of the most recently queued command
+  uint32_t lastCompletedSequence = 0;                               // Sequence number and result of the most recently completed command
+  sfe_ublox_status_e lastCompletedStatus = SFE_UBLOX_STATUS_SUCCESS;
+  void checkCommandQueue(void);                                     // Send the next queued command, or complete the one in flight
 
 private:
   // Depending on the ubx binary response class, store binary responses into different places
@@ -1640,6 +1809,7 @@ private:
   bool initPacketUBXNAVTIMELS();        // Allocate RAM for packetUBXNAVTIMELS and initialize it
   bool initPacketUBXNAVSVIN();          // Allocate RAM for packetUBXNAVSVIN and initialize it
   bool initPacketUBXNAVSAT();           // Allocate RAM for packetUBXNAVSAT and initialize it
+  void streamNAVSAT(uint16_t offset, uint8_t incoming); // Decode one NAV SAT payload byte, calling the block callback for each whole block
   bool initPacketUBXNAVRELPOSNED();     // Allocate RAM for packetUBXNAVRELPOSNED and initialize it
   bool initPacketUBXNAVAOPSTATUS();     // Allocate RAM for packetUBXNAVAOPSTATUS and initialize it
   bool initPacketUBXNAVEOE();           // Allocate RAM for packetUBXNAVEOE and initialize it
@@ -1729,16 +1899,30 @@ private:
   uint8_t i2cPollingWaitNAV = 100; // We need to record the desired polling rate for standard nav messages
   uint8_t i2cPollingWaitHNR = 100; // and for HNR too so we can set i2cPollingWait to the lower of the two
 
-  // The SPI polling wait is a little different. checkUbloxSpi will delay for this amount before returning if
-  // there is no data waiting to be read. This prevents waitForACKResponse from pounding the SPI bus too hard.
-  uint8_t spiPollingWait = 9; // Default to 9ms; waitForACKResponse delays for 1ms on top of this. User can adjust with setSPIPollingWait.
+  // Once checkUbloxSpi finds the module has no data waiting, it does not read again for this long. This prevents
+  // waitForACKResponse and a busy loop from pounding the SPI bus too hard.
+  uint8_t spiPollingWait = 9; // Default to 9ms. User can adjust with setSPIPollingWait.
 
   unsigned long lastCheck = 0;
 
+  // Non-blocking navigation database read
+  bool navDBDReadInProgress = false;
+  uint8_t navDBDAckAiding = 0;       // ackAiding to restore when the read finishes
+  uint8_t navDBDI2cPollingWait = 0;  // i2cPollingWait to restore when the read finishes
+  uint32_t navDBDEntriesRX = 0;      // Database entries received so far
+
   uint16_t ubxFrameCounter; // Count all UBX frame bytes. [Fixed header(2bytes), CLS(1byte), ID(1byte), length(2bytes), payload(x bytes), checksums(2bytes)]
   uint8_t rollingChecksumA; // Rolls forward as we receive incoming bytes. Checked against the last two A/B checksum bytes
   uint8_t rollingChecksumB; // Rolls forward as we receive incoming bytes. Checked against the last two A/B checksum bytes
 
+  // processSpan's scanners, one per sentence type. Each returns how many bytes at data it has processed in bulk
+  typedef uint16_t (SFE_UBLOX_GNSS::*spanScanner_t)(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX);
+  static const spanScanner_t spanScanners[4]; // Indexed by currentSentence
+  uint16_t scanIdleSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX);
+  uint16_t scanNMEASpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX);
+  uint16_t scanUBXSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX);
+  uint16_t scanRTCMSpan(const uint8_t *data, uint16_t length, ubxPacket *incomingUBX);
+
   int8_t nmeaByteCounter; // Count all NMEA message bytes.
   // Abort NMEA message reception if nmeaByteCounter exceeds maxNMEAByteCount.
   // The user can adjust maxNMEAByteCount by calling setMaxNMEAByteCount
@@ -1769,12 +1953,31 @@ private:
   uint16_t fileBufferHead;                                      // The incoming byte is written into the file buffer at this location
   uint16_t fileBufferTail;                                      // The next byte to be read from the buffer will be read from this location
   uint16_t fileBufferMaxAvail = 0;                              // The maximum number of bytes the file buffer has contained. Handy for checking the buffer is large enough to handle all the incoming data.
+  uint32_t fileBufferDropped = 0;                               // The number of packets which did not fit in the file buffer
   bool createFileBuffer(void);                                  // Create the file buffer. Called by .begin
   uint16_t fileBufferSpaceAvailable(void);                      // Check how much space is available in the buffer
   uint16_t fileBufferSpaceUsed(void);                           // Check how much space is used in the buffer
   bool storePacket(ubxPacket *msg);                             // Add a UBX packet to the file buffer
   bool storeFileBytes(uint8_t *theBytes, uint16_t numBytes);    // Add theBytes to the file buffer
-  void writeToFileBuffer(uint8_t *theBytes, uint16_t numBytes); // Write theBytes to the file buffer
+  void writeToFileBuffer(const uint8_t *theBytes, uint16_t numBytes); // Write theBytes to the file buffer
+
+  // Support for buffered I2C reading
+  uint8_t *i2cRxBuffer = NULL;         // Pointer to the I2C read buffer. RAM is allocated for this if required in .begin
+  uint16_t i2cBufferSize = 0;          // The size of the I2C read buffer. This can be changed by calling setI2CBufferSize _before_ .begin
+  uint16_t i2cBufferHead = 0;          // The next byte read from the module is written here
+  uint16_t i2cBufferTail = 0;          // The next byte to be processed is read from here
+  uint16_t i2cBufferMaxAvail = 0;      // The maximum number of bytes the I2C buffer has contained
+  uint16_t i2cBytesPending = 0;        // Bytes the module reported as available which have not been read yet
+  uint16_t i2cReadBudget = 0;          // Max bytes to read per call. 0 = no limit
+  uint16_t processTimeBudget_us = 0;   // Max time to spend processing per call. 0 = no limit
+  int8_t i2cTxReadyPin = -1;           // Module TX-ready pin. -1 = poll on i2cPollingWait instead
+  bool i2cTxReadyActiveHigh = true;
+  uint32_t maxCheckStall_us = 0;       // Longest single check of the port
+  uint32_t busBytes = 0;               // Bytes clocked in from the module, on any port
+  uint32_t busTransactions = 0;        // Transactions made to collect them
+  bool createI2CBuffer(void);          // Create the I2C read buffer. Called by .begin
+  uint16_t i2cBufferSpaceUsed(void);   // Check how much of the I2C read buffer is in use
+  bool readI2CBytesAvailable(void);    // Read 0xFD/0xFE into i2cBytesPending
 
   // Support for platforms like ESP32 which do not support multiple I2C restarts
   // If _i2cStopRestart is true, endTransmission will always use a stop. If false, a restart will be used where needed.
@@ -0,0 +1,64 @@
+#include "checksum.h"
+
+static const uint32_t CRC24Q_POLYNOMIAL = 0x864CFB00; //0x1864CFB, shifted to the top of 32 bits
+
+//CRC tables, built at compile time. The CRC sits in the top 24 bits of a 32-bit register, so a byte is
+//folded in at the top and each table entry is what one byte contributes after passing 1 to 4 bytes
+struct CRC24QTables {
+  uint32_t table[4][256];
+
+  constexpr CRC24QTables() : table() {
+    for (uint32_t x = 0; x < 256; x++) {
+      uint32_t crc = x << 24;
+      for (uint8_t bit = 0; bit < 8; bit++)
+        crc = (crc & 0x80000000) ? (crc << 1) ^ CRC24Q_POLYNOMIAL : (crc << 1);
+      table[0][x] = crc;
+    }
+    for (uint8_t slice = 1; slice < 4; slice++)
+      for (uint32_t x = 0; x < 256; x++)
+        table[slice][x] = (table[slice - 1][x] << 8) ^ table[0][table[slice - 1][x] >> 24];
+  }
+};
+
+static constexpr CRC24QTables CRC24Q = CRC24QTables();
+
+//Four bytes per step. Over n bytes A gains the sum of the bytes, and B gains n times the old A plus each
+//byte weighted by how many sums it goes into. 32-bit sums wrap at a multiple of 256, so the low byte is exact
+void fletcher8(const uint8_t* data, size_t length, uint8_t& checksumA, uint8_t& checksumB) {
+  uint32_t a = checksumA;
+  uint32_t b = checksumB;
+
+  while (length >= 4) {
+    uint32_t d0 = data[0], d1 = data[1], d2 = data[2], d3 = data[3];
+    b += 4 * a + 4 * d0 + 3 * d1 + 2 * d2 + d3;
+    a += d0 + d1 + d2 + d3;
+    data += 4;
+    length -= 4;
+  }
+  while (length > 0) {
+    a += *data++;
+    b += a;
+    length--;
+  }
+
+  checksumA = (uint8_t)a;
+  checksumB = (uint8_t)b;
+}
+
+uint32_t crc24q(const uint8_t* data, size_t length, uint32_t crc) {
+  crc <<= 8; //Top 24 bits
+
+  while (length >= 4) {
+    crc ^= ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    crc = CRC24Q.table[3][crc >> 24] ^ CRC24Q.table[2][(crc >> 16) & 0xFF]
+          ^ CRC24Q.table[1][(crc >> 8) & 0xFF] ^ CRC24Q.table[0][crc & 0xFF];
+    data += 4;
+    length -= 4;
+  }
+  while (length > 0) {
+    crc = (crc << 8) ^ CRC24Q.table[0][(crc >> 24) ^ *data++];
+    length--;
+  }
+
+  return (crc >> 8);
+}
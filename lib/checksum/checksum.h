@@ -0,0 +1,17 @@
+//Checksums for the two protocols the base handles: the 8-bit Fletcher checksum on UBX messages and the
+//CRC-24Q on RTCM 3 frames. Both carry on from a previous result, so a message can be checked in pieces.
+//They work on several bytes per step. The Fletcher sums are kept in 32 bits and folded back to 8 at the
+//end, and the CRC uses four tables so a whole 32-bit word goes through in one step (slice-by-4).
+
+#ifndef _CHECKSUM_H_
+#define _CHECKSUM_H_
+
+#include <Arduino.h>
+
+//Add data to the UBX checksum in checksumA and checksumB. Start both from 0
+void fletcher8(const uint8_t* data, size_t length, uint8_t& checksumA, uint8_t& checksumB);
+
+//CRC-24Q of data, carrying on from crc. Start from 0
+uint32_t crc24q(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+#endif
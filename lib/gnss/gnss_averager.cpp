@@ -0,0 +1,115 @@
+#include "gnss_averager.h"
+#include "gnss_geodesy.h"
+
+GNSSAverager* GNSSAverager::_instance = nullptr;
+
+static const uint64_t GATE_WARMUP_SAMPLES = 100; //Too few samples for a meaningful scatter before this
+static const double   GATE_SIGMAS = 5.0;         //Reject samples further than this many sigma from the mean
+static const uint8_t  FIX_3D = 3;
+static const uint8_t  FIX_TIME = 5;
+
+bool GNSSAverager::begin(SFE_UBLOX_GNSS& gnss, GNSSTelemetry& telemetry) {
+  _telemetry = &telemetry;
+  _instance = this;
+  reset();
+  return (gnss.setAutoNAVHPPOSECEFcallbackPtr(&_hpposecefCallback));
+}
+
+void GNSSAverager::reset() {
+  _state = {};
+  _state.version = AVERAGER_STATE_VERSION;
+}
+
+bool GNSSAverager::restore(const AveragerState& state) {
+  if (state.version != AVERAGER_STATE_VERSION)
+    return (false);
+  _state = state;
+  return (true);
+}
+
+//Only 3D (or GNSS + dead reckoning) fixes with a good accuracy estimate go in. Once there are enough
+//samples, anything much further from the mean than the scatter, or than its own accuracy, is an outlier
+bool GNSSAverager::addSample(int64_t x, int64_t y, int64_t z, uint32_t pAcc, uint8_t fixType) {
+  if ((fixType != FIX_3D && fixType != FIX_3D + 1) || pAcc > _maxAccuracy_mm * 10) {
+    _state.rejected++;
+    return (false);
+  }
+
+  if (_state.count == 0) {
+    _state.originX = x;
+    _state.originY = y;
+    _state.originZ = z;
+  }
+
+  double dx = (x - _state.originX) * 0.0001; //m
+  double dy = (y - _state.originY) * 0.0001;
+  double dz = (z - _state.originZ) * 0.0001;
+
+  if (_state.count >= GATE_WARMUP_SAMPLES) {
+    double ex = dx - _state.meanX;
+    double ey = dy - _state.meanY;
+    double ez = dz - _state.meanZ;
+    double gate = max(GATE_SIGMAS * sigma_m(), 3.0 * pAcc * 0.0001);
+    if (ex * ex + ey * ey + ez * ez > gate * gate) {
+      _state.rejected++;
+      return (false);
+    }
+  }
+
+  _state.count++;
+  double n = (double)_state.count;
+
+  double delta = dx - _state.meanX;
+  _state.meanX += delta / n;
+  _state.m2X += delta * (dx - _state.meanX);
+
+  delta = dy - _state.meanY;
+  _state.meanY += delta / n;
+  _state.m2Y += delta * (dy - _state.meanY);
+
+  delta = dz - _state.meanZ;
+  _state.meanZ += delta / n;
+  _state.m2Z += delta * (dz - _state.meanZ);
+  return (true);
+}
+
+float GNSSAverager::sigma_m() {
+  if (_state.count < 2)
+    return (0);
+  return (sqrt((_state.m2X + _state.m2Y + _state.m2Z) / (double)(_state.count - 1)));
+}
+
+bool GNSSAverager::meanECEF(double& x, double& y, double& z) {
+  if (_state.count == 0)
+    return (false);
+  x = _state.originX * 0.0001 + _state.meanX;
+  y = _state.originY * 0.0001 + _state.meanY;
+  z = _state.originZ * 0.0001 + _state.meanZ;
+  return (true);
+}
+
+bool GNSSAverager::meanLLH(double& lat_deg, double& lon_deg, double& height_m) {
+  double x, y, z;
+  if (!meanECEF(x, y, z))
+    return (false);
+  ecefToLLH(x, y, z, lat_deg, lon_deg, height_m);
+  return (true);
+}
+
+void GNSSAverager::_hpposecefCallback(UBX_NAV_HPPOSECEF_data_t* data) {
+  GNSSAverager* averager = _instance;
+  if (data->flags.bits.invalidEcef) {
+    averager->_state.rejected++;
+    return;
+  }
+
+  //Fixed mode: the position is the configured one, not a measurement
+  uint8_t fixType = averager->_telemetry->snapshot().fixType;
+  if (fixType == FIX_TIME)
+    return;
+
+  int64_t x = (int64_t)data->ecefX * 100 + data->ecefXHp; //mm * 0.1
+  int64_t y = (int64_t)data->ecefY * 100 + data->ecefYHp;
+  int64_t z = (int64_t)data->ecefZ * 100 + data->ecefZHp;
+  averager->addSample(x, y, z, data->pAcc, fixType);
+}
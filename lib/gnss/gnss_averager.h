@@ -0,0 +1,58 @@
+//The GNSSAverager builds a long-term mean of the receiver's position for a permanent base. Each accepted
+//HPPOSECEF sample is folded into a Welford accumulator: the first sample is kept as an integer origin in
+//0.1mm, and the running mean and sum of squared differences are kept in double meters relative to it.
+//Memory stays constant however many samples go in, and the precision does not degrade as the count grows.
+//The accumulator is plain data, so it can be checkpointed to flash and restored to carry on over reboots.
+//Samples only come from navigation fixes (3D, or GNSS + dead reckoning), which the receiver makes in survey-in and
+//in BaseMode::AVERAGE, the mode for building the average. In fixed mode it reports time-only fixes (fixType 5) at
+//the configured position, which would only pull the mean towards it, so they are skipped without being counted.
+
+#ifndef _GNSS_AVERAGER_H_
+#define _GNSS_AVERAGER_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include "gnss_telemetry.h"
+
+const uint32_t AVERAGER_STATE_VERSION = 1;
+
+//Accumulator state. Written to and read from flash as it is
+struct AveragerState {
+  uint32_t version;
+  int64_t  originX, originY, originZ; //ECEF of the first sample: mm * 0.1
+  uint64_t count;                     //Samples accepted
+  uint64_t rejected;                  //Samples rejected as outliers
+  double   meanX, meanY, meanZ;       //Mean relative to the origin: m
+  double   m2X, m2Y, m2Z;             //Sums of squared differences from the mean: m^2
+};
+
+class GNSSAverager {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss, GNSSTelemetry& telemetry);
+  void reset();
+
+  //Add one position. Returns false if it was rejected
+  bool addSample(int64_t x, int64_t y, int64_t z, uint32_t pAcc, uint8_t fixType); //mm * 0.1
+
+  uint64_t count() { return _state.count; }
+  uint64_t rejected() { return _state.rejected; }
+  float    sigma_m();                                   //3D scatter of the samples
+  bool     meanECEF(double& x, double& y, double& z);   //m. False until there are samples
+  bool     meanLLH(double& lat_deg, double& lon_deg, double& height_m);
+
+  uint32_t maxAccuracy_mm() { return _maxAccuracy_mm; }
+  void     maxAccuracy_mm(uint32_t accuracy) { _maxAccuracy_mm = accuracy; }
+
+  const AveragerState& state() { return _state; }
+  bool restore(const AveragerState& state);
+
+private:
+  static void _hpposecefCallback(UBX_NAV_HPPOSECEF_data_t* data);
+  static GNSSAverager* _instance; //The SparkFun callbacks carry no context
+
+  GNSSTelemetry* _telemetry = nullptr;
+  AveragerState _state = {};
+  uint32_t _maxAccuracy_mm = 500; //Samples less accurate than this are ignored
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "gnss_base_mode.h"
+#include "gnss_geodesy.h"
+
+GNSSBaseMode* GNSSBaseMode::_instance = nullptr;
+
+static const uint16_t RTCM_STATION_POSITION = 1005;
+
+//Deliver NAV-SVIN through a callback. Its output rate is set with the rest of the receiver configuration
+bool GNSSBaseMode::begin(SFE_UBLOX_GNSS& gnss, GNSSSettings& settings) {
+  _settings = &settings;
+  _instance = this;
+  return (gnss.setAutoNAVSVINcallbackPtr(&_svinCallback));
+}
+
+bool GNSSBaseMode::update() {
+  if (!_surveyComplete || !surveying())
+    return (false);
+  _surveyComplete = false;
+
+  double x = _meanX * 0.01 + _meanXHP * 0.0001; //m
+  double y = _meanY * 0.01 + _meanYHP * 0.0001;
+  double z = _meanZ * 0.01 + _meanZHP * 0.0001;
+  double lat, lon, height;
+  ecefToLLH(x, y, z, lat, lon, height);
+
+  _settings->position(lat, lon, height);
+  _settings->baseMode(BaseMode::FIXED);
+  Serial.printf("Survey-in complete after %lus, accuracy %.3fm, %lu observations\r\n",
+                _survey.duration_s, _survey.meanAcc / 10000.0, _survey.observations);
+  return (true);
+}
+
+void GNSSBaseMode::rtcmReceived(uint16_t messageNumber) {
+  if (_firstRTCM_ms != 0 || messageNumber != RTCM_STATION_POSITION)
+    return;
+  _firstRTCM_ms = millis();
+  Serial.printf("First RTCM station position %lums after power up\r\n", _firstRTCM_ms);
+}
+
+void GNSSBaseMode::_svinCallback(UBX_NAV_SVIN_data_t* data) {
+  GNSSBaseMode* base = _instance;
+  base->_survey.active = data->active;
+  base->_survey.valid = data->valid;
+  base->_survey.duration_s = data->dur;
+  base->_survey.meanAcc = data->meanAcc;
+  base->_survey.observations = data->obs;
+
+  if (data->valid && !data->active) {
+    base->_meanX = data->meanX;
+    base->_meanY = data->meanY;
+    base->_meanZ = data->meanZ;
+    base->_meanXHP = data->meanXHP;
+    base->_meanYHP = data->meanYHP;
+    base->_meanZHP = data->meanZHP;
+    base->_surveyComplete = true;
+  }
+}
@@ -0,0 +1,48 @@
+//The GNSSBaseMode manager gets the receiver transmitting corrections from a known position. Until a
+//position has been stored it watches the receiver's survey-in through NAV-SVIN. Once the survey is valid
+//the mean is stored in GNSSSettings and the base switches to fixed mode, which later boots load straight
+//away, so RTCM 1005 and observations follow within seconds of the first fix.
+
+#ifndef _GNSS_BASE_MODE_H_
+#define _GNSS_BASE_MODE_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include "gnss_settings.h"
+
+//Latest survey-in progress
+struct SurveyStatus {
+  bool     active;       //Survey-in is running
+  bool     valid;        //The mean position meets the time and accuracy limits
+  uint32_t duration_s;   //Time surveyed so far
+  uint32_t meanAcc;      //Accuracy of the mean position: mm * 0.1
+  uint32_t observations; //Positions used
+};
+
+class GNSSBaseMode {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss, GNSSSettings& settings);
+  //Returns true once, when survey-in has finished and the position has been stored in the settings
+  bool update();
+  //Called for each RTCM frame from the receiver, to time the first corrections
+  void rtcmReceived(uint16_t messageNumber);
+
+  bool surveying() { return _settings != nullptr && _settings->baseMode() == BaseMode::SURVEY_IN; }
+  bool averaging() { return _settings != nullptr && _settings->baseMode() == BaseMode::AVERAGE; }
+  const SurveyStatus& survey() { return _survey; }
+  bool correctionsStarted() { return _firstRTCM_ms != 0; }
+  uint32_t timeToFirstRTCM_ms() { return _firstRTCM_ms; } //From power up to the first station position message
+
+private:
+  static void _svinCallback(UBX_NAV_SVIN_data_t* data);
+  static GNSSBaseMode* _instance; //The SparkFun callbacks carry no context
+
+  GNSSSettings* _settings = nullptr;
+  SurveyStatus _survey = {};
+  int32_t  _meanX, _meanY, _meanZ;       //cm
+  int8_t   _meanXHP, _meanYHP, _meanZHP; //mm * 0.1
+  bool     _surveyComplete = false;
+  uint32_t _firstRTCM_ms = 0;
+};
+
+#endif
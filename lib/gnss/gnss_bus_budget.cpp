@@ -0,0 +1,130 @@
+#include "gnss_bus_budget.h"
+
+GNSSBusBudget* GNSSBusBudget::_instance = nullptr;
+
+static const uint32_t WINDOW_MS = 1000;
+static const float DERATE_ABOVE = 0.70;   //Busier than this leaves too little room for a burst of RTCM or RAWX
+static const float RESTORE_BELOW = 0.55;
+static const uint8_t BUSY_WINDOWS = 2;    //Windows over the limit before derating
+static const uint8_t QUIET_WINDOWS = 10;  //Windows with room to spare before restoring
+static const uint8_t SETTLE_WINDOWS = 2;  //For the receiver to apply a new rate
+
+static const char* GROUP_NAMES[] = { "RTCM", "Raw", "UI", "Sky", "Other" };
+
+const char* busGroupName(BusGroup group) {
+  return (GROUP_NAMES[(uint8_t)group]);
+}
+
+static BusGroup groupOf(uint8_t cls, uint8_t id) {
+  if (cls == 0xF5)
+    return (BusGroup::RTCM);
+  if (cls == UBX_CLASS_RXM && (id == UBX_RXM_RAWX || id == UBX_RXM_SFRBX))
+    return (BusGroup::RAW);
+  if (cls == UBX_CLASS_NAV && (id == UBX_NAV_PVT || id == UBX_NAV_HPPOSLLH || id == UBX_NAV_STATUS))
+    return (BusGroup::UI);
+  if (cls == UBX_CLASS_NAV && id == UBX_NAV_SAT)
+    return (BusGroup::SKY);
+  return (BusGroup::OTHER);
+}
+
+bool GNSSBusBudget::begin(SFE_UBLOX_GNSS& gnss, GNSSTransport& transport) {
+  _gnss = &gnss;
+  _instance = this;
+  _transport = &transport;
+  _lastBusBytes = _gnss->getBusBytes();
+  _lastTransactions = _gnss->getBusTransactions();
+  _gnss->setMessageMeterCallbackPtr(&_meterCallback);
+  _window = 0;
+  return (true);
+}
+
+//Called from the parser for each complete message
+void GNSSBusBudget::_meterCallback(uint8_t cls, uint8_t id, uint16_t length) {
+  GNSSBusBudget* budget = _instance;
+  budget->_groupBytes[(uint8_t)groupOf(cls, id)] += length;
+
+  BusMessage* message = nullptr;
+  for (uint8_t x = 0; x < budget->_messageCount; x++)
+    if (budget->_messages[x].cls == cls && budget->_messages[x].id == id) {
+      message = &budget->_messages[x];
+      break;
+    }
+  if (message == nullptr) {
+    if (budget->_messageCount == BUS_MAX_MESSAGES)
+      return;
+    message = &budget->_messages[budget->_messageCount++];
+    message->cls = cls;
+    message->id = id;
+  }
+  message->bytes += length;
+  message->count++;
+  message->windowBytes += length;
+}
+
+//Work out the last window's bus time, then derate the UI messages while the bus stays busy and restore them
+//once there is room for twice their traffic
+bool GNSSBusBudget::update() {
+  if (_gnss == nullptr || _window < WINDOW_MS)
+    return (false);
+  float seconds = _window / 1000.0;
+  _window = 0;
+
+  uint32_t busBytes = _gnss->getBusBytes();
+  uint32_t transactions = _gnss->getBusTransactions();
+  float byteClocks = _transport->byteClocks();
+  float clocks = (busBytes - _lastBusBytes) * byteClocks + (transactions - _lastTransactions) * _transport->transactionClocks();
+  _lastBusBytes = busBytes;
+  _lastTransactions = transactions;
+
+  float busClocks = _transport->clock_Hz() * seconds;
+  _usage.utilisation = clocks / busClocks;
+  _usage.bytesPerSecond = 0;
+  float metered = 0;
+  for (uint8_t x = 0; x < (uint8_t)BusGroup::COUNT; x++) {
+    _usage.group[x] = _groupBytes[x] * byteClocks / busClocks;
+    _usage.bytesPerSecond += _groupBytes[x] / seconds;
+    metered += _usage.group[x];
+    _groupBytes[x] = 0;
+  }
+  _usage.overhead = max(_usage.utilisation - metered, 0.0f);
+  for (uint8_t x = 0; x < _messageCount; x++) {
+    _messages[x].rate_Bps = _messages[x].windowBytes / seconds;
+    _messages[x].windowBytes = 0;
+  }
+
+  if (_settleWindows > 0) {
+    _settleWindows--;
+    return (false);
+  }
+
+  _busyWindows = (_usage.utilisation > DERATE_ABOVE) ? _busyWindows + 1 : 0;
+  float restored = _usage.utilisation + _usage.group[(uint8_t)BusGroup::UI];
+  _quietWindows = (_derate > 0 && restored < RESTORE_BELOW) ? _quietWindows + 1 : 0;
+
+  uint8_t derate = _derate;
+  if (_busyWindows >= BUSY_WINDOWS && _derate < BUS_MAX_DERATE)
+    _derate++;
+  else if (_quietWindows >= QUIET_WINDOWS)
+    _derate--;
+  if (_derate == derate)
+    return (false);
+
+  _busyWindows = 0;
+  _quietWindows = 0;
+  _settleWindows = SETTLE_WINDOWS;
+  _derateChanges++;
+  return (true);
+}
+
+void GNSSBusBudget::printStatus(Print& out) {
+  out.printf("%s bus %.0f%% of %lu kHz, %lu B/s:", _transport->name(), _usage.utilisation * 100.0, _transport->clock_Hz() / 1000,
+             _usage.bytesPerSecond);
+  for (uint8_t x = 0; x < (uint8_t)BusGroup::COUNT; x++)
+    out.printf(" %s %.0f%%", GROUP_NAMES[x], _usage.group[x] * 100.0);
+  out.printf(" overhead %.0f%%, UI every %u epochs, %lu rate changes, longest check %lu us\r\n", _usage.overhead * 100.0,
+             uiInterval(), _derateChanges, _gnss->getMaxCheckStall());
+  for (uint8_t x = 0; x < _messageCount; x++)
+    out.printf("  %02X-%02X %s: %.0f B/s, %lu messages, %lu bytes\r\n", _messages[x].cls, _messages[x].id,
+               GROUP_NAMES[(uint8_t)groupOf(_messages[x].cls, _messages[x].id)], _messages[x].rate_Bps,
+               _messages[x].count, _messages[x].bytes);
+}
@@ -0,0 +1,83 @@
+//The GNSSBusBudget meters what crosses the bus from the receiver and keeps it within what the bus can carry.
+//The parser reports every UBX packet and RTCM frame, which are summed per class and ID, and per group, over
+//one-second windows. Bus time comes from the bytes and transactions of the reads, at the clocks each takes on the
+//transport's port: on I2C 9 a byte, plus start and stop. Whatever bus time no message accounts for, addresses,
+//polls, idle SPI bytes and anything unparsed, is overhead.
+//When the bus stays busy, the messages that only feed the UI (NAV-PVT, NAV-HPPOSLLH and NAV-STATUS) are derated
+//a step at a time, halving their rate, so RTCM and the raw log keep their bandwidth. A step is undone once the bus
+//would stay under the limit with it back.
+
+#ifndef _GNSS_BUS_BUDGET_H_
+#define _GNSS_BUS_BUDGET_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include "gnss_transport.h"
+
+enum class BusGroup : uint8_t {
+  RTCM,
+  RAW,    //RXM-RAWX, RXM-SFRBX
+  UI,     //NAV-PVT, NAV-HPPOSLLH, NAV-STATUS
+  SKY,    //NAV-SAT
+  OTHER,
+  COUNT
+};
+
+const char* busGroupName(BusGroup group);
+
+const uint8_t BUS_MAX_MESSAGES = 24; //Class and ID pairs metered
+const uint8_t BUS_MAX_DERATE = 2;    //UI every 4th epoch at most. The clock needs a snapshot within 400ms of each pulse
+
+//Bytes of one class and ID
+struct BusMessage {
+  uint8_t  cls;
+  uint8_t  id;
+  uint32_t bytes;       //Since begin
+  uint32_t count;
+  uint32_t windowBytes;
+  float    rate_Bps;    //Last window
+};
+
+//Last window, as fractions of the bus time
+struct BusUsage {
+  float    utilisation;
+  float    group[(uint8_t)BusGroup::COUNT];
+  float    overhead;
+  uint32_t bytesPerSecond;
+};
+
+class GNSSBusBudget {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss, GNSSTransport& transport);
+
+  //Close a window once a second. Returns true when the derating has changed, and the receiver needs reconfiguring
+  bool update();
+
+  uint8_t derate() { return _derate; }
+  uint8_t uiInterval() { return (1 << _derate); } //Navigation epochs between UI messages
+  const BusUsage& usage() { return _usage; }
+  const BusMessage* messages() { return _messages; }
+  uint8_t messageCount() { return _messageCount; }
+  void printStatus(Print& out);
+
+private:
+  static void _meterCallback(uint8_t cls, uint8_t id, uint16_t length);
+  static GNSSBusBudget* _instance; //The SparkFun callbacks carry no context
+
+  SFE_UBLOX_GNSS* _gnss = nullptr;
+  GNSSTransport* _transport = nullptr;
+  BusMessage _messages[BUS_MAX_MESSAGES] = {};
+  uint8_t _messageCount = 0;
+  uint32_t _groupBytes[(uint8_t)BusGroup::COUNT] = {}; //This window
+  uint32_t _lastBusBytes = 0;
+  uint32_t _lastTransactions = 0;
+  BusUsage _usage = {};
+  uint8_t _derate = 0;
+  uint8_t _busyWindows = 0;
+  uint8_t _quietWindows = 0;
+  uint8_t _settleWindows = 0;  //Windows left before a new rate shows on the bus
+  uint32_t _derateChanges = 0;
+  elapsedMillis _window = 0;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "gnss_clock.h"
+
+GNSSClock* GNSSClock::_instance = nullptr;
+
+static const int64_t WEEK_MS = 604800000;
+static const uint32_t LABEL_MAX_AGE_MS = 400; //The snapshot must place the pulse well within half a second
+static const float CLOCK_MAX_PPM = 100.0;     //A +/-20ppm crystal plus margin. Anything larger is a missed or false pulse
+static const float CLOCK_ACQUIRE_GAIN = 0.5;
+static const float CLOCK_TRACK_GAIN = 0.125;
+static const uint8_t CLOCK_ACQUIRE_PULSES = 4;
+static const uint16_t HOLDOVER_MAX_S = 60;    //A 1ppm rate error is 60us after a minute
+
+static uint32_t wrapTow(int64_t tow_ms) {
+  tow_ms %= WEEK_MS;
+  if (tow_ms < 0)
+    tow_ms += WEEK_MS;
+  return ((uint32_t)tow_ms);
+}
+
+//The time pulse must be enabled and on the GPS time grid, which configureGNSS does
+void GNSSClock::begin(GNSSTelemetry& telemetry, uint8_t ppsPin) {
+  _telemetry = &telemetry;
+  _instance = this;
+  _cyclesPerSecond = F_CPU_ACTUAL;
+  _nsPerCycle = 1000000000.0 / _cyclesPerSecond;
+
+  pinMode(ppsPin, INPUT);
+  attachInterrupt(digitalPinToInterrupt(ppsPin), _ppsISR, RISING);
+}
+
+//Read the cycle counter before anything else, so the ISR entry time is the only latency
+void GNSSClock::_ppsISR() {
+  uint32_t cycles = ARM_DWT_CYCCNT;
+  _instance->_ppsCycles = cycles;
+  _instance->_ppsCount++;
+}
+
+void GNSSClock::update() {
+  noInterrupts();
+  uint32_t count = _ppsCount;
+  uint32_t cycles = _ppsCycles;
+  interrupts();
+
+  if (count != _ppsSeen) {
+    _ppsSeen = count;
+    _pulse(cycles);
+  }
+  _holdover();
+}
+
+//Label the pulse with its GPS second, check it against the prediction from the last anchor, then track the rate
+void GNSSClock::_pulse(uint32_t cycles) {
+  const GNSSSnapshot& nav = _telemetry->snapshot();
+  uint32_t age_ms = _telemetry->snapshotAge_ms();
+  if (!nav.valid || nav.fixType < 2 || age_ms > LABEL_MAX_AGE_MS) {
+    _stats.rejected++;
+    return;
+  }
+  int32_t sincePulse_ms = (int32_t)(ARM_DWT_CYCCNT - cycles) / (int32_t)(F_CPU_ACTUAL / 1000);
+  uint32_t coarse_ms = wrapTow((int64_t)nav.iTOW + age_ms - sincePulse_ms);
+  uint32_t tow_ms = wrapTow((coarse_ms + 500) / 1000 * 1000);
+
+  if (!_valid) {
+    _anchor(cycles, tow_ms);
+    _stats.pulses++;
+    return;
+  }
+
+  int32_t elapsed = cycles - _anchorCycles;
+  int32_t seconds = lround(elapsed / _cyclesPerSecond);
+  int32_t residual = cycles - (_anchorCycles + (uint32_t)lround(seconds * _cyclesPerSecond));
+  float residual_ns = residual * _nsPerCycle;
+  if (seconds <= 0 || wrapTow((int64_t)_anchorTow_ms + seconds * 1000) != tow_ms ||
+      fabs(residual_ns) > seconds * CLOCK_MAX_PPM * 1000.0) {
+    //Either this pulse or the anchor is wrong. Start again from this one
+    _stats.rejected++;
+    _anchor(cycles, tow_ms);
+    return;
+  }
+
+  _stats.pulses++;
+  _stats.compared++;
+  _stats.residualSum_ns += residual_ns;
+  _stats.residualSqSum_ns2 += residual_ns * residual_ns;
+  if (fabs(residual_ns) > _stats.residualMax_ns)
+    _stats.residualMax_ns = fabs(residual_ns);
+
+  //The counter wraps every 7s, so the rate is only measured over shorter gaps
+  uint32_t interval_ms = wrapTow((int64_t)tow_ms - _pulseTow_ms);
+  if (interval_ms > 0 && interval_ms <= 5000) {
+    double measured = (uint32_t)(cycles - _pulseCycles) * 1000.0 / interval_ms;
+    float gain = (_stats.pulses <= CLOCK_ACQUIRE_PULSES) ? CLOCK_ACQUIRE_GAIN : CLOCK_TRACK_GAIN;
+    _cyclesPerSecond += gain * (measured - _cyclesPerSecond);
+    _nsPerCycle = 1000000000.0 / _cyclesPerSecond;
+  }
+  _anchor(cycles, tow_ms);
+}
+
+void GNSSClock::_anchor(uint32_t cycles, uint32_t tow_ms) {
+  _anchorCycles = cycles;
+  _anchorTow_ms = tow_ms;
+  _pulseCycles = cycles;
+  _pulseTow_ms = tow_ms;
+  _holdover_s = 0;
+  _valid = true;
+}
+
+//With no pulse, move the anchor on a predicted second at a time so the cycle count from it never wraps
+void GNSSClock::_holdover() {
+  if (!_valid)
+    return;
+  if ((int32_t)(ARM_DWT_CYCCNT - _anchorCycles) < 2 * _cyclesPerSecond)
+    return;
+
+  _anchorCycles += lround(_cyclesPerSecond);
+  _anchorTow_ms = wrapTow((int64_t)_anchorTow_ms + 1000);
+  _stats.holdover_s++;
+  if (++_holdover_s > HOLDOVER_MAX_S)
+    _valid = false;
+}
+
+//Cycle counts up to a couple of seconds either side of the anchor convert correctly
+GNSSTime GNSSClock::toGnss(uint32_t cycles) {
+  GNSSTime time = {};
+  if (!_valid)
+    return (time);
+
+  int32_t delta = cycles - _anchorCycles;
+  int64_t tow_ns = (int64_t)_anchorTow_ms * 1000000 + llround(delta * _nsPerCycle);
+  int64_t week_ns = WEEK_MS * 1000000;
+  tow_ns = ((tow_ns % week_ns) + week_ns) % week_ns;
+  time.valid = true;
+  time.tow_ms = tow_ns / 1000000;
+  time.sub_ns = tow_ns % 1000000;
+  return (time);
+}
+
+int32_t GNSSClock::age_us(uint32_t tow_ms) {
+  GNSSTime now = nowGnss();
+  if (!now.valid)
+    return (0);
+
+  int64_t age_ms = (int64_t)now.tow_ms - tow_ms;
+  if (age_ms < -WEEK_MS / 2)
+    age_ms += WEEK_MS;
+  else if (age_ms > WEEK_MS / 2)
+    age_ms -= WEEK_MS;
+  return (age_ms * 1000 + now.sub_ns / 1000);
+}
+
+int32_t GNSSClock::stamp(uint32_t tow_ms) {
+  if (!_valid)
+    return (0);
+
+  int32_t age = age_us(tow_ms);
+  float age_ms = age / 1000.0;
+  _stats.latencySamples++;
+  _stats.latencySum_ms += age_ms;
+  if (age_ms > _stats.latencyMax_ms)
+    _stats.latencyMax_ms = age_ms;
+  return (age);
+}
+
+//Print the rate offset and its drift since the last report, the pulse residuals and the stamped latencies
+void GNSSClock::printStatus(Print& out) {
+  float mean = 0;
+  float rms = 0;
+  if (_stats.compared > 0) {
+    mean = _stats.residualSum_ns / _stats.compared;
+    rms = sqrt(_stats.residualSqSum_ns2 / _stats.compared);
+  }
+  float offset = offset_ppm();
+  out.printf("GNSS clock %s, offset %.3f ppm, drift %+.3f ppm, pulse residual mean %.0f ns, RMS %.0f ns, max %.0f ns, "
+             "%lu pulses, %lu rejected, %lu s holdover\r\n",
+             locked() ? "locked" : (_valid ? "holdover" : "free running"), offset, offset - _reportOffset_ppm,
+             mean, rms, _stats.residualMax_ns, _stats.pulses, _stats.rejected, _stats.holdover_s);
+  _reportOffset_ppm = offset;
+
+  if (_stats.latencySamples > 0)
+    out.printf("RTCM latency mean %.1f ms, max %.1f ms, %lu frames\r\n",
+               _stats.latencySum_ms / _stats.latencySamples, _stats.latencyMax_ms, _stats.latencySamples);
+}
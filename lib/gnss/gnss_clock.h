@@ -0,0 +1,75 @@
+//The GNSSClock disciplines the Teensy cycle counter to GNSS time. The receiver's time pulse marks the top of
+//each GPS second on a pin, and its interrupt records the cycle counter. The pulse is labelled with its GPS
+//second from the NAV-PVT time in the telemetry snapshot and becomes the anchor for nowGnss(). The counter's
+//rate is measured from the pulse intervals, so time between pulses, and through short gaps in them, is
+//interpolated at the crystal's actual rate rather than its nominal 600MHz.
+
+#ifndef _GNSS_CLOCK_H_
+#define _GNSS_CLOCK_H_
+
+#include <Arduino.h>
+#include "gnss_telemetry.h"
+
+struct GNSSTime {
+  bool     valid;  //False until the first pulse, and once holdover has run too long
+  uint32_t tow_ms; //GPS time of week: ms
+  uint32_t sub_ns; //Time past tow_ms: ns
+};
+
+struct ClockStats {
+  uint32_t pulses;            //Pulses the clock was disciplined with
+  uint32_t rejected;          //Pulses with no GNSS time to label them, or too far from the prediction
+  uint32_t holdover_s;        //Seconds run on the rate estimate alone
+  uint32_t compared;          //Pulses checked against the prediction, which the residuals are over
+  float    residualSum_ns;    //Pulse arrival against the time predicted from the previous anchor
+  float    residualSqSum_ns2;
+  float    residualMax_ns;
+  uint32_t latencySamples;    //Events stamped against the GNSS time they refer to
+  float    latencySum_ms;
+  float    latencyMax_ms;
+};
+
+class GNSSClock {
+public:
+  void begin(GNSSTelemetry& telemetry, uint8_t ppsPin);
+  void update();
+
+  //GNSS time now, or of a cycle count captured up to a second or so earlier, for example in an ISR
+  GNSSTime nowGnss() { return toGnss(ARM_DWT_CYCCNT); }
+  GNSSTime toGnss(uint32_t cycles);
+
+  //Time from a GNSS time of week, such as an RTCM epoch, to now: us. Stamps also go into the latency statistics
+  int32_t age_us(uint32_t tow_ms);
+  int32_t stamp(uint32_t tow_ms);
+
+  bool locked() { return _valid && _holdover_s == 0; }
+  float offset_ppm() { return (_cyclesPerSecond / F_CPU_ACTUAL - 1.0) * 1000000.0; }
+  const ClockStats& stats() { return _stats; }
+  void printStatus(Print& out);
+
+private:
+  static void _ppsISR();
+  static GNSSClock* _instance; //attachInterrupt carries no context
+
+  void _pulse(uint32_t cycles);
+  void _anchor(uint32_t cycles, uint32_t tow_ms);
+  void _holdover();
+
+  GNSSTelemetry* _telemetry = nullptr;
+  volatile uint32_t _ppsCycles = 0; //Written by the ISR
+  volatile uint32_t _ppsCount = 0;
+  uint32_t _ppsSeen = 0;
+
+  bool _valid = false;
+  uint32_t _anchorCycles = 0;   //Cycle counter at the top of _anchorTow_ms
+  uint32_t _anchorTow_ms = 0;
+  uint32_t _pulseCycles = 0;    //Last pulse, for the rate
+  uint32_t _pulseTow_ms = 0;
+  double _cyclesPerSecond = 0;
+  double _nsPerCycle = 0;
+  uint16_t _holdover_s = 0;     //Seconds since the last pulse
+  float _reportOffset_ppm = 0;  //At the last status report, for the drift
+  ClockStats _stats = {};
+};
+
+#endif
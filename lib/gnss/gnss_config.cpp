@@ -0,0 +1,148 @@
+#include "gnss_config.h"
+
+static const uint16_t VALSET_PAYLOAD_SIZE = 4 + GNSS_CONFIG_MAX_KEYS * (4 + 8); //Header plus 64 keys with 64 bit values
+//sendCfgValset goes through the command queue, so every VALSET this builds has to fit a queue slot
+static_assert(VALSET_PAYLOAD_SIZE <= SFE_UBLOX_COMMAND_PAYLOAD_SIZE, "A full VALSET does not fit the command queue");
+
+//Add a key, or replace its value if it is already in the transaction
+bool GNSSConfig::set(uint32_t key, uint64_t value) {
+  for (uint8_t x = 0; x < _count; x++) {
+    if (_keys[x] == key) {
+      _values[x] = value;
+      return (true);
+    }
+  }
+
+  if (_count >= GNSS_CONFIG_MAX_KEYS)
+    return (false);
+
+  _keys[_count] = key;
+  _values[_count] = value;
+  _count++;
+  return (true);
+}
+
+//Size of the value in bytes, from bits 28-30 of the key
+uint8_t GNSSConfig::_valueSize(uint32_t key) {
+  switch ((key >> 28) & 0x07) {
+    case 1: return (1); //One bit, sent as a byte
+    case 2: return (1);
+    case 3: return (2);
+    case 4: return (4);
+    default: return (8);
+  }
+}
+
+//Compare only the bytes the key holds, so sign extended values match what the receiver returns
+bool GNSSConfig::_differs(uint8_t index, bool known, uint64_t current) {
+  if (!known)
+    return (true);
+  uint8_t size = _valueSize(_keys[index]);
+  uint64_t mask = (size == 8) ? ~0ULL : ((1ULL << (8 * size)) - 1);
+  return ((current & mask) != (_values[index] & mask));
+}
+
+void GNSSConfig::_remember(uint32_t key, uint64_t value) {
+  for (uint8_t x = 0; x < _knownCount; x++) {
+    if (_knownKeys[x] == key) {
+      _knownValues[x] = value;
+      return;
+    }
+  }
+  if (_knownCount < GNSS_CONFIG_MAX_KEYS) {
+    _knownKeys[_knownCount] = key;
+    _knownValues[_knownCount] = value;
+    _knownCount++;
+  }
+}
+
+bool GNSSConfig::_recalled(uint32_t key, uint64_t* value) {
+  for (uint8_t x = 0; x < _knownCount; x++) {
+    if (_knownKeys[x] == key) {
+      *value = _knownValues[x];
+      return (true);
+    }
+  }
+  return (false);
+}
+
+//Start a VALSET in packetCfg holding the keys which differ. Returns false if nothing needs writing
+bool GNSSConfig::_buildValset(SFE_UBLOX_GNSS& gnss, uint8_t layers, bool readBack) {
+  _changed = 0;
+  for (uint8_t x = 0; x < _count; x++) {
+    uint64_t current = _current[x];
+    bool known = readBack ? true : _recalled(_keys[x], &current);
+    if (!_differs(x, known, current))
+      continue;
+
+    if (_changed == 0)
+      gnss.newCfgValset(layers);
+
+    switch (_valueSize(_keys[x])) {
+      case 1: gnss.addCfgValset8(_keys[x], _values[x]); break;
+      case 2: gnss.addCfgValset16(_keys[x], _values[x]); break;
+      case 4: gnss.addCfgValset32(_keys[x], _values[x]); break;
+      default: gnss.addCfgValset64(_keys[x], _values[x]); break;
+    }
+    _changed++;
+  }
+  return (_changed > 0);
+}
+
+bool GNSSConfig::apply(SFE_UBLOX_GNSS& gnss, uint8_t layers, uint16_t maxWait) {
+  uint32_t start = millis();
+  _changed = 0;
+  _messages = 0;
+  if (_count == 0)
+    return (true);
+
+  //A full VALSET or VALGET is bigger than the library's default payload
+  if (gnss.getPacketCfgPayloadSize() < VALSET_PAYLOAD_SIZE)
+    gnss.setPacketCfgPayloadSize(VALSET_PAYLOAD_SIZE);
+
+  //Read back the current values. If that fails, write everything
+  bool readBack = (gnss.getValN(_keys, _count, _current, VAL_LAYER_RAM, maxWait) == SFE_UBLOX_STATUS_DATA_RECEIVED);
+  _messages++;
+  if (readBack) {
+    for (uint8_t x = 0; x < _count; x++)
+      _remember(_keys[x], _current[x]);
+  }
+
+  bool success = true;
+  if (_buildValset(gnss, layers, readBack)) {
+    success = gnss.sendCfgValset(maxWait);
+    _messages++;
+  }
+
+  if (success) {
+    for (uint8_t x = 0; x < _count; x++)
+      _remember(_keys[x], _values[x]);
+  }
+
+  _applyTime_ms = millis() - start;
+  return (success);
+}
+
+bool GNSSConfig::applyAsync(SFE_UBLOX_GNSS& gnss, sfe_ublox_command_callback_t callback, uint8_t layers) {
+  uint32_t start = millis();
+  _changed = 0;
+  _messages = 0;
+
+  if (gnss.getPacketCfgPayloadSize() < VALSET_PAYLOAD_SIZE)
+    gnss.setPacketCfgPayloadSize(VALSET_PAYLOAD_SIZE);
+
+  bool queued = true;
+  if (_buildValset(gnss, layers, false)) {
+    queued = gnss.sendCfgValsetAsync(callback);
+    _messages++;
+  }
+
+  //Assume the write succeeds. A NACK or timeout is reported through the callback
+  if (queued) {
+    for (uint8_t x = 0; x < _count; x++)
+      _remember(_keys[x], _values[x]);
+  }
+
+  _applyTime_ms = millis() - start;
+  return (queued);
+}
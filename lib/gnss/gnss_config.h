@@ -0,0 +1,53 @@
+//The GNSSConfig transaction collects receiver configuration keys and applies them together. The current
+//values are read back with one UBX-CFG-VALGET per 64 keys, compared with the wanted values, and only keys
+//that differ are written, packed into as few UBX-CFG-VALSETs as possible and to several layers at once.
+//This replaces one ACKed round trip per key at startup with two or three.
+//applyAsync diffs against the values known from the last apply and queues the VALSET without waiting,
+//so a settings change does not stall the UI or the radio while the receiver ACKs.
+
+#ifndef _GNSS_CONFIG_H_
+#define _GNSS_CONFIG_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+const uint8_t GNSS_CONFIG_MAX_KEYS = 64; //Most keys the receiver accepts in one VALSET or VALGET
+
+class GNSSConfig {
+public:
+  void clear() { _count = 0; }
+  void forget() { _knownCount = 0; } //The receiver's values are no longer known, e.g. after a failed write
+  bool set(uint32_t key, uint64_t value);
+
+  //Read back, diff and write the keys. Returns false if the receiver did not accept every message
+  bool apply(SFE_UBLOX_GNSS& gnss, uint8_t layers = VAL_LAYER_RAM | VAL_LAYER_BBR, uint16_t maxWait = defaultMaxWait);
+  //Diff against the known values and queue the write. The callback is called from checkUblox with the result
+  bool applyAsync(SFE_UBLOX_GNSS& gnss, sfe_ublox_command_callback_t callback = NULL, uint8_t layers = VAL_LAYER_RAM | VAL_LAYER_BBR);
+
+  uint8_t  keys() { return _count; }
+  uint8_t  changedKeys() { return _changed; }
+  uint8_t  messagesSent() { return _messages; }
+  uint32_t applyTime_ms() { return _applyTime_ms; }
+
+private:
+  static uint8_t _valueSize(uint32_t key);
+  bool _differs(uint8_t index, bool known, uint64_t current);
+  bool _buildValset(SFE_UBLOX_GNSS& gnss, uint8_t layers, bool readBack);
+  void _remember(uint32_t key, uint64_t value);
+  bool _recalled(uint32_t key, uint64_t* value);
+
+  uint32_t _keys[GNSS_CONFIG_MAX_KEYS];
+  uint64_t _values[GNSS_CONFIG_MAX_KEYS];
+  uint64_t _current[GNSS_CONFIG_MAX_KEYS]; //Values read back from the receiver
+  uint8_t  _count = 0;
+
+  uint32_t _knownKeys[GNSS_CONFIG_MAX_KEYS]; //Values the receiver is known to hold, from the last apply
+  uint64_t _knownValues[GNSS_CONFIG_MAX_KEYS];
+  uint8_t  _knownCount = 0;
+
+  uint8_t  _changed = 0;
+  uint8_t  _messages = 0;
+  uint32_t _applyTime_ms = 0;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#include "gnss_geodesy.h"
+
+static const double WGS84_A = 6378137.0;                 //Semi-major axis: m
+static const double WGS84_F = 1.0 / 298.257223563;       //Flattening
+static const double WGS84_E2 = WGS84_F * (2.0 - WGS84_F); //First eccentricity squared
+
+//Iterate on latitude. Each pass gains several digits, so a few passes reach well under 0.1mm
+void ecefToLLH(double x, double y, double z, double& lat_deg, double& lon_deg, double& height_m) {
+  double p = sqrt(x * x + y * y);
+  double lon = atan2(y, x);
+  double lat = atan2(z, p * (1.0 - WGS84_E2));
+  double height = 0;
+
+  for (uint8_t i = 0; i < 5; i++) {
+    double sinLat = sin(lat);
+    double n = WGS84_A / sqrt(1.0 - WGS84_E2 * sinLat * sinLat); //Prime vertical radius of curvature
+    height = p / cos(lat) - n;
+    lat = atan2(z, p * (1.0 - WGS84_E2 * n / (n + height)));
+  }
+
+  lat_deg = lat * 180.0 / M_PI;
+  lon_deg = lon * 180.0 / M_PI;
+  height_m = height;
+}
+
+void llhToECEF(double lat_deg, double lon_deg, double height_m, double& x, double& y, double& z) {
+  double lat = lat_deg * M_PI / 180.0;
+  double lon = lon_deg * M_PI / 180.0;
+  double sinLat = sin(lat);
+  double n = WGS84_A / sqrt(1.0 - WGS84_E2 * sinLat * sinLat);
+
+  x = (n + height_m) * cos(lat) * cos(lon);
+  y = (n + height_m) * cos(lat) * sin(lon);
+  z = (n * (1.0 - WGS84_E2) + height_m) * sinLat;
+}
@@ -0,0 +1,14 @@
+//WGS84 conversions between ECEF and geodetic coordinates
+
+#ifndef _GNSS_GEODESY_H_
+#define _GNSS_GEODESY_H_
+
+#include <Arduino.h>
+
+//ECEF in meters to latitude and longitude in degrees and height above the ellipsoid in meters
+void ecefToLLH(double x, double y, double z, double& lat_deg, double& lon_deg, double& height_m);
+
+//Latitude and longitude in degrees and height above the ellipsoid in meters to ECEF in meters
+void llhToECEF(double lat_deg, double lon_deg, double height_m, double& x, double& y, double& z);
+
+#endif
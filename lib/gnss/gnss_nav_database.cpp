@@ -0,0 +1,185 @@
+#include "gnss_nav_database.h"
+
+static const uint32_t SAVE_TIMEOUT_MS = 5000;  //The whole database normally arrives within three seconds
+static const uint16_t BATCH_ACK_WAIT_MS = 250; //For the ACKs of a restored batch, before carrying on regardless
+static const uint16_t CONFIG_WAIT_MS = 250;    //For the ackAiding get at begin, well inside the watchdog
+static const uint8_t  HEADER_LENGTH = 6;
+static const uint8_t  FRAME_OVERHEAD = 8;      //Header and checksum
+
+bool GNSSNavDatabase::begin(SFE_UBLOX_GNSS& gnss) {
+  _gnss = &gnss;
+  _state = NavDatabaseState::IDLE;
+
+  //Read once. The database is the only thing that changes it, and puts it back
+  _ackAiding = _gnss->getAckAiding(CONFIG_WAIT_MS);
+  if (_ackAiding == 255)
+    _ackAiding = 0;
+  return (true);
+}
+
+//Queue ackAiding on. The poll or first batch goes once the receiver has ACKed it
+bool GNSSNavDatabase::_enableAckAiding() {
+  if (!_gnss->setAckAidingAsync(1))
+    return (false);
+  _ackAidingCommand = _gnss->getLastCommandSequence();
+  return (true);
+}
+
+bool GNSSNavDatabase::save(Print& out) {
+  if (_gnss == nullptr || _state != NavDatabaseState::IDLE)
+    return (false);
+
+  if (!_enableAckAiding())
+    return (false);
+
+  _polled = false;
+  _out = &out;
+  _entries = 0;
+  _bytes = 0;
+  _elapsed = 0;
+  _state = NavDatabaseState::SAVING;
+  return (true);
+}
+
+bool GNSSNavDatabase::restore(Stream& in) {
+  if (_gnss == nullptr || _state != NavDatabaseState::IDLE)
+    return (false);
+
+  //Each pushed entry is acknowledged, so the receiver has to be sending MGA-ACKs and they have to be read promptly
+  if (!_enableAckAiding())
+    return (false);
+  _pollingWait = _gnss->getI2CpollingWait();
+  _gnss->setI2CpollingWait(1);
+  _gnss->readMGAACKs(); //Start counting from here
+
+  _in = &in;
+  _headerHeld = false;
+  _acksPending = 0;
+  _entries = 0;
+  _bytes = 0;
+  _elapsed = 0;
+  _state = NavDatabaseState::RESTORING;
+  return (true);
+}
+
+bool GNSSNavDatabase::update() {
+  switch (_state) {
+    case NavDatabaseState::SAVING:
+      return (_saveStep());
+    case NavDatabaseState::RESTORING:
+      return (_restoreStep());
+    default:
+      return (false);
+  }
+}
+
+//Write out whatever entries checkUblox has received since the last loop
+bool GNSSNavDatabase::_saveStep() {
+  if (!_polled) {
+    if (_gnss->commandPending(_ackAidingCommand))
+      return (false);
+    if (!_gnss->pollNavigationDatabase(_ackAiding)) {
+      _gnss->setAckAidingAsync(_ackAiding);
+      _finish(false);
+      return (true);
+    }
+    _polled = true;
+    _elapsed = 0;
+  }
+
+  bool complete = false;
+  size_t length;
+  do {
+    length = _gnss->readNavigationDatabaseEntries(_batch, sizeof(_batch), &complete);
+    if (length > 0 && _out->write(_batch, length) != length) {
+      _gnss->stopNavigationDatabaseRead();
+      _finish(false);
+      return (true);
+    }
+    _bytes += length;
+  } while (length > 0 && !complete);
+  _entries = _gnss->getNavigationDatabaseEntries();
+
+  if (complete) {
+    _finish(_entries > 0);
+    return (true);
+  }
+  if (_elapsed > SAVE_TIMEOUT_MS) { //The final ACK was missed
+    _gnss->stopNavigationDatabaseRead();
+    _finish(false);
+    return (true);
+  }
+  return (false);
+}
+
+//Once the last batch has been acknowledged, gather whole entries from the saved database into the next batch
+//and push it. The ACKs pace the transfer to what the receiver can take
+bool GNSSNavDatabase::_restoreStep() {
+  if (_gnss->commandPending(_ackAidingCommand))
+    return (false);
+
+  if (_acksPending > 0) {
+    uint16_t acks = _gnss->readMGAACKs();
+    _acksPending -= min(acks, _acksPending);
+    if (_acksPending > 0 && _sincePush < BATCH_ACK_WAIT_MS)
+      return (false);
+    _acksPending = 0; //Missed ACKs only cost the entries they were for
+  }
+
+  size_t length = 0;
+  uint16_t batchEntries = 0;
+  bool corrupt = false;
+  while (true) {
+    if (!_headerHeld) {
+      //Check what is left first, as readBytes waits out the stream timeout at the end
+      if (_in->available() < HEADER_LENGTH || _in->readBytes(_header, HEADER_LENGTH) != HEADER_LENGTH)
+        break; //End of the saved database
+      _headerHeld = true;
+    }
+
+    size_t payloadLength = _header[4] | (_header[5] << 8);
+    if (_header[0] != UBX_SYNCH_1 || _header[1] != UBX_SYNCH_2 || _header[2] != UBX_CLASS_MGA
+        || payloadLength > UBX_MGA_DBD_LEN) {
+      corrupt = true;
+      break;
+    }
+    if (length + payloadLength + FRAME_OVERHEAD > sizeof(_batch))
+      break; //Next batch
+
+    memcpy(&_batch[length], _header, HEADER_LENGTH);
+    size_t remaining = payloadLength + FRAME_OVERHEAD - HEADER_LENGTH;
+    if ((size_t)_in->available() < remaining || _in->readBytes(&_batch[length + HEADER_LENGTH], remaining) != remaining) {
+      corrupt = true;
+      break;
+    }
+    _headerHeld = false;
+    length += payloadLength + FRAME_OVERHEAD;
+    batchEntries++;
+  }
+
+  if (length > 0) {
+    size_t pushed = _gnss->pushAssistNowData(_batch, length, SFE_UBLOX_MGA_ASSIST_ACK_NO, 0);
+    _bytes += pushed;
+    _entries += batchEntries;
+    if (pushed > 0) {
+      _acksPending = batchEntries;
+      _sincePush = 0;
+    }
+  }
+
+  if (_acksPending == 0 && (corrupt || !_headerHeld)) { //Finished, or the rest of the file cannot be trusted
+    _gnss->setI2CpollingWait(_pollingWait);
+    _gnss->setAckAidingAsync(_ackAiding);
+    _finish(!corrupt && _entries > 0);
+    return (true);
+  }
+  return (false);
+}
+
+void GNSSNavDatabase::_finish(bool success) {
+  _succeeded = success;
+  _duration_ms = _elapsed;
+  _state = NavDatabaseState::IDLE;
+  _out = nullptr;
+  _in = nullptr;
+}
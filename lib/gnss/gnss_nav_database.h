@@ -0,0 +1,64 @@
+//The GNSSNavDatabase keeps a copy of the receiver's navigation database (ephemerides, almanacs, ionosphere
+//and time) so a base that loses power without a backup battery can hot start. Saving polls UBX-MGA-DBD
+//and writes each entry to the output as it arrives. Restoring reads the entries back and pushes them to
+//the receiver a batch at a time. The next batch waits until the receiver has acknowledged every entry of the last,
+//so the receiver sets the pace, but the ACKs are counted as checkUblox receives them rather than waited for.
+//Both run from update(), a little per loop, so the rest of the firmware keeps running.
+//Both need the receiver's ackAiding on. Its setting is read once in begin, and switched on and back through the
+//command queue, so a save or restore never waits on a configuration exchange.
+
+#ifndef _GNSS_NAV_DATABASE_H_
+#define _GNSS_NAV_DATABASE_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+enum class NavDatabaseState : uint8_t {
+  IDLE = 0,
+  SAVING,
+  RESTORING
+};
+
+class GNSSNavDatabase {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss);
+
+  bool save(Print& out);    //Start writing the receiver's database to out
+  bool restore(Stream& in); //Start sending a saved database from in to the receiver
+  //Returns true once, when a save or restore has finished
+  bool update();
+
+  NavDatabaseState state() { return _state; }
+  bool succeeded() { return _succeeded; } //Result of the last save or restore
+  uint32_t entries() { return _entries; } //Entries saved or restored
+  uint32_t bytes() { return _bytes; }
+  uint32_t duration_ms() { return _duration_ms; }
+
+private:
+  bool _enableAckAiding();
+  bool _saveStep();
+  bool _restoreStep();
+  void _finish(bool success);
+
+  SFE_UBLOX_GNSS* _gnss = nullptr;
+  Print* _out = nullptr;
+  Stream* _in = nullptr;
+  NavDatabaseState _state = NavDatabaseState::IDLE;
+  bool _succeeded = false;
+  uint32_t _entries = 0;
+  uint32_t _bytes = 0;
+  uint32_t _duration_ms = 0;
+  elapsedMillis _elapsed = 0;
+
+  uint8_t _batch[512];     //Entries on their way to or from the receiver
+  uint8_t _header[6];      //Header of an entry read from the saved database that did not fit in the last batch
+  bool _headerHeld = false;
+  uint16_t _acksPending = 0; //Entries in the last batch pushed that have not been acknowledged yet
+  elapsedMillis _sincePush = 0;
+  uint8_t _ackAiding = 0;  //Receiver setting, read in begin, to put back after a save or restore
+  uint32_t _ackAidingCommand = 0; //Queued command switching ackAiding on. Nothing is sent until it completes
+  bool _polled = false;
+  uint8_t _pollingWait = 0;
+};
+
+#endif
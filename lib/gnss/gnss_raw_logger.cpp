@@ -0,0 +1,157 @@
+#include "gnss_raw_logger.h"
+
+static const char RAW_LOG_DIRECTORY[] = "/raw";
+static const uint8_t HOURS_PER_WEEK = 168;
+
+bool GNSSRawLogger::begin(SFE_UBLOX_GNSS& gnss, LittleFS_QSPIFlash* fs) {
+  _gnss = &gnss;
+  _fs = fs;
+  if (_gnss->getFileBufferSize() == 0)
+    return (false);
+
+  if (!_fs->exists(RAW_LOG_DIRECTORY))
+    _fs->mkdir(RAW_LOG_DIRECTORY);
+  _maxFileBytes = _fs->totalSize() / 4;
+  _stats = {};
+  _sinceBegin = 0;
+
+  //Frames go to the file buffer as they are parsed. Nothing reads them from the library's copy
+  bool success = true;
+  success &= _gnss->setAutoRXMRAWX(true, false);
+  success &= _gnss->setAutoRXMSFRBX(true, false);
+  _gnss->logRXMRAWX();
+  _gnss->logRXMSFRBX();
+  return (success);
+}
+
+//Rotate the file on the hour or when it is full, then move at most one block from the file buffer to flash
+void GNSSRawLogger::update() {
+  if (_gnss == nullptr)
+    return;
+
+  uint32_t hour = _gpsHour();
+  if (_file && (hour != _fileHour || _fileBytes >= _maxFileBytes))
+    _close();
+  if (!_file && !_open(hour))
+    return;
+
+  //A whole block that does not wrap around the file buffer is written straight from it
+  const uint8_t* first;
+  const uint8_t* second;
+  uint16_t firstLength, secondLength;
+  _gnss->peekFileBuffer(&first, &firstLength, &second, &secondLength);
+  if (_blockLength == 0 && firstLength >= sizeof(_block)) {
+    _write(first, sizeof(_block));
+    _gnss->discardFileBufferData(sizeof(_block));
+    return;
+  }
+
+  _blockLength += _gnss->extractFileBufferData(&_block[_blockLength], sizeof(_block) - _blockLength);
+  if (_blockLength == sizeof(_block)) {
+    _write(_block, _blockLength);
+    _blockLength = 0;
+  }
+}
+
+void GNSSRawLogger::end() {
+  if (_file)
+    _close();
+  if (_gnss != nullptr) {
+    _gnss->logRXMRAWX(false);
+    _gnss->logRXMSFRBX(false);
+  }
+}
+
+float GNSSRawLogger::throughput_Bps() {
+  if (_sinceBegin == 0)
+    return (0);
+  return (_stats.bytes * 1000.0 / (uint32_t)_sinceBegin);
+}
+
+//Throughput, worst write latency and how close the file buffer has come to overflowing
+void GNSSRawLogger::printStatus(Print& out) {
+  uint16_t peak = _gnss->getMaxFileBufferAvail();
+  uint16_t size = _gnss->getFileBufferSize();
+  out.printf("Raw log %s: %lu KB, %.1f KB/s, worst write %lu us, buffer peak %u of %u bytes, %lu packets dropped%s\r\n",
+             logging() ? "on" : "off", _stats.bytes / 1024, throughput_Bps() / 1024.0, _stats.worstWrite_us,
+             peak, size, _gnss->getFileBufferDropped(), peak > size / 4 * 3 ? " - buffer too small" : "");
+}
+
+//Time of the latest RAWX, as hours since the start of GPS time. Zero until the receiver knows the time
+uint32_t GNSSRawLogger::_gpsHour() {
+  UBX_RXM_RAWX_t* rawx = _gnss->packetUBXRXMRAWX;
+  if (rawx == nullptr)
+    return (0);
+  double tow;
+  memcpy(&tow, rawx->data.header.rcvTow, sizeof(tow));
+  return ((uint32_t)rawx->data.header.week * HOURS_PER_WEEK + (uint32_t)(tow / 3600.0));
+}
+
+bool GNSSRawLogger::_open(uint32_t hour) {
+  if (hour != _fileHour)
+    _sequence = 0;
+  _fileHour = hour;
+  if (!_makeRoom())
+    return (false);
+
+  char name[32];
+  do {
+    snprintf(name, sizeof(name), "%s/%04lu_%03lu_%02u.ubx", RAW_LOG_DIRECTORY,
+             hour / HOURS_PER_WEEK, hour % HOURS_PER_WEEK, _sequence++);
+  } while (_fs->exists(name));
+
+  _file = _fs->open(name, FILE_WRITE);
+  if (!_file)
+    return (false);
+  _fileBytes = 0;
+  _stats.files++;
+  return (true);
+}
+
+void GNSSRawLogger::_close() {
+  if (_blockLength > 0)
+    _write(_block, _blockLength);
+  _blockLength = 0;
+  _file.close();
+}
+
+void GNSSRawLogger::_write(const uint8_t* data, uint16_t length) {
+  elapsedMicros writeTime = 0;
+  size_t written = _file.write(data, length);
+  uint32_t us = writeTime;
+
+  if (us > _stats.worstWrite_us)
+    _stats.worstWrite_us = us;
+  _stats.blocks++;
+  _stats.bytes += written;
+  _fileBytes += written;
+  if (written != length) { //Probably full. Start a new file, which will make room first
+    _stats.writeErrors++;
+    _file.close();
+  }
+}
+
+//Delete the oldest logs until there is room for a whole file
+bool GNSSRawLogger::_makeRoom() {
+  while (_fs->totalSize() - _fs->usedSize() < _maxFileBytes) {
+    char oldest[32] = "";
+    File directory = _fs->open(RAW_LOG_DIRECTORY);
+    File entry = directory.openNextFile();
+    while (entry) {
+      if (!entry.isDirectory() && (oldest[0] == 0 || strcmp(entry.name(), oldest) < 0))
+        strncpy(oldest, entry.name(), sizeof(oldest) - 1);
+      entry.close();
+      entry = directory.openNextFile();
+    }
+    directory.close();
+
+    if (oldest[0] == 0)
+      return (false); //Nothing left to delete
+
+    char path[48];
+    snprintf(path, sizeof(path), "%s/%s", RAW_LOG_DIRECTORY, oldest);
+    _fs->remove(path);
+    _stats.deleted++;
+  }
+  return (true);
+}
@@ -0,0 +1,59 @@
+//The GNSSRawLogger records the receiver's raw observations (RXM-RAWX) and navigation subframes (RXM-SFRBX)
+//to flash, so a session can still be post-processed if the radio link fails. The library copies each frame
+//into its file buffer as it is parsed. update() moves the buffer to flash in whole 4KB blocks, the erase
+//size of the QSPI flash, so every write lines up with the file system's blocks. Blocks are written straight
+//from the file buffer unless they wrap around its end. At most one block is written per loop; the file
+//buffer absorbs the data that arrives while flash is busy.
+//Files are named by GPS week and hour and rotated each hour, or sooner if a file reaches a quarter of the
+//flash. The oldest files are deleted to make room, so the flash holds the most recent data.
+
+#ifndef _GNSS_RAW_LOGGER_H_
+#define _GNSS_RAW_LOGGER_H_
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+struct RawLoggerStats {
+  uint32_t bytes;         //Written to flash
+  uint32_t blocks;        //Writes
+  uint32_t worstWrite_us; //Longest single write
+  uint32_t writeErrors;   //Short writes. The file is closed and a new one started
+  uint32_t files;         //Opened since begin
+  uint32_t deleted;       //Removed to make room
+};
+
+class GNSSRawLogger {
+public:
+  //The file buffer has to be sized with setFileBufferSize before the receiver's begin
+  bool begin(SFE_UBLOX_GNSS& gnss, LittleFS_QSPIFlash* fs);
+  void update();
+  void end(); //Write out what is buffered and close the file
+
+  bool logging() { return _file; }
+  const RawLoggerStats& stats() { return _stats; }
+  float throughput_Bps();
+  void printStatus(Print& out);
+
+private:
+  uint32_t _gpsHour();
+  bool _open(uint32_t hour);
+  void _close();
+  void _write(const uint8_t* data, uint16_t length);
+  bool _makeRoom();
+
+  SFE_UBLOX_GNSS* _gnss = nullptr;
+  LittleFS_QSPIFlash* _fs = nullptr;
+  File _file;
+  uint32_t _fileHour = 0;     //GPS week * 168 + hour of week the file was opened in
+  uint32_t _fileBytes = 0;
+  uint32_t _maxFileBytes = 0; //A quarter of the flash
+  uint8_t _sequence = 0;      //Files opened in this hour
+  RawLoggerStats _stats = {};
+  elapsedMillis _sinceBegin = 0;
+
+  uint8_t _block[4096];
+  uint16_t _blockLength = 0;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "gnss_rtcm_encoder.h"
+#include "gnss_geodesy.h"
+
+GNSSRTCMEncoder* GNSSRTCMEncoder::_instance = nullptr;
+
+//u-blox gnssId for each Constellation
+static const uint8_t GNSS_IDS[] = { RTCM_GPS, RTCM_GLONASS, RTCM_GALILEO, RTCM_BEIDOU };
+
+//RAWX output rate is set with the receiver configuration
+bool GNSSRTCMEncoder::begin(SFE_UBLOX_GNSS& gnss, GNSSSettings& settings, RTCMFrameCallback callback) {
+  _settings = &settings;
+  _callback = callback;
+  _instance = this;
+  _applyBands();
+  return (gnss.setAutoRXMRAWXcallbackPtr(&_rawxCallback));
+}
+
+void GNSSRTCMEncoder::plan(MSMType msm, uint8_t interval) {
+  _encoder.msm((uint8_t)msm);
+  _interval = max(interval, (uint8_t)1);
+}
+
+void GNSSRTCMEncoder::constellations(bool gps, bool glonass, bool galileo, bool beidou) {
+  bool enabled[(uint8_t)Constellation::COUNT] = { gps, glonass, galileo, beidou };
+  if (memcmp(enabled, _enabled, sizeof(enabled)) != 0) {
+    memcpy(_enabled, enabled, sizeof(enabled));
+    _applyBands();
+  }
+}
+
+void GNSSRTCMEncoder::bands(Constellation constellation, uint8_t bands) {
+  _bands[(uint8_t)constellation] = bands;
+  _applyBands();
+}
+
+void GNSSRTCMEncoder::_applyBands() {
+  for (uint8_t x = 0; x < (uint8_t)Constellation::COUNT; x++)
+    _encoder.bands(GNSS_IDS[x], _enabled[x] ? _bands[x] : 0);
+}
+
+//1005 from the stored position. Nothing is sent during survey-in or averaging, as the stored position is not in use
+void GNSSRTCMEncoder::_sendStation() {
+  if (_settings->baseMode() != BaseMode::FIXED)
+    return;
+
+  double x, y, z;
+  llhToECEF(_settings->lat() * 1e-7 + _settings->latHP() * 1e-9, _settings->lon() * 1e-7 + _settings->lonHP() * 1e-9,
+            _settings->alt() * 0.01 + _settings->altHP() * 0.0001, x, y, z);
+  uint16_t length = _encoder.encodeStation(x, y, z, _enabled[(uint8_t)Constellation::GPS],
+                                           _enabled[(uint8_t)Constellation::GLONASS],
+                                           _enabled[(uint8_t)Constellation::GALILEO], _stationFrame);
+  _frameReady(_stationFrame, length, 1005, 0);
+}
+
+void GNSSRTCMEncoder::_frameReady(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t epoch) {
+  GNSSRTCMEncoder* encoder = _instance;
+  encoder->_stats.frames++;
+  encoder->_stats.bytes += length;
+  encoder->_callback(frame, length, messageNumber, epoch);
+}
+
+//The RAWX doubles are little-endian and unaligned, so they are copied out rather than cast
+void GNSSRTCMEncoder::_rawxCallback(UBX_RXM_RAWX_data_t* data) {
+  GNSSRTCMEncoder* encoder = _instance;
+  double tow_s;
+  memcpy(&tow_s, data->header.rcvTow, sizeof(tow_s));
+  if (llround(tow_s * 1000.0) % 1000 == 0)
+    encoder->_sendStation();
+  if (encoder->_epochCount++ % encoder->_interval != 0)
+    return;
+
+  uint32_t start = micros();
+  uint8_t count = min(data->header.numMeas, UBX_RXM_RAWX_MAX_BLOCKS);
+  for (uint8_t x = 0; x < count; x++) {
+    const UBX_RXM_RAWX_block_t& block = data->blocks[x];
+    RTCMObservation& observation = encoder->_observations[x];
+    memcpy(&observation.pseudorange_m, block.prMes, sizeof(double));
+    memcpy(&observation.phase_cycles, block.cpMes, sizeof(double));
+    memcpy(&observation.doppler_Hz, block.doMes, sizeof(float));
+    observation.gnssId = block.gnssId;
+    observation.svId = block.svId;
+    observation.sigId = block.sigId;
+    observation.freqId = block.freqId;
+    observation.lockTime_ms = block.lockTime;
+    observation.cno = block.cno;
+    observation.pseudorangeValid = block.trkStat.bits.prValid;
+    observation.phaseValid = block.trkStat.bits.cpValid;
+    observation.halfCycleResolved = block.trkStat.bits.halfCyc;
+  }
+  encoder->_encoder.encodeEpoch(encoder->_observations, count, tow_s, data->header.leapS,
+                                data->header.recStat.bits.leapSec, &_frameReady);
+
+  encoder->_stats.epochs++;
+  encoder->_stats.encode_us = micros() - start;
+  encoder->_stats.encodeMax_us = max(encoder->_stats.encodeMax_us, encoder->_stats.encode_us);
+}
+
+void GNSSRTCMEncoder::printStatus(Print& out) {
+  out.printf("RTCM encoder: MSM%u every %u epochs, %lu epochs, %lu frames, %lu bytes, encode %lu us (max %lu us)\r\n",
+             _encoder.msm(), _interval, _stats.epochs, _stats.frames, _stats.bytes, _stats.encode_us,
+             _stats.encodeMax_us);
+}
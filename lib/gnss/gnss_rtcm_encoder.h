@@ -0,0 +1,58 @@
+//The GNSSRTCMEncoder makes the RTCM observations in firmware instead of in the receiver. Each RXM-RAWX epoch
+//is converted to RTCM observations and encoded as one MSM per enabled constellation, at the MSM type and
+//interval the planner picks. The station position from the settings goes out as 1005 once a second. Frames
+//go to the same callback as the receiver's own RTCM, so the radio path does not change.
+
+#ifndef _GNSS_RTCM_ENCODER_H_
+#define _GNSS_RTCM_ENCODER_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <rtcm.h>
+#include "gnss_settings.h"
+#include "gnss_rtcm_planner.h"
+
+struct RTCMEncoderStats {
+  uint32_t epochs;   //RAWX epochs encoded
+  uint32_t frames;
+  uint32_t bytes;
+  uint32_t encode_us; //Last epoch
+  uint32_t encodeMax_us;
+};
+
+class GNSSRTCMEncoder {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss, GNSSSettings& settings, RTCMFrameCallback callback);
+
+  //interval is in RAWX epochs
+  void plan(MSMType msm, uint8_t interval);
+  void constellations(bool gps, bool glonass, bool galileo, bool beidou);
+  void bands(Constellation constellation, uint8_t bands);
+  void minCno(uint8_t cno) { _encoder.minCno(cno); }
+  void stationId(uint16_t id) { _encoder.stationId(id); }
+
+  const RTCMEncoderStats& stats() { return _stats; }
+  void printStatus(Print& out);
+
+private:
+  static void _rawxCallback(UBX_RXM_RAWX_data_t* data);
+  static void _frameReady(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t epoch);
+  static GNSSRTCMEncoder* _instance; //The SparkFun callbacks carry no context
+
+  void _applyBands();
+  void _sendStation();
+
+  GNSSSettings* _settings = nullptr;
+  RTCMFrameCallback _callback = nullptr;
+  RTCMEncoder _encoder;
+  RTCMObservation _observations[UBX_RXM_RAWX_MAX_BLOCKS];
+  bool _enabled[(uint8_t)Constellation::COUNT] = { true, true, true, true };
+  uint8_t _bands[(uint8_t)Constellation::COUNT] = { RTCM_BAND_1 | RTCM_BAND_2, RTCM_BAND_1 | RTCM_BAND_2,
+                                                    RTCM_BAND_1 | RTCM_BAND_2, RTCM_BAND_1 | RTCM_BAND_2 };
+  uint8_t _interval = 1;
+  uint32_t _epochCount = 0;
+  RTCMEncoderStats _stats = {};
+  uint8_t _stationFrame[RTCM_MAX_FRAME];
+};
+
+#endif
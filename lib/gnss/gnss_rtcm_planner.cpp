@@ -0,0 +1,105 @@
+#include "gnss_rtcm_planner.h"
+
+static const uint8_t SIGNALS_PER_SATELLITE = 2;  //Dual band: L1 plus L2, E5b or B2I
+static const uint16_t FRAME_OVERHEAD = 3 + 3;    //Preamble and length, CRC-24Q
+static const uint16_t STATION_BYTES = 19 + 6;    //1005, once a second
+static const uint16_t GLONASS_BIAS_BYTES = 8 + 6; //1230, once a second with GLONASS
+static const float KEEP_LOAD = 0.9;              //Keep the current plan while it uses no more than this of the link
+static const float UPGRADE_LOAD = 0.8;           //Only move to a richer plan if it uses no more than this
+
+//Candidate plans, richest first. A faster rate is worth more to a rover than finer observations, but a rover
+//gains nothing from observations more than once a second, whatever the navigation rate
+static const uint8_t PERIODS_S[] = { 1, 2, 5, 10 };
+static const uint8_t NUMBER_OF_PERIODS = sizeof(PERIODS_S) / sizeof(PERIODS_S[0]);
+static const MSMType MSM_TYPES[] = { MSMType::MSM7, MSMType::MSM4 };
+
+//Only code locked satellites have observations to send. SBAS, QZSS and IMES are not sent
+void GNSSRTCMPlanner::satellites(const SkySummary& sky) {
+  if (!sky.valid)
+    return;
+
+  uint8_t counts[(uint8_t)Constellation::COUNT];
+  for (uint8_t x = 0; x < (uint8_t)Constellation::COUNT; x++)
+    counts[x] = sky.constellations[x].locked;
+
+  if (memcmp(counts, _satellites, sizeof(counts)) != 0) {
+    memcpy(_satellites, counts, sizeof(counts));
+    _replan = true;
+  }
+}
+
+void GNSSRTCMPlanner::constellations(bool gps, bool glonass, bool galileo, bool beidou) {
+  bool enabled[(uint8_t)Constellation::COUNT] = { gps, glonass, galileo, beidou };
+  if (memcmp(enabled, _enabled, sizeof(enabled)) != 0) {
+    memcpy(_enabled, enabled, sizeof(enabled));
+    _replan = true;
+  }
+}
+
+void GNSSRTCMPlanner::capacity(uint16_t bytesPerSecond) {
+  if (bytesPerSecond != _capacity) {
+    _capacity = bytesPerSecond;
+    _replan = true;
+  }
+}
+
+//MSM: 169 bit header including the satellite and signal masks, a cell mask bit per satellite and signal,
+//then per satellite and per cell data. Sizes from RTCM 10403.3 tables 3.5-78 to 3.5-101
+uint16_t GNSSRTCMPlanner::msmBytes(MSMType msm, uint8_t satellites, uint8_t signals) {
+  if (satellites == 0)
+    return (0);
+  uint16_t cells = satellites * signals;
+  uint32_t bits = 169 + cells;
+  if (msm == MSMType::MSM7)
+    bits += satellites * 36 + cells * 80;
+  else
+    bits += satellites * 18 + cells * 48;
+  return ((bits + 7) / 8 + FRAME_OVERHEAD);
+}
+
+uint32_t GNSSRTCMPlanner::predictBytesPerSecond(MSMType msm, uint8_t interval) {
+  uint32_t perEpoch = 0;
+  for (uint8_t x = 0; x < (uint8_t)Constellation::COUNT; x++) {
+    if (_enabled[x])
+      perEpoch += msmBytes(msm, _satellites[x], SIGNALS_PER_SATELLITE);
+  }
+
+  uint32_t bytes = perEpoch * _navigationRate / interval + STATION_BYTES;
+  if (_enabled[(uint8_t)Constellation::GLONASS])
+    bytes += GLONASS_BIAS_BYTES;
+  return (bytes);
+}
+
+bool GNSSRTCMPlanner::update() {
+  if (!_replan || _capacity == 0)
+    return (false);
+  _replan = false;
+
+  RTCMPlan best = { MSMType::MSM4, (uint8_t)(_navigationRate * PERIODS_S[NUMBER_OF_PERIODS - 1]), 0, false };
+  best.bytesPerSecond = predictBytesPerSecond(best.msm, best.interval);
+  bool richer = true; //Candidates richer than the current plan need the extra headroom
+  bool found = false;
+
+  for (uint8_t i = 0; i < NUMBER_OF_PERIODS && !found; i++) {
+    uint8_t interval = _navigationRate * PERIODS_S[i];
+    for (uint8_t m = 0; m < sizeof(MSM_TYPES) / sizeof(MSM_TYPES[0]) && !found; m++) {
+      if (interval == _plan.interval && MSM_TYPES[m] == _plan.msm)
+        richer = false;
+
+      uint32_t bytes = predictBytesPerSecond(MSM_TYPES[m], interval);
+      float limit = _capacity * (richer ? UPGRADE_LOAD : KEEP_LOAD);
+      if (bytes <= limit) {
+        best = { MSM_TYPES[m], interval, (uint16_t)min(bytes, (uint32_t)UINT16_MAX), true };
+        found = true;
+      }
+    }
+  }
+
+  bool changed = (best.msm != _plan.msm || best.interval != _plan.interval);
+  _plan = best;
+  if (changed) {
+    Serial.printf("RTCM plan: MSM%u every %u epochs, %u of %u bytes/s%s\r\n", (uint8_t)_plan.msm, _plan.interval,
+                  _plan.bytesPerSecond, _capacity, _plan.fits ? "" : " (over capacity)");
+  }
+  return (changed);
+}
@@ -0,0 +1,49 @@
+//The GNSSRTCMPlanner picks the richest RTCM observation output that the radio link can carry. From the
+//satellites tracked in each enabled constellation (NAV-SAT) it predicts the size of each MSM message,
+//then walks the candidate message sets from richest to leanest and keeps the first that fits the link.
+//It re-plans as satellites rise and set; moving to a richer set needs more headroom than keeping the
+//current one, so the plan does not flip back and forth at the boundary.
+
+#ifndef _GNSS_RTCM_PLANNER_H_
+#define _GNSS_RTCM_PLANNER_H_
+
+#include <Arduino.h>
+#include "gnss_sky_summary.h"
+
+enum class MSMType : uint8_t {
+  MSM4 = 4, //Pseudorange, phase, lock time and CNR
+  MSM7 = 7  //MSM4 plus Doppler, at higher resolution
+};
+
+struct RTCMPlan {
+  MSMType  msm;
+  uint8_t  interval;       //Navigation epochs between observation messages
+  uint16_t bytesPerSecond; //Predicted RTCM output
+  bool     fits;           //False if even the leanest plan is more than the link can carry
+};
+
+class GNSSRTCMPlanner {
+public:
+  void satellites(const SkySummary& sky);
+  void constellations(bool gps, bool glonass, bool galileo, bool beidou);
+  void capacity(uint16_t bytesPerSecond);
+  void navigationRate(uint8_t rate_Hz) { _navigationRate = rate_Hz; } //Up to 25Hz, so ten seconds of epochs fit an interval
+
+  //Returns true when the plan has changed and the receiver needs reprogramming
+  bool update();
+
+  const RTCMPlan& plan() { return _plan; }
+  uint8_t satellites(Constellation constellation) { return _satellites[(uint8_t)constellation]; }
+  uint32_t predictBytesPerSecond(MSMType msm, uint8_t interval);
+  static uint16_t msmBytes(MSMType msm, uint8_t satellites, uint8_t signals);
+
+private:
+  bool _enabled[(uint8_t)Constellation::COUNT] = { true, true, true, true };
+  uint8_t _satellites[(uint8_t)Constellation::COUNT] = {};
+  bool _replan = false; //Satellites, constellations or capacity have changed since the last plan
+  uint16_t _capacity = 0;
+  uint8_t _navigationRate = 20;
+  RTCMPlan _plan = { MSMType::MSM4, 20, 0, false }; //Once a second until the first NAV-SAT
+};
+
+#endif
@@ -12,6 +12,10 @@ void GNSSSettings::defaultSettings(){
   _lon_hp = -66;
   _alt = 108900;
   _alt_hp = 0;
+
+  _baseMode = BaseMode::SURVEY_IN;
+  _surveyTime_s = 300;
+  _surveyAccuracy_mm = 2000;
 }
 
 void GNSSSettings::gps(bool use) {
@@ -32,8 +36,8 @@ void GNSSSettings::beidou(bool use) {
 };
 
 void GNSSSettings::lat(int32_t val) {
-  if (-1800000000>val) val = -1800000000;
-  if (1800000000<val) val = 1800000000;
+  if (-900000000>val) val = -900000000;
+  if (900000000<val) val = 900000000;
   if (val != _lat) _dirty = true;
   _lat = val;
 }
@@ -46,8 +50,8 @@ void GNSSSettings::latHP(int8_t val) {
 }
 
 void GNSSSettings::lon(int32_t val) {
-  if (-900000000>val) val = -900000000;
-  if (900000000<val) val = 900000000;
+  if (-1800000000>val) val = -1800000000;
+  if (1800000000<val) val = 1800000000;
   if (val != _lon) _dirty = true;
   _lon = val;
 }
@@ -73,6 +77,49 @@ void GNSSSettings::altHP(int8_t val) {
   _alt_hp = val;
 }
 
+//Split a value into a whole number of coarse units and a rounded remainder of 1/100 units, as the receiver wants
+static void splitHP(double value, int32_t& coarse, int8_t& fine) {
+  coarse = (int32_t)value; //Truncate towards zero, so both parts share the sign
+  int32_t remainder = lround((value - coarse) * 100.0);
+  if (remainder >= 100 || remainder <= -100) {
+    coarse += remainder / 100;
+    remainder %= 100;
+  }
+  fine = remainder;
+}
+
+void GNSSSettings::position(double lat_deg, double lon_deg, double height_m) {
+  int32_t coarse;
+  int8_t fine;
+  splitHP(lat_deg * 1e7, coarse, fine); //deg * 1e-7 and deg * 1e-9
+  lat(coarse);
+  latHP(fine);
+  splitHP(lon_deg * 1e7, coarse, fine);
+  lon(coarse);
+  lonHP(fine);
+  splitHP(height_m * 100.0, coarse, fine); //cm and mm * 0.1
+  alt(coarse);
+  altHP(fine);
+}
+
+void GNSSSettings::baseMode(BaseMode mode) {
+  if (mode > BaseMode::AVERAGE) return; //Stored as a number, so a bad file can hold anything
+  if (mode != _baseMode) _dirty = true;
+  _baseMode = mode;
+}
+
+void GNSSSettings::surveyTime_s(uint16_t time) {
+  if (time < 60) time = 60;
+  if (time != _surveyTime_s) _dirty = true;
+  _surveyTime_s = time;
+}
+
+void GNSSSettings::surveyAccuracy_mm(uint16_t accuracy) {
+  if (accuracy < 10) accuracy = 10;
+  if (accuracy != _surveyAccuracy_mm) _dirty = true;
+  _surveyAccuracy_mm = accuracy;
+}
+
 void GNSSSettings::dirty(bool state) {
 _dirty = state;
 }
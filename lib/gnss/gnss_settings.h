@@ -3,6 +3,12 @@
 
 #include <Arduino.h>
 
+//How the receiver's base position is found
+enum class BaseMode : uint8_t {
+  SURVEY_IN = 0, //Survey-in on each boot until a position is stored
+  FIXED,         //Use the stored position straight away
+  AVERAGE        //Navigate, with no corrections, so the long-term position average can build up
+};
 
 class GNSSSettings {
 public:
@@ -32,6 +38,15 @@ public:
   void     alt(int32_t val);
   int8_t   altHP() {return _alt_hp; }
   void     altHP(int8_t val);
+  //Set the whole position from geodetic degrees and ellipsoidal height in meters, split into the standard and HP parts
+  void     position(double lat_deg, double lon_deg, double height_m);
+
+  BaseMode baseMode() { return _baseMode; }
+  void     baseMode(BaseMode mode);
+  uint16_t surveyTime_s() { return _surveyTime_s; }
+  void     surveyTime_s(uint16_t time);
+  uint16_t surveyAccuracy_mm() { return _surveyAccuracy_mm; }
+  void     surveyAccuracy_mm(uint16_t accuracy);
 
   void     dirty(bool state);
   bool     dirty();
@@ -51,6 +66,10 @@ private:
   int8_t _lon_hp;
   int32_t _alt;
   int8_t _alt_hp;
+
+  BaseMode _baseMode;
+  uint16_t _surveyTime_s;      //Minimum survey-in time
+  uint16_t _surveyAccuracy_mm; //Survey-in ends once the mean is this accurate
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "gnss_sky_summary.h"
+
+static const uint8_t QUALITY_ACQUIRED = 2;
+static const uint8_t QUALITY_CODE_LOCKED = 4;
+static const uint8_t CNO_FIRST_BIN = 25; //dB-Hz
+static const uint8_t CNO_BIN_WIDTH = 5;
+static const uint8_t ELEVATION_BIN_WIDTH = 15;
+
+int8_t constellationOf(uint8_t gnssId) {
+  switch (gnssId) {
+    case 0: return ((int8_t)Constellation::GPS);
+    case 2: return ((int8_t)Constellation::GALILEO);
+    case 3: return ((int8_t)Constellation::BEIDOU);
+    case 6: return ((int8_t)Constellation::GLONASS);
+    default: return (-1);
+  }
+}
+
+void SkySummary::clear() {
+  *this = {};
+}
+
+//Satellites that are not at least acquired only count towards numSvs
+void SkySummary::add(const UBX_NAV_SAT_block_t& block) {
+  numSvs++;
+  if (block.flags.bits.qualityInd < QUALITY_ACQUIRED)
+    return;
+
+  int8_t index = constellationOf(block.gnssId);
+  if (index >= 0) {
+    ConstellationSummary& summary = constellations[index];
+    summary.tracked++;
+    if (block.flags.bits.qualityInd >= QUALITY_CODE_LOCKED)
+      summary.locked++;
+    if (block.flags.bits.svUsed)
+      summary.used++;
+
+    uint8_t cnoBin = block.cno < CNO_FIRST_BIN ? 0 : 1 + (block.cno - CNO_FIRST_BIN) / CNO_BIN_WIDTH;
+    summary.cno[min(cnoBin, (uint8_t)(CNO_BINS - 1))]++;
+    uint8_t elevationBin = block.elev < 0 ? 0 : block.elev / ELEVATION_BIN_WIDTH;
+    summary.elevation[min(elevationBin, (uint8_t)(ELEVATION_BINS - 1))]++;
+    summary.cnoSum += block.cno;
+  }
+
+  if (satellites < SKY_MAX_SATELLITES && block.elev >= 0 && block.azim >= 0) {
+    SkySatellite& satellite = sky[satellites++];
+    satellite.gnssId = block.gnssId;
+    satellite.svId = block.svId;
+    satellite.cno = block.cno;
+    satellite.elev = block.elev;
+    satellite.azim2 = block.azim / 2;
+    satellite.used = block.flags.bits.svUsed;
+  }
+}
+
+float SkySummary::meanCno(Constellation c) const {
+  const ConstellationSummary& summary = constellation(c);
+  if (summary.tracked == 0)
+    return (0);
+  return ((float)summary.cnoSum / summary.tracked);
+}
@@ -0,0 +1,60 @@
+//The SkySummary is a compact picture of the satellites in one NAV-SAT message. Each satellite block is
+//folded in as the message is parsed: counts, a C/N0 histogram and elevation bins for each constellation,
+//and a short list of positions for a sky view. It replaces the 255 block NAV-SAT struct and its callback
+//copy, which together take over 6KB, with a few hundred bytes.
+
+#ifndef _GNSS_SKY_SUMMARY_H_
+#define _GNSS_SKY_SUMMARY_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+enum class Constellation : uint8_t {
+  GPS = 0,
+  GLONASS,
+  GALILEO,
+  BEIDOU,
+  COUNT
+};
+
+//u-blox gnssId to constellation. -1 for SBAS, QZSS and IMES, which are not counted
+int8_t constellationOf(uint8_t gnssId);
+
+const uint8_t CNO_BINS = 6;           //Below 25, then 5 dB-Hz wide up to 45 and above
+const uint8_t ELEVATION_BINS = 6;     //15 degrees wide
+const uint8_t SKY_MAX_SATELLITES = 48;
+
+struct ConstellationSummary {
+  uint8_t tracked;                   //Signal acquired
+  uint8_t locked;                    //Code locked, so it has observations
+  uint8_t used;                      //Used in the navigation solution
+  uint8_t cno[CNO_BINS];             //Tracked satellites by C/N0
+  uint8_t elevation[ELEVATION_BINS]; //Tracked satellites by elevation
+  uint16_t cnoSum;                   //For the mean C/N0 of tracked satellites
+};
+
+//One tracked satellite, for drawing
+struct SkySatellite {
+  uint8_t gnssId;
+  uint8_t svId;
+  uint8_t cno;   //dB-Hz
+  int8_t elev;   //deg
+  uint8_t azim2; //Azimuth / 2: deg
+  bool used;
+};
+
+struct SkySummary {
+  bool valid;        //False until the first NAV-SAT
+  uint32_t iTOW;     //GPS time of week of the message: ms
+  uint8_t numSvs;    //Satellites in the message, tracked or not
+  ConstellationSummary constellations[(uint8_t)Constellation::COUNT];
+  uint8_t satellites; //Entries in sky
+  SkySatellite sky[SKY_MAX_SATELLITES];
+
+  void clear();
+  void add(const UBX_NAV_SAT_block_t& block);
+  const ConstellationSummary& constellation(Constellation c) const { return constellations[(uint8_t)c]; }
+  float meanCno(Constellation c) const;
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "gnss_telemetry.h"
+
+GNSSTelemetry* GNSSTelemetry::_instance = nullptr;
+
+static const uint8_t MESSAGE_PVT = 0x01;
+static const uint8_t MESSAGE_HPPOSLLH = 0x02;
+static const uint8_t MESSAGE_STATUS = 0x04;
+static const uint8_t ALL_MESSAGES = MESSAGE_PVT | MESSAGE_HPPOSLLH | MESSAGE_STATUS;
+
+//Turn on the automatic navigation messages, delivered through callbacks
+bool GNSSTelemetry::begin(SFE_UBLOX_GNSS& gnss) {
+  _gnss = &gnss;
+  _instance = this;
+
+  bool success = true;
+  success &= _gnss->setAutoPVTcallbackPtr(&_pvtCallback);
+  success &= _gnss->setAutoHPPOSLLHcallbackPtr(&_hpposllhCallback);
+  success &= _gnss->setAutoNAVSTATUScallbackPtr(&_statusCallback);
+  _gnss->setNAVSATblockCallbackPtr(&_navSatBlockCallback); //Output rate is set with the receiver configuration
+  return (success);
+}
+
+//Read the receiver and run the callbacks for any messages that have arrived
+void GNSSTelemetry::update() {
+  if (_gnss == nullptr)
+    return;
+
+  _gnss->checkUblox();
+  _gnss->checkCallbacks();
+}
+
+//Messages are matched into an epoch by iTOW. A message from a new epoch discards any partial one
+void GNSSTelemetry::_startEpoch(uint32_t iTOW) {
+  if (_received != 0 && _working.iTOW == iTOW)
+    return;
+
+  _working.iTOW = iTOW;
+  _received = 0;
+}
+
+//Publish the epoch once all of its messages are in
+void GNSSTelemetry::_messageReceived(uint8_t message) {
+  _received |= message;
+  if (_received != ALL_MESSAGES)
+    return;
+
+  _working.valid = true;
+  _snapshot = _working;
+  _received = 0;
+  _epochs++;
+  _sinceEpoch = 0;
+}
+
+void GNSSTelemetry::_pvtCallback(UBX_NAV_PVT_data_t* data) {
+  GNSSTelemetry* telemetry = _instance;
+  telemetry->_startEpoch(data->iTOW);
+  telemetry->_working.fixType = data->fixType;
+  telemetry->_working.carrSoln = data->flags.bits.carrSoln;
+  telemetry->_working.numSV = data->numSV;
+  telemetry->_messageReceived(MESSAGE_PVT);
+}
+
+void GNSSTelemetry::_hpposllhCallback(UBX_NAV_HPPOSLLH_data_t* data) {
+  GNSSTelemetry* telemetry = _instance;
+  telemetry->_startEpoch(data->iTOW);
+  telemetry->_working.lat = data->lat;
+  telemetry->_working.latHp = data->latHp;
+  telemetry->_working.lon = data->lon;
+  telemetry->_working.lonHp = data->lonHp;
+  telemetry->_working.height = data->height;
+  telemetry->_working.heightHp = data->heightHp;
+  telemetry->_working.hAcc = data->hAcc;
+  telemetry->_working.vAcc = data->vAcc;
+  telemetry->_messageReceived(MESSAGE_HPPOSLLH);
+}
+
+void GNSSTelemetry::_statusCallback(UBX_NAV_STATUS_data_t* data) {
+  GNSSTelemetry* telemetry = _instance;
+  telemetry->_startEpoch(data->iTOW);
+  telemetry->_working.ttff = data->ttff;
+  telemetry->_working.msss = data->msss;
+  telemetry->_messageReceived(MESSAGE_STATUS);
+}
+
+//Called from checkUblox for each satellite block as it arrives, then with no block once the message checksum is
+//good, or with no header either if it was not
+void GNSSTelemetry::_navSatBlockCallback(const UBX_NAV_SAT_header_t* header, const UBX_NAV_SAT_block_t* block) {
+  GNSSTelemetry* telemetry = _instance;
+  SkySummary& working = telemetry->_skyWorking;
+
+  if (header == nullptr) {
+    working.clear();
+    return;
+  }
+
+  if (block != nullptr) {
+    uint32_t start = micros();
+    if (working.numSvs == 0)
+      telemetry->_skyDecode_us = 0; //Summed over the blocks, which may span several checkUblox calls
+    working.add(*block);
+    telemetry->_skyDecode_us += micros() - start;
+    return;
+  }
+
+  working.valid = true;
+  working.iTOW = header->iTOW;
+  telemetry->_sky = working;
+  working.clear();
+}
@@ -0,0 +1,79 @@
+//The GNSSTelemetry service is the one place the rest of the firmware gets navigation data from. It turns
+//on automatic PVT, HPPOSLLH and NAV-STATUS messages and gathers each epoch's messages into a snapshot.
+//Screens read the snapshot, so drawing the UI never causes I2C traffic or a polled UBX request.
+//NAV-SAT is folded into a SkySummary one satellite block at a time, as the blocks arrive, and dropped if the
+//message checksum then fails.
+
+#ifndef _GNSS_TELEMETRY_H_
+#define _GNSS_TELEMETRY_H_
+
+#include <Arduino.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include "gnss_sky_summary.h"
+
+//Navigation solution for one epoch
+struct GNSSSnapshot {
+  bool     valid;    //False until the first epoch has been received
+  uint32_t iTOW;     //GPS time of week of the epoch: ms
+  uint8_t  fixType;  //0 no fix, 2 2D, 3 3D, 4 GNSS + dead reckoning, 5 time only
+  uint8_t  carrSoln; //0 none, 1 RTK float, 2 RTK fixed
+  uint8_t  numSV;    //Satellites used in the solution
+  int32_t  lat;      //deg * 1e-7
+  int8_t   latHp;    //deg * 1e-9
+  int32_t  lon;      //deg * 1e-7
+  int8_t   lonHp;    //deg * 1e-9
+  int32_t  height;   //Height above ellipsoid: mm
+  int8_t   heightHp; //mm * 0.1
+  uint32_t hAcc;     //Horizontal accuracy: mm * 0.1
+  uint32_t vAcc;     //Vertical accuracy: mm * 0.1
+  uint32_t ttff;     //Time to first fix: ms
+  uint32_t msss;     //Time since receiver startup: ms
+};
+
+class GNSSTelemetry {
+public:
+  bool begin(SFE_UBLOX_GNSS& gnss);
+  void update();
+
+  //Latest complete epoch. The first read of each epoch stands in for the poll the getters would have made,
+  //later reads of the same epoch would have been served from the library's cache anyway
+  const GNSSSnapshot& snapshot() {
+    if (_readEpoch != _epochs) {
+      _readEpoch = _epochs;
+      _pollsAvoided++;
+    }
+    return _snapshot;
+  }
+
+  //Latest complete NAV-SAT
+  const SkySummary& sky() { return _sky; }
+  uint32_t skyDecode_us() { return _skyDecode_us; } //Time spent folding in the last NAV-SAT
+
+  uint32_t epochs() { return _epochs; }
+  uint32_t pollsAvoided() { return _pollsAvoided; }
+  uint32_t snapshotAge_ms() { return _sinceEpoch; }
+
+private:
+  static void _pvtCallback(UBX_NAV_PVT_data_t* data);
+  static void _hpposllhCallback(UBX_NAV_HPPOSLLH_data_t* data);
+  static void _statusCallback(UBX_NAV_STATUS_data_t* data);
+  static void _navSatBlockCallback(const UBX_NAV_SAT_header_t* header, const UBX_NAV_SAT_block_t* block);
+  static GNSSTelemetry* _instance; //The SparkFun callbacks carry no context
+
+  void _startEpoch(uint32_t iTOW);
+  void _messageReceived(uint8_t message);
+
+  SFE_UBLOX_GNSS* _gnss = nullptr;
+  GNSSSnapshot _working = {};  //Epoch being assembled
+  GNSSSnapshot _snapshot = {}; //Last complete epoch
+  uint8_t _received = 0;       //Messages received for the working epoch
+  uint32_t _epochs = 0;
+  uint32_t _pollsAvoided = 0; //Epochs the snapshot was read in
+  uint32_t _readEpoch = 0;    //Epoch the snapshot was last read in
+  elapsedMillis _sinceEpoch = 0;
+  SkySummary _skyWorking = {}; //NAV-SAT being folded in
+  SkySummary _sky = {};        //Last complete NAV-SAT
+  uint32_t _skyDecode_us = 0;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "gnss_transport.h"
+
+static const char* PORT_NAMES[] = { "I2C", "UART", "SPI" };
+
+static const uint8_t OUTPUT_KEY_OFFSET[] = { 0, 1, 4 };             //From the I2C key, by port
+static const uint8_t PROTOCOL_GROUP[] = { 0x72, 0x74, 0x7A };       //CFG-I2COUTPROT, CFG-UART1OUTPROT, CFG-SPIOUTPROT
+static const uint16_t BAUD_SETTLE_MS = 100;                         //For the receiver to switch rate
+
+const char* gnssPortName(GNSSPort port) {
+  return (PORT_NAMES[(uint8_t)port]);
+}
+
+bool GNSSTransport::beginI2C(SFE_UBLOX_GNSS& gnss, TwoWire& wire, uint32_t clock_Hz) {
+  _port = GNSSPort::I2C;
+  _clock_Hz = clock_Hz;
+  wire.begin();
+  wire.setClock(clock_Hz);
+  return (gnss.begin(wire));
+}
+
+bool GNSSTransport::beginUART(SFE_UBLOX_GNSS& gnss, HardwareSerial& serial, uint32_t baud) {
+  _port = GNSSPort::UART;
+  _clock_Hz = baud;
+  serial.addMemoryForRead(_rxBuffer, sizeof(_rxBuffer));
+
+  serial.begin(baud);
+  if (gnss.begin(serial))
+    return (true);
+
+  serial.begin(GNSS_UART_DEFAULT_BAUD);
+  if (!gnss.begin(serial))
+    return (false);
+  //The receiver changes rate as it applies the key, so there is no ACK to wait for
+  gnss.setVal32(UBLOX_CFG_UART1_BAUDRATE, baud, VAL_LAYER_RAM | VAL_LAYER_BBR, 0);
+  delay(BAUD_SETTLE_MS);
+  serial.begin(baud);
+  return (gnss.begin(serial));
+}
+
+bool GNSSTransport::beginSPI(SFE_UBLOX_GNSS& gnss, SPIClass& spi, uint8_t csPin, uint32_t clock_Hz,
+                             uint8_t transactionSize) {
+  _port = GNSSPort::SPI;
+  _clock_Hz = clock_Hz;
+  spi.begin();
+  gnss.setSpiTransactionSize(transactionSize);
+  return (gnss.begin(spi, csPin, clock_Hz));
+}
+
+uint32_t GNSSTransport::outputKey(uint32_t i2cKey) {
+  return (i2cKey + OUTPUT_KEY_OFFSET[(uint8_t)_port]);
+}
+
+uint32_t GNSSTransport::protocolKey(uint32_t i2cProtocolKey) {
+  return ((i2cProtocolKey & 0xFF00FFFF) | ((uint32_t)PROTOCOL_GROUP[(uint8_t)_port] << 16));
+}
+
+//I2C: 8 data bits and an ACK, plus start and stop. UART: start, 8 data bits and stop. SPI: 8 data bits
+float GNSSTransport::byteClocks() {
+  return (_port == GNSSPort::I2C ? 9.0 : (_port == GNSSPort::UART ? 10.0 : 8.0));
+}
+
+float GNSSTransport::transactionClocks() {
+  return (_port == GNSSPort::I2C ? 2.0 : 0.0);
+}
@@ -0,0 +1,57 @@
+//The GNSSTransport connects to the receiver over I2C, a UART or SPI, and gives the configuration the keys for
+//that port. Whichever port it is, the same parser and callbacks see what arrives: the SparkFun library reads it a
+//block at a time, a buffered I2C read, whatever the UART has received or one SPI transaction, and parses the block
+//as one span.
+//I2C at 400kHz carries about 44KB/s, and each read blocks in requestFrom for as long as the bytes take to clock.
+//A UART at 921600 baud carries 92KB/s into a receive ring filled by the UART interrupt, so a check only copies out
+//of RAM. SPI carries 8 bits a clock, reads a transaction of a configurable size at a time and needs no polling of
+//a byte count. The ZED-F9P's D_SEL pin chooses between SPI and I2C with UART1, so SPI needs the board strapped for it.
+
+#ifndef _GNSS_TRANSPORT_H_
+#define _GNSS_TRANSPORT_H_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+enum class GNSSPort : uint8_t {
+  I2C,
+  UART,   //The receiver's UART1
+  SPI
+};
+
+const char* gnssPortName(GNSSPort port);
+
+const uint32_t GNSS_UART_DEFAULT_BAUD = 38400;  //UART1 out of the box
+const uint16_t GNSS_UART_RX_BUFFER = 4096;      //Over 40ms of a full 921600 baud port, for loop stalls
+
+class GNSSTransport {
+public:
+  bool beginI2C(SFE_UBLOX_GNSS& gnss, TwoWire& wire, uint32_t clock_Hz = 400000);
+  //Tries baud first, in case the receiver kept it from the last boot, then moves it there from the default
+  bool beginUART(SFE_UBLOX_GNSS& gnss, HardwareSerial& serial, uint32_t baud = 921600);
+  bool beginSPI(SFE_UBLOX_GNSS& gnss, SPIClass& spi, uint8_t csPin, uint32_t clock_Hz = 5500000,
+                uint8_t transactionSize = 128);
+
+  GNSSPort port() { return _port; }
+  const char* name() { return gnssPortName(_port); }
+  uint32_t clock_Hz() { return _clock_Hz; }  //Bus clock, or baud rate
+
+  //Message output rate keys come in a run for each message: I2C, UART1, UART2, USB, SPI. This picks this port's
+  //key from the I2C one
+  uint32_t outputKey(uint32_t i2cKey);
+  //The same for the output protocol keys: CFG-I2COUTPROT-* to CFG-UART1OUTPROT-* or CFG-SPIOUTPROT-*
+  uint32_t protocolKey(uint32_t i2cProtocolKey);
+
+  //Bus clocks a byte and a transaction take, for the bus budget
+  float byteClocks();
+  float transactionClocks();
+
+private:
+  GNSSPort _port = GNSSPort::I2C;
+  uint32_t _clock_Hz = 400000;
+  uint8_t _rxBuffer[GNSS_UART_RX_BUFFER]; //Added to the UART's own receive ring
+};
+
+#endif
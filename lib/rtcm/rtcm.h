@@ -0,0 +1,100 @@
+//The RTCMEncoder builds RTCM 3.3 messages in firmware: MSM4, MSM5 or MSM7 observations from u-blox raw
+//measurements (RXM-RAWX), and the 1005 station position. Each constellation's observations go into one MSM
+//with the satellites and signals in mask order. Which bands are sent can be chosen per constellation, and
+//weak signals can be left out, to fit a slow radio link.
+//Carrier phase is sent relative to the rough range, so each channel carries a whole-cycle offset that is
+//reset, along with its lock time, whenever the phase would no longer fit the field.
+
+#ifndef _RTCM_H_
+#define _RTCM_H_
+
+#include <Arduino.h>
+#include "rtcm_msm.h"
+
+const uint16_t RTCM_MAX_FRAME = 3 + 1023 + 3;     //Preamble and length, payload, CRC-24Q
+const uint8_t RTCM_BAND_1 = 0x01;                 //L1, G1, E1, B1I
+const uint8_t RTCM_BAND_2 = 0x02;                 //L2, G2, E5b, B2I
+const uint8_t RTCM_MAX_CHANNELS = 96;             //Satellite and signal pairs tracked for the phase offset and lock time
+
+//u-blox gnssId
+const uint8_t RTCM_GPS = 0;
+const uint8_t RTCM_GALILEO = 2;
+const uint8_t RTCM_BEIDOU = 3;
+const uint8_t RTCM_GLONASS = 6;
+
+//One signal from one satellite, as in an RXM-RAWX block
+struct RTCMObservation {
+  double   pseudorange_m;
+  double   phase_cycles;
+  float    doppler_Hz;
+  uint8_t  gnssId;
+  uint8_t  svId;
+  uint8_t  sigId;
+  uint8_t  freqId;            //GLONASS frequency slot + 7
+  uint16_t lockTime_ms;       //Carrier phase lock time, saturates at 64.5s
+  uint8_t  cno;               //dB-Hz
+  bool     pseudorangeValid;
+  bool     phaseValid;
+  bool     halfCycleResolved;
+};
+
+//Called for each frame. epoch is the MSM epoch time, or 0 for other messages
+typedef void (*RTCMFrameCallback)(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t epoch);
+
+class RTCMEncoder {
+public:
+  void stationId(uint16_t id) { _stationId = id & 0x0FFF; }
+  void msm(uint8_t type) { _msm = (type == 5 || type == 7) ? type : 4; }
+  uint8_t msm() { return _msm; }
+  void bands(uint8_t gnssId, uint8_t bands);
+  void minCno(uint8_t cno) { _minCno = cno; }
+
+  //One MSM per constellation with observations, in GPS, GLONASS, Galileo, BeiDou order. tow_s is GPS time of
+  //week and leapS the GPS-UTC leap seconds, which GLONASS needs. Returns the number of frames
+  uint8_t encodeEpoch(const RTCMObservation* observations, uint8_t count, double tow_s, int8_t leapS, bool leapValid,
+                      RTCMFrameCallback callback);
+
+  //1005 from the antenna reference point in ECEF meters. Returns the frame length
+  uint16_t encodeStation(double x, double y, double z, bool gps, bool glonass, bool galileo, uint8_t* frame);
+
+  //Wrap a payload in place. The payload starts 3 bytes into frame. Returns the frame length
+  static uint16_t frame(uint8_t* frame, uint16_t payloadLength);
+
+private:
+  struct Channel {
+    uint8_t  gnssId;
+    uint8_t  svId;
+    uint8_t  signal;          //RTCM signal ID. 0 for a free entry
+    uint16_t lastLockTime_ms; //As reported, to spot a slip
+    uint32_t lockStart_ms;    //On the encoder's epoch clock
+    uint32_t lastSeen_ms;
+    double   offset_m;        //Whole cycles taken off the phase
+  };
+
+  struct Cell {
+    const RTCMObservation* observation;
+    double wavelength_m;
+    uint32_t lock_ms;
+    double phase_m;           //Less the channel offset
+  };
+
+  bool _usable(const RTCMObservation& observation);
+  uint16_t _encodeMSM(uint8_t index, const RTCMObservation* observations, uint8_t count, uint32_t epoch, bool more,
+                      uint8_t* frame);
+  Channel* _channel(uint8_t gnssId, uint8_t svId, uint8_t signal, bool& isNew);
+  void _track(Cell& cell, uint8_t signal, double roughRange_m);
+
+  uint16_t _stationId = 0;
+  uint8_t _msm = 4;
+  uint8_t _bands[4] = { RTCM_BAND_1 | RTCM_BAND_2, RTCM_BAND_1 | RTCM_BAND_2, RTCM_BAND_1 | RTCM_BAND_2,
+                        RTCM_BAND_1 | RTCM_BAND_2 }; //GPS, GLONASS, Galileo, BeiDou
+  uint8_t _minCno = 0;
+  uint32_t _time_ms = 0;      //Epoch clock for lock times, carried across the week rollover
+  uint32_t _lastTow_ms = 0;
+  bool _started = false;
+  Channel _channels[RTCM_MAX_CHANNELS] = {};
+  MSMFields _fields;
+  uint8_t _frame[RTCM_MAX_FRAME];
+};
+
+#endif
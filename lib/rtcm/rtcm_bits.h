@@ -0,0 +1,85 @@
+//Big-endian bit packing for RTCM 3 message fields. Bits collect in a 64-bit accumulator and go out a whole
+//byte at a time. Writes past the end of the buffer are dropped and flagged, rather than checked per field.
+//Reads past the end return zeros and are flagged the same way.
+
+#ifndef _RTCM_BITS_H_
+#define _RTCM_BITS_H_
+
+#include <Arduino.h>
+
+class RTCMBitWriter {
+public:
+  RTCMBitWriter(uint8_t* buffer, uint16_t size) : _buffer(buffer), _size(size) {}
+
+  //Up to 32 bits. Signed values go in as two's complement of the field width
+  void put(uint32_t value, uint8_t bits) {
+    _accumulator = (_accumulator << bits) | (value & (0xFFFFFFFFu >> (32 - bits)));
+    _accumulatorBits += bits;
+    while (_accumulatorBits >= 8) {
+      _accumulatorBits -= 8;
+      if (_length < _size)
+        _buffer[_length] = _accumulator >> _accumulatorBits;
+      _length++;
+    }
+  }
+
+  //38-bit ECEF coordinates
+  void put64(int64_t value, uint8_t bits) {
+    put((uint32_t)(value >> 32), bits - 32);
+    put((uint32_t)value, 32);
+  }
+
+  //Pad to a whole byte. Returns the length in bytes
+  uint16_t finish() {
+    if (_accumulatorBits > 0)
+      put(0, 8 - _accumulatorBits);
+    return (_length);
+  }
+
+  bool overflow() { return (_length > _size); }
+
+private:
+  uint8_t* _buffer;
+  uint16_t _size;
+  uint16_t _length = 0;
+  uint64_t _accumulator = 0;
+  uint8_t _accumulatorBits = 0;
+};
+
+class RTCMBitReader {
+public:
+  RTCMBitReader(const uint8_t* buffer, uint16_t size) : _buffer(buffer), _size(size) {}
+
+  //Up to 32 bits
+  uint32_t get(uint8_t bits) {
+    while (_accumulatorBits < bits) {
+      _accumulator = (_accumulator << 8) | (_length < _size ? _buffer[_length] : 0);
+      _length++;
+      _accumulatorBits += 8;
+    }
+    _accumulatorBits -= bits;
+    return ((_accumulator >> _accumulatorBits) & (0xFFFFFFFFu >> (32 - bits)));
+  }
+
+  //Two's complement of the field width
+  int32_t getSigned(uint8_t bits) { return ((int32_t)(get(bits) << (32 - bits)) >> (32 - bits)); }
+
+  uint64_t get64(uint8_t bits) {
+    uint64_t high = (bits > 32) ? get(bits - 32) : 0;
+    return ((high << 32) | get(min(bits, (uint8_t)32)));
+  }
+
+  //Bits read so far
+  uint32_t position() { return (_length * 8 - _accumulatorBits); }
+
+  bool overflow() { return (_length > _size); }
+
+private:
+  const uint8_t* _buffer;
+  uint16_t _size;
+  uint16_t _length = 0;
+  uint64_t _accumulator = 0;
+  uint8_t _accumulatorBits = 0;
+};
+
+#endif
@@ -0,0 +1,487 @@
+#include "rtcm_delta.h"
+#include "rtcm_bits.h"
+#include <checksum.h>
+
+static const uint32_t EPOCH_MASK = 0x3FFFFFFF; //30-bit MSM epoch time
+
+//Fields in the order they are coded. Satellite fields come first, since phase, pseudorange and range rate are
+//predicted as totals on top of their satellite's rough values, and phase comes before the pseudorange it steers
+enum Field : uint8_t { ROUGH, EXTENDED, ROUGH_RATE, PHASE, PSEUDORANGE, LOCK, HALF_CYCLE, CNR, RATE, FIELD_COUNT };
+
+static bool satelliteField(uint8_t field) {
+  return (field <= ROUGH_RATE);
+}
+
+//Extended satellite info and range rates are MSM5 and MSM7 only
+static bool present(uint8_t field, const MSMFields& msm) {
+  return (msm.type() != 4 || (field != EXTENDED && field != ROUGH_RATE && field != RATE));
+}
+
+//Ranges and rates are predicted from the trend of the last two epochs, the rest as unchanged
+static bool trend(uint8_t field) {
+  return (field == ROUGH || field == ROUGH_RATE || field == PSEUDORANGE || field == PHASE || field == RATE);
+}
+
+//The invalid value of each signed field is its most negative one
+static bool isSigned(uint8_t field) {
+  return (field == ROUGH_RATE || field == PSEUDORANGE || field == PHASE || field == RATE);
+}
+
+static uint8_t width(uint8_t field, const MSMFields& msm) {
+  switch (field) {
+    case ROUGH: return (18);
+    case EXTENDED: return (4);
+    case ROUGH_RATE: return (14);
+    case PSEUDORANGE: return (msm.pseudorangeBits());
+    case PHASE: return (msm.phaseBits());
+    case LOCK: return (msm.lockBits());
+    case HALF_CYCLE: return (1);
+    case CNR: return (msm.cnrBits());
+    default: return (15);
+  }
+}
+
+static int32_t get(uint8_t field, const MSMFields& msm, uint8_t index) {
+  switch (field) {
+    case ROUGH: return (msm.rough[index]);
+    case EXTENDED: return (msm.extended[index]);
+    case ROUGH_RATE: return (msm.roughRate[index]);
+    case PSEUDORANGE: return (msm.pseudorange[index]);
+    case PHASE: return (msm.phase[index]);
+    case LOCK: return (msm.lock[index]);
+    case HALF_CYCLE: return (msm.halfCycle[index]);
+    case CNR: return (msm.cnr[index]);
+    default: return (msm.rate[index]);
+  }
+}
+
+static void set(uint8_t field, MSMFields& msm, uint8_t index, int32_t value) {
+  switch (field) {
+    case ROUGH: msm.rough[index] = value; break;
+    case EXTENDED: msm.extended[index] = value; break;
+    case ROUGH_RATE: msm.roughRate[index] = value; break;
+    case PSEUDORANGE: msm.pseudorange[index] = value; break;
+    case PHASE: msm.phase[index] = value; break;
+    case LOCK: msm.lock[index] = value; break;
+    case HALF_CYCLE: msm.halfCycle[index] = value; break;
+    case CNR: msm.cnr[index] = value; break;
+    default: msm.rate[index] = value;
+  }
+}
+
+//What a signal field sits on top of: its satellite's rough range or rate, in the signal field's units
+static int64_t base(uint8_t field, const MSMFields& msm, uint8_t satellite) {
+  switch (field) {
+    case PSEUDORANGE: return ((int64_t)msm.rough[satellite] << (msm.high() ? 19 : 14));
+    case PHASE: return ((int64_t)msm.rough[satellite] << (msm.high() ? 21 : 19));
+    case RATE: return ((int64_t)msm.roughRate[satellite] * 10000);
+    default: return (0);
+  }
+}
+
+static int64_t value(uint8_t field, const MSMFields& msm, const uint8_t* cellSatellite, uint8_t index) {
+  return (get(field, msm, index) + base(field, msm, satelliteField(field) ? index : cellSatellite[index]));
+}
+
+//Whether a past value can be predicted from: neither it nor what it sits on is invalid
+static bool valid(uint8_t field, const MSMFields& msm, const uint8_t* cellSatellite, uint8_t index) {
+  int32_t raw = get(field, msm, index);
+  if (isSigned(field) && raw == -(1 << (width(field, msm) - 1)))
+    return (false);
+  uint8_t satellite = satelliteField(field) ? index : cellSatellite[index];
+  if (field == ROUGH || field == PSEUDORANGE || field == PHASE)
+    return ((int32_t)(msm.rough[satellite] >> 10) != MSM_INVALID_ROUGH_MS);
+  if (field == RATE)
+    return (msm.roughRate[satellite] != MSM_INVALID_ROUGH_RATE);
+  return (true);
+}
+
+//A whole frame whose CRC-24Q checks
+static bool crcValid(const uint8_t* frame, uint16_t length) {
+  if (length < 6)
+    return (false);
+  uint16_t payloadLength = ((frame[1] & 0x03) << 8) | frame[2];
+  if (length != payloadLength + 6)
+    return (false);
+  uint32_t crc = ((uint32_t)frame[3 + payloadLength] << 16) | (frame[4 + payloadLength] << 8) | frame[5 + payloadLength];
+  return (crc24q(frame, 3 + payloadLength) == crc);
+}
+
+static uint8_t bitLength(uint64_t value) {
+  return (value == 0 ? 0 : 64 - __builtin_clzll(value));
+}
+
+RTCMDeltaCodec::Slot* RTCMDeltaCodec::_slot(uint16_t messageNumber) {
+  if (!isMSM(messageNumber))
+    return (nullptr);
+  switch (messageNumber / 10) {
+    case 107: return (&_slots[0]);
+    case 108: return (&_slots[1]);
+    case 109: return (&_slots[2]);
+    case 112: return (&_slots[3]);
+    default: return (nullptr);
+  }
+}
+
+//Where each satellite, signal and cell of the masks is in the field arrays, and the other way round
+void RTCMDeltaCodec::_index(Epoch& epoch) {
+  const MSMFields& msm = epoch.fields;
+  memset(epoch.satellite, -1, sizeof(epoch.satellite));
+  memset(epoch.signal, -1, sizeof(epoch.signal));
+  memset(epoch.cell, -1, sizeof(epoch.cell));
+
+  uint8_t count = 0;
+  for (uint8_t id = 1; id <= 64; id++)
+    if (msm.satelliteMask & (1ull << (64 - id))) {
+      epoch.satellite[id] = count;
+      epoch.satelliteId[count++] = id;
+    }
+
+  uint8_t signalIds[32];
+  count = 0;
+  for (uint8_t id = 1; id <= 32; id++)
+    if (msm.signalMask & (1u << (32 - id))) {
+      epoch.signal[id] = count;
+      signalIds[count++] = id;
+    }
+
+  uint8_t cellBits = msm.satellites * msm.signals;
+  count = 0;
+  for (uint8_t x = 0; x < cellBits; x++)
+    if ((msm.cellMask >> (cellBits - 1 - x)) & 1) {
+      epoch.cell[x] = count;
+      epoch.cellSatellite[count] = x / msm.signals;
+      epoch.cellSignal[count++] = signalIds[x % msm.signals];
+    }
+}
+
+//The same satellite, or satellite and signal, in a past epoch. -1 if it was not there
+int8_t RTCMDeltaCodec::_find(const Epoch& epoch, uint8_t field, uint8_t index) {
+  uint8_t satellite = satelliteField(field) ? index : _current.cellSatellite[index];
+  int8_t s = epoch.satellite[_current.satelliteId[satellite]];
+  if (s < 0 || satelliteField(field))
+    return (s);
+  int8_t g = epoch.signal[_current.cellSignal[index]];
+  if (g < 0)
+    return (-1);
+  return (epoch.cell[s * epoch.fields.signals + g]);
+}
+
+//Prediction of a field of the current epoch. Pseudorange moves with the phase, which is far less noisy than
+//its own trend. Other trends need two evenly spaced epochs behind them, otherwise the last value stands.
+//False if there is nothing to predict from
+bool RTCMDeltaCodec::_predict(const Slot& slot, uint8_t field, uint8_t index, int64_t& prediction) {
+  const Epoch& last = slot.epochs[0];
+  int8_t x = _find(last, field, index);
+  if (x < 0 || !valid(field, last.fields, last.cellSatellite, x))
+    return (false);
+  prediction = value(field, last.fields, last.cellSatellite, x);
+
+  const MSMFields& msm = _current.fields;
+  if (field == PSEUDORANGE && valid(PHASE, last.fields, last.cellSatellite, x) &&
+      valid(PHASE, msm, _current.cellSatellite, index)) {
+    int64_t phaseChange = value(PHASE, msm, _current.cellSatellite, index) - value(PHASE, last.fields, last.cellSatellite, x);
+    prediction += phaseChange >> (msm.high() ? 2 : 5); //Phase in 2^-31 or 2^-29 ms, pseudorange in 2^-29 or 2^-24
+    return (true);
+  }
+
+  if (!trend(field) || slot.count < 2)
+    return (true);
+  const Epoch& before = slot.epochs[1];
+  uint32_t span = (_current.fields.epoch - last.fields.epoch) & EPOCH_MASK;
+  if (span != ((last.fields.epoch - before.fields.epoch) & EPOCH_MASK))
+    return (true);
+  x = _find(before, field, index);
+  if (x >= 0 && valid(field, before.fields, before.cellSatellite, x))
+    prediction += prediction - value(field, before.fields, before.cellSatellite, x);
+  return (true);
+}
+
+//The current epoch starts a new run of deltas
+void RTCMDeltaCodec::_keyframe(Slot& slot) {
+  slot.epochs[0] = _current;
+  slot.count = 1;
+  slot.sinceKeyframe = 0;
+}
+
+void RTCMDeltaCodec::_push(Slot& slot) {
+  slot.epochs[1] = slot.epochs[0];
+  slot.epochs[0] = _current;
+  slot.count = 2;
+  slot.sinceKeyframe++;
+}
+
+//Encoder
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+uint16_t RTCMDeltaEncoder::encode(const uint8_t* frame, uint16_t length, const uint8_t*& out) {
+  out = frame;
+  _stats.bytesIn += length;
+  uint16_t messageNumber = (length > 5) ? (frame[3] << 4) | (frame[4] >> 4) : 0;
+  Slot* slot = _slot(messageNumber);
+  if (slot == nullptr || !parseMSM(frame, length, _current.fields)) {
+    _stats.passed++;
+    _stats.bytesOut += length;
+    return (length);
+  }
+  _index(_current);
+
+  //A keyframe when it is due, when the MSM type has changed, or when the delta would be no smaller
+  bool keyframe = slot->count == 0 || slot->sinceKeyframe + 1 >= _keyframeInterval ||
+                  slot->epochs[0].fields.messageNumber != messageNumber;
+  uint16_t deltaLength = 0;
+  if (!keyframe) {
+    deltaLength = _encodeDelta(*slot);
+    keyframe = deltaLength == 0 || deltaLength >= length;
+  }
+
+  if (keyframe) {
+    _keyframe(*slot);
+    _stats.keyframes++;
+    _stats.bytesOut += length;
+    return (length);
+  }
+  _push(*slot);
+  _stats.deltas++;
+  _stats.bytesOut += deltaLength;
+  out = _frame;
+  return (deltaLength);
+}
+
+//Message number, the epoch predicted from and the time since, then the header and masks if they have changed,
+//then each field
+uint16_t RTCMDeltaEncoder::_encodeDelta(const Slot& slot) {
+  const MSMFields& msm = _current.fields;
+  const MSMFields& last = slot.epochs[0].fields;
+  RTCMBitWriter bits(_frame + 3, RTCM_MAX_FRAME - 6);
+  bits.put(RTCM_DELTA_MESSAGE, 12);
+  bits.put(msm.messageNumber, 12);
+  bits.put(last.epoch & 0xFFFF, 16);
+
+  uint32_t span = (msm.epoch - last.epoch) & EPOCH_MASK;
+  uint8_t spanBits = bitLength(span);
+  bits.put(spanBits, 5);
+  if (spanBits > 0)
+    bits.put(span, spanBits);
+
+  bool sameHeader = msm.stationId == last.stationId && msm.flags == last.flags;
+  bits.put(sameHeader, 1);
+  if (!sameHeader) {
+    bits.put(msm.stationId, 12);
+    bits.put(msm.flags, 19);
+  }
+
+  bool sameMasks = msm.satelliteMask == last.satelliteMask && msm.signalMask == last.signalMask &&
+                   msm.cellMask == last.cellMask;
+  bits.put(sameMasks, 1);
+  if (!sameMasks) {
+    bits.put64(msm.satelliteMask, 64);
+    bits.put(msm.signalMask, 32);
+    uint8_t cellBits = msm.satellites * msm.signals;
+    if (cellBits > 32)
+      bits.put(msm.cellMask >> 32, cellBits - 32);
+    bits.put(msm.cellMask, min(cellBits, (uint8_t)32));
+  }
+
+  for (uint8_t field = 0; field < FIELD_COUNT; field++)
+    if (present(field, msm))
+      _writeField(bits, slot, field);
+
+  uint16_t length = bits.finish();
+  if (bits.overflow())
+    return (0);
+  return (RTCMEncoder::frame(_frame, length));
+}
+
+//Residuals as zigzag integers in the width that costs least over the message. All ones escapes to the field as
+//it is, and a width of 0 means every residual is 0. Entries with nothing to predict from go as they are
+void RTCMDeltaEncoder::_writeField(RTCMBitWriter& bits, const Slot& slot, uint8_t field) {
+  const MSMFields& msm = _current.fields;
+  uint8_t count = satelliteField(field) ? msm.satellites : msm.cells;
+  uint8_t fieldBits = width(field, msm);
+
+  bool predicted[64];
+  uint64_t zigzag[64];
+  uint8_t lengths[65] = {};
+  uint8_t allOnes[65] = {};
+  uint8_t predictions = 0;
+  for (uint8_t x = 0; x < count; x++) {
+    int64_t prediction;
+    predicted[x] = _predict(slot, field, x, prediction);
+    if (!predicted[x])
+      continue;
+    int64_t residual = value(field, msm, _current.cellSatellite, x) - prediction;
+    zigzag[x] = ((uint64_t)residual << 1) ^ (uint64_t)(residual >> 63);
+    uint8_t length = bitLength(zigzag[x]);
+    lengths[length]++;
+    if (length > 0 && zigzag[x] == (~0ull >> (64 - length)))
+      allOnes[length]++;
+    predictions++;
+  }
+
+  uint8_t best = 0;
+  if (predictions > 0) {
+    uint32_t bestCost = (lengths[0] == predictions) ? 0 : UINT32_MAX;
+    uint8_t longer = predictions - lengths[0];
+    for (uint8_t w = 1; w < 32 && bestCost > 0; w++) {
+      longer -= lengths[w];
+      uint32_t cost = predictions * w + (longer + allOnes[w]) * fieldBits;
+      if (cost < bestCost) {
+        bestCost = cost;
+        best = w;
+      }
+    }
+    bits.put(best, 5);
+  }
+
+  uint32_t escape = (1u << best) - 1;
+  for (uint8_t x = 0; x < count; x++) {
+    if (predicted[x] && best == 0)
+      continue;
+    if (predicted[x] && zigzag[x] < escape) {
+      bits.put(zigzag[x], best);
+      continue;
+    }
+    if (predicted[x])
+      bits.put(escape, best);
+    bits.put(get(field, msm, x), fieldBits);
+  }
+}
+
+void RTCMDeltaEncoder::printStatus(Print& out) {
+  float saved = _stats.bytesIn > 0 ? 100.0 * (1.0 - (float)_stats.bytesOut / _stats.bytesIn) : 0;
+  out.printf("RTCM delta: %lu keyframes, %lu deltas, %lu other, %lu bytes in, %lu out, %.1f%% saved\r\n",
+             _stats.keyframes, _stats.deltas, _stats.passed, _stats.bytesIn, _stats.bytesOut, saved);
+}
+
+//Decoder
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+uint16_t RTCMDeltaDecoder::decode(const uint8_t* frame, uint16_t length, const uint8_t*& out) {
+  out = frame;
+  _stats.bytesIn += length;
+  uint16_t messageNumber = (length > 5) ? (frame[3] << 4) | (frame[4] >> 4) : 0;
+  if (messageNumber == RTCM_DELTA_MESSAGE) {
+    uint16_t standardLength = _decodeDelta(frame, length);
+    if (standardLength == 0) {
+      _stats.dropped++;
+      return (0);
+    }
+    _stats.deltas++;
+    _stats.bytesOut += standardLength;
+    out = _frame;
+    return (standardLength);
+  }
+
+  //An MSM as it is starts a new run of deltas. A damaged one still goes on, for the receiver to reject, but the
+  //deltas after it were predicted from it, so nothing may be built until the next keyframe
+  Slot* slot = _slot(messageNumber);
+  bool damaged = slot != nullptr && !crcValid(frame, length);
+  if (slot != nullptr && !damaged && parseMSM(frame, length, _current.fields)) {
+    _index(_current);
+    _keyframe(*slot);
+    _stats.keyframes++;
+  }
+  else {
+    if (damaged)
+      slot->count = 0;
+    _stats.passed++;
+  }
+  _stats.bytesOut += length;
+  return (length);
+}
+
+//The standard frame in _frame. Returns its length, or 0 if the delta is damaged or not built on the last epoch
+uint16_t RTCMDeltaDecoder::_decodeDelta(const uint8_t* frame, uint16_t length) {
+  if (!crcValid(frame, length))
+    return (0);
+  uint16_t payloadLength = ((frame[1] & 0x03) << 8) | frame[2];
+
+  RTCMBitReader bits(frame + 3, payloadLength);
+  bits.get(12);
+  uint16_t messageNumber = bits.get(12);
+  uint16_t reference = bits.get(16);
+  Slot* slot = _slot(messageNumber);
+  if (slot == nullptr || slot->count == 0)
+    return (0);
+  const MSMFields& last = slot->epochs[0].fields;
+  if (last.messageNumber != messageNumber || (last.epoch & 0xFFFF) != reference)
+    return (0);
+
+  MSMFields& msm = _current.fields;
+  msm.messageNumber = messageNumber;
+  uint8_t spanBits = bits.get(5);
+  msm.epoch = (last.epoch + (spanBits > 0 ? bits.get(spanBits) : 0)) & EPOCH_MASK;
+
+  if (bits.get(1)) {
+    msm.stationId = last.stationId;
+    msm.flags = last.flags;
+  }
+  else {
+    msm.stationId = bits.get(12);
+    msm.flags = bits.get(19);
+  }
+
+  if (bits.get(1)) {
+    msm.satelliteMask = last.satelliteMask;
+    msm.signalMask = last.signalMask;
+    msm.cellMask = last.cellMask;
+  }
+  else {
+    msm.satelliteMask = bits.get64(64);
+    msm.signalMask = bits.get(32);
+    uint16_t cellBits = __builtin_popcountll(msm.satelliteMask) * __builtin_popcount(msm.signalMask);
+    if (cellBits == 0 || cellBits > 64)
+      return (0);
+    msm.cellMask = bits.get64(cellBits);
+  }
+  msm.satellites = __builtin_popcountll(msm.satelliteMask);
+  msm.signals = __builtin_popcount(msm.signalMask);
+  msm.cells = __builtin_popcountll(msm.cellMask);
+  _index(_current);
+
+  for (uint8_t field = 0; field < FIELD_COUNT; field++)
+    if (present(field, msm))
+      _readField(bits, *slot, field);
+  if (bits.overflow())
+    return (0);
+
+  uint16_t standardLength = packMSM(msm, _frame);
+  if (standardLength > 0)
+    _push(*slot);
+  return (standardLength);
+}
+
+void RTCMDeltaDecoder::_readField(RTCMBitReader& bits, const Slot& slot, uint8_t field) {
+  MSMFields& msm = _current.fields;
+  uint8_t count = satelliteField(field) ? msm.satellites : msm.cells;
+  uint8_t fieldBits = width(field, msm);
+
+  bool predicted[64];
+  int64_t prediction[64];
+  uint8_t predictions = 0;
+  for (uint8_t x = 0; x < count; x++) {
+    predicted[x] = _predict(slot, field, x, prediction[x]);
+    predictions += predicted[x];
+  }
+
+  uint8_t best = (predictions > 0) ? bits.get(5) : 0;
+  uint32_t escape = (1u << best) - 1;
+  for (uint8_t x = 0; x < count; x++) {
+    if (predicted[x]) {
+      uint32_t zigzag = (best > 0) ? bits.get(best) : 0;
+      if (best == 0 || zigzag != escape) {
+        int64_t residual = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        uint8_t satellite = satelliteField(field) ? x : _current.cellSatellite[x];
+        set(field, msm, x, prediction[x] + residual - base(field, msm, satellite));
+        continue;
+      }
+    }
+    set(field, msm, x, isSigned(field) ? bits.getSigned(fieldBits) : (int32_t)bits.get(fieldBits));
+  }
+}
+
+void RTCMDeltaDecoder::printStatus(Print& out) {
+  out.printf("RTCM delta: %lu keyframes, %lu deltas, %lu dropped, %lu other, %lu bytes in, %lu out\r\n",
+             _stats.keyframes, _stats.deltas, _stats.dropped, _stats.passed, _stats.bytesIn, _stats.bytesOut);
+}
@@ -0,0 +1,98 @@
+//Delta compression of MSM observations for a slow radio link.
+//The RTCMDeltaEncoder at the base sends each constellation's MSM as it is every so many epochs, a keyframe, and
+//the epochs in between as deltas: every field as its difference from a prediction made from the epochs before.
+//Pseudorange, phase and range rate are predicted as totals, rough plus fine, so a step in the rough range costs
+//nothing. The residuals of a field share one width per message, with an escape for the odd value that does not
+//fit, and a field with nothing to predict from goes as it is.
+//The RTCMDeltaDecoder at the rover rebuilds the standard MSM bit for bit. Each delta names the epoch it was
+//predicted from, so after a lost frame the decoder drops deltas until the next keyframe rather than build a wrong
+//one. Deltas go in RTCM frames of their own, under a proprietary message number, so the link sees ordinary RTCM.
+//Everything other than MSM4, MSM5 and MSM7 of GPS, GLONASS, Galileo and BeiDou passes through both ends.
+//Each end holds nine epochs of about 1.8KB, two for each constellation and the one being coded, and a frame:
+//about 17KB an instance. Make them global, never on the stack.
+
+#ifndef _RTCM_DELTA_H_
+#define _RTCM_DELTA_H_
+
+#include <Arduino.h>
+#include "rtcm.h"
+
+class RTCMBitWriter;
+class RTCMBitReader;
+
+const uint16_t RTCM_DELTA_MESSAGE = 4001;         //Proprietary range 4001 to 4095
+const uint8_t RTCM_DELTA_KEYFRAME_INTERVAL = 10;  //Epochs
+
+struct RTCMDeltaStats {
+  uint32_t keyframes;
+  uint32_t deltas;
+  uint32_t dropped;   //Decoder: deltas with no epoch to build on
+  uint32_t passed;    //Other messages
+  uint32_t bytesIn;
+  uint32_t bytesOut;
+};
+
+class RTCMDeltaCodec {
+public:
+  RTCMDeltaStats stats() { return (_stats); }
+
+protected:
+  struct Epoch {
+    MSMFields fields;
+    int8_t  satellite[65];      //Index by satellite ID, -1 if absent
+    int8_t  signal[33];         //Index by signal ID
+    int8_t  cell[64];           //Index by position in the cell mask
+    uint8_t satelliteId[64];    //By satellite index
+    uint8_t cellSatellite[64];  //By cell index
+    uint8_t cellSignal[64];
+  };
+
+  //The last two epochs of one constellation's MSM, newest first
+  struct Slot {
+    Epoch epochs[2];
+    uint8_t count;
+    uint8_t sinceKeyframe;
+  };
+
+  Slot* _slot(uint16_t messageNumber);
+  static void _index(Epoch& epoch);
+  int8_t _find(const Epoch& epoch, uint8_t field, uint8_t index);
+  bool _predict(const Slot& slot, uint8_t field, uint8_t index, int64_t& prediction);
+  void _keyframe(Slot& slot);
+  void _push(Slot& slot);
+
+  Slot _slots[4] = {};          //GPS, GLONASS, Galileo, BeiDou
+  Epoch _current;
+  uint8_t _frame[RTCM_MAX_FRAME];
+  RTCMDeltaStats _stats = {};
+};
+
+class RTCMDeltaEncoder : public RTCMDeltaCodec {
+public:
+  void keyframeInterval(uint8_t epochs) { _keyframeInterval = max(epochs, (uint8_t)1); }
+
+  //A whole frame in, the frame to send out: a delta, or the frame itself. Returns its length
+  uint16_t encode(const uint8_t* frame, uint16_t length, const uint8_t*& out);
+
+  void printStatus(Print& out);
+
+private:
+  uint16_t _encodeDelta(const Slot& slot);
+  void _writeField(RTCMBitWriter& bits, const Slot& slot, uint8_t field);
+
+  uint8_t _keyframeInterval = RTCM_DELTA_KEYFRAME_INTERVAL;
+};
+
+class RTCMDeltaDecoder : public RTCMDeltaCodec {
+public:
+  //A whole frame in, the standard frame out. Returns its length, or 0 for a delta that could not be applied
+  uint16_t decode(const uint8_t* frame, uint16_t length, const uint8_t*& out);
+
+  void printStatus(Print& out);
+
+private:
+  uint16_t _decodeDelta(const uint8_t* frame, uint16_t length);
+  void _readField(RTCMBitReader& bits, const Slot& slot, uint8_t field);
+};
+
+#endif
@@ -0,0 +1,333 @@
+#include "rtcm.h"
+
+static const double SPEED_OF_LIGHT = 299792458.0;      //m/s
+static const double RANGE_MS = SPEED_OF_LIGHT * 0.001; //Meters per light millisecond
+static const double P2_10 = 1.0 / (1 << 10);
+static const double P2_24 = 1.0 / (1 << 24);
+static const double P2_29 = 1.0 / (1 << 29);
+static const double P2_31 = 1.0 / (1u << 31);
+static const double PHASE_LIMIT_M = 1171.0;      //Fine phase range is +/-2^-8 light ms
+static const uint32_t WEEK_MS = 604800000;
+static const uint32_t DAY_MS = 86400000;
+static const uint32_t MOSCOW_OFFSET_MS = 10800000; //GLONASS time is UTC + 3h
+static const uint32_t BEIDOU_OFFSET_MS = 14000;    //BDT is GPS time - 14s
+static const uint32_t LOCK_GAP_MS = 1000;          //A channel missing for longer than this has lost lock
+static const uint32_t CHANNEL_STALE_MS = 10000;    //A channel missing for longer than this can be reused
+
+//u-blox sigId to RTCM signal ID and band. Signal IDs from RTCM 10403.3 tables 3.5-91 to 3.5-108.
+//Each band goes out as one RTCM signal. Where the receiver reports two components of a band, they share that
+//signal and the one listed first, the pilot, fills the cell. A channel's phase then never jumps between components
+struct SignalMap {
+  uint8_t gnssId;
+  uint8_t sigId;
+  uint8_t signal;
+  uint8_t band;
+};
+
+static const SignalMap SIGNALS[] = {
+  { RTCM_GPS, 0, 2, RTCM_BAND_1 },      //L1 C/A: 1C
+  { RTCM_GPS, 3, 16, RTCM_BAND_2 },     //L2 CL: 2L
+  { RTCM_GPS, 4, 16, RTCM_BAND_2 },     //L2 CM: 2L
+  { RTCM_GLONASS, 0, 2, RTCM_BAND_1 },  //L1 OF: 1C
+  { RTCM_GLONASS, 2, 8, RTCM_BAND_2 },  //L2 OF: 2C
+  { RTCM_GALILEO, 0, 2, RTCM_BAND_1 },  //E1 C: 1C
+  { RTCM_GALILEO, 1, 2, RTCM_BAND_1 },  //E1 B: 1C
+  { RTCM_GALILEO, 6, 15, RTCM_BAND_2 }, //E5b Q: 7Q
+  { RTCM_GALILEO, 5, 15, RTCM_BAND_2 }, //E5b I: 7Q
+  { RTCM_BEIDOU, 0, 2, RTCM_BAND_1 },   //B1I D1: 2I
+  { RTCM_BEIDOU, 1, 2, RTCM_BAND_1 },   //B1I D2: 2I
+  { RTCM_BEIDOU, 2, 14, RTCM_BAND_2 },  //B2I D1: 7I
+  { RTCM_BEIDOU, 3, 14, RTCM_BAND_2 },  //B2I D2: 7I
+};
+
+//MSM order, which is also the Constellation order used for the band selection
+static const uint8_t CONSTELLATIONS[] = { RTCM_GPS, RTCM_GLONASS, RTCM_GALILEO, RTCM_BEIDOU };
+static const uint16_t MESSAGE_BASE[] = { 1070, 1080, 1090, 1120 };
+
+static int8_t constellationIndex(uint8_t gnssId) {
+  for (uint8_t x = 0; x < sizeof(CONSTELLATIONS); x++)
+    if (CONSTELLATIONS[x] == gnssId)
+      return (x);
+  return (-1);
+}
+
+static const SignalMap* signalOf(uint8_t gnssId, uint8_t sigId) {
+  for (const SignalMap& map : SIGNALS)
+    if (map.gnssId == gnssId && map.sigId == sigId)
+      return (&map);
+  return (nullptr);
+}
+
+static double wavelength(uint8_t gnssId, uint8_t band, uint8_t freqId) {
+  double frequency;
+  switch (gnssId) {
+    case RTCM_GPS: frequency = (band == RTCM_BAND_1) ? 1575.42e6 : 1227.60e6; break;
+    case RTCM_GALILEO: frequency = (band == RTCM_BAND_1) ? 1575.42e6 : 1207.14e6; break;
+    case RTCM_BEIDOU: frequency = (band == RTCM_BAND_1) ? 1561.098e6 : 1207.14e6; break;
+    default: //GLONASS FDMA, by frequency channel
+      int8_t k = freqId - 7;
+      frequency = (band == RTCM_BAND_1) ? 1602.0e6 + k * 0.5625e6 : 1246.0e6 + k * 0.4375e6;
+  }
+  return (SPEED_OF_LIGHT / frequency);
+}
+
+//DF402: 4-bit lock time indicator, doubling from 32ms
+static uint8_t lockIndicator(uint32_t lock_ms) {
+  uint8_t indicator = 0;
+  while (indicator < 15 && lock_ms >= (32u << indicator))
+    indicator++;
+  return (indicator);
+}
+
+//DF407: 10-bit lock time indicator, 1ms steps for the first 64ms then doubling every 32 steps
+static uint16_t lockIndicatorExtended(uint32_t lock_ms) {
+  if (lock_ms < 64)
+    return (lock_ms);
+  uint8_t n = 0;
+  while (n < 20 && lock_ms >= (128u << n))
+    n++;
+  if (n == 20)
+    return (704);
+  return (64 + n * 32 + (lock_ms - (64u << n)) / (2u << n));
+}
+
+//Value to a signed field of the given width, or the field's invalid value if it does not fit
+static int32_t field(double value, uint8_t bits) {
+  int32_t limit = (1 << (bits - 1)) - 1;
+  if (!(fabs(value) <= limit))
+    return (-limit - 1);
+  return ((int32_t)lround(value));
+}
+
+void RTCMEncoder::bands(uint8_t gnssId, uint8_t bands) {
+  int8_t index = constellationIndex(gnssId);
+  if (index >= 0)
+    _bands[index] = bands;
+}
+
+//Whether an observation would go into its constellation's MSM
+bool RTCMEncoder::_usable(const RTCMObservation& observation) {
+  int8_t index = constellationIndex(observation.gnssId);
+  const SignalMap* map = signalOf(observation.gnssId, observation.sigId);
+  if (index < 0 || map == nullptr || (_bands[index] & map->band) == 0)
+    return (false);
+  if (observation.svId < 1 || observation.svId > 64 || !observation.pseudorangeValid || observation.cno < _minCno)
+    return (false);
+  return (observation.gnssId != RTCM_GLONASS || observation.freqId <= 13);
+}
+
+uint8_t RTCMEncoder::encodeEpoch(const RTCMObservation* observations, uint8_t count, double tow_s, int8_t leapS,
+                                 bool leapValid, RTCMFrameCallback callback) {
+  uint32_t tow_ms = (uint32_t)llround(tow_s * 1000.0) % WEEK_MS;
+  if (_started)
+    _time_ms += (tow_ms + WEEK_MS - _lastTow_ms) % WEEK_MS;
+  _started = true;
+  _lastTow_ms = tow_ms;
+
+  //Epoch time in each constellation's own time system. GLONASS is day of week and time of day, from UTC
+  uint32_t moscow_ms = (tow_ms + WEEK_MS - leapS * 1000 + MOSCOW_OFFSET_MS) % WEEK_MS;
+  uint32_t epochs[] = { tow_ms, ((moscow_ms / DAY_MS) << 27) | (moscow_ms % DAY_MS), tow_ms,
+                        (tow_ms + WEEK_MS - BEIDOU_OFFSET_MS) % WEEK_MS };
+
+  //The multiple message bit is set on all but the last MSM of the epoch
+  bool present[sizeof(CONSTELLATIONS)] = {};
+  for (uint8_t x = 0; x < count; x++)
+    if (_usable(observations[x]))
+      present[constellationIndex(observations[x].gnssId)] = true;
+  if (!leapValid)
+    present[1] = false;
+  int8_t last = -1;
+  for (uint8_t x = 0; x < sizeof(CONSTELLATIONS); x++)
+    if (present[x])
+      last = x;
+
+  uint8_t frames = 0;
+  for (int8_t x = 0; x <= last; x++) {
+    if (!present[x])
+      continue;
+    uint16_t length = _encodeMSM(x, observations, count, epochs[x], x != last, _frame);
+    if (length == 0)
+      continue;
+    callback(_frame, length, MESSAGE_BASE[x] + _msm, epochs[x]);
+    frames++;
+  }
+  return (frames);
+}
+
+//Find the channel for a satellite and signal, or take a free or stale one
+RTCMEncoder::Channel* RTCMEncoder::_channel(uint8_t gnssId, uint8_t svId, uint8_t signal, bool& isNew) {
+  Channel* free = nullptr;
+  for (Channel& channel : _channels) {
+    if (channel.signal == signal && channel.svId == svId && channel.gnssId == gnssId) {
+      isNew = false;
+      return (&channel);
+    }
+    if (free == nullptr && (channel.signal == 0 || _time_ms - channel.lastSeen_ms > CHANNEL_STALE_MS))
+      free = &channel;
+  }
+  if (free != nullptr) {
+    free->gnssId = gnssId;
+    free->svId = svId;
+    free->signal = signal;
+  }
+  isNew = true;
+  return (free);
+}
+
+//Phase relative to the rough range, less the channel's whole-cycle offset, and the lock time to go with it.
+//The offset, and so the lock time, restarts when the channel is new or the phase has drifted out of range
+void RTCMEncoder::_track(Cell& cell, uint8_t signal, double roughRange_m) {
+  const RTCMObservation& observation = *cell.observation;
+  double relative_m = observation.phase_cycles * cell.wavelength_m - roughRange_m;
+
+  bool isNew;
+  Channel* channel = _channel(observation.gnssId, observation.svId, signal, isNew);
+  if (channel == nullptr) {
+    cell.phase_m = relative_m - round(relative_m / cell.wavelength_m) * cell.wavelength_m;
+    cell.lock_ms = 0;
+    return;
+  }
+
+  //Lock lost in the receiver, or the channel has been missing: lock restarts when the receiver says it did
+  if (!isNew && (observation.lockTime_ms < channel->lastLockTime_ms || _time_ms - channel->lastSeen_ms > LOCK_GAP_MS)) {
+    uint32_t start = _time_ms - observation.lockTime_ms;
+    if ((int32_t)(start - channel->lockStart_ms) > 0)
+      channel->lockStart_ms = start;
+  }
+  channel->lastLockTime_ms = observation.lockTime_ms;
+  channel->lastSeen_ms = _time_ms;
+
+  if (isNew || fabs(relative_m - channel->offset_m) > PHASE_LIMIT_M) {
+    channel->offset_m = round(relative_m / cell.wavelength_m) * cell.wavelength_m;
+    channel->lockStart_ms = _time_ms;
+  }
+  cell.phase_m = relative_m - channel->offset_m;
+  cell.lock_ms = _time_ms - channel->lockStart_ms;
+}
+
+//One constellation's MSM: header with the satellite, signal and cell masks, then the satellite data and the
+//signal data, each a field at a time across all satellites or cells. RTCM 10403.3 section 3.5.12
+uint16_t RTCMEncoder::_encodeMSM(uint8_t index, const RTCMObservation* observations, uint8_t count, uint32_t epoch,
+                                 bool more, uint8_t* frame) {
+  uint8_t gnssId = CONSTELLATIONS[index];
+
+  //Satellites and signals present, in mask order
+  uint64_t satelliteMask = 0;
+  uint32_t signalMask = 0;
+  for (uint8_t x = 0; x < count; x++) {
+    const RTCMObservation& observation = observations[x];
+    if (observation.gnssId != gnssId || !_usable(observation))
+      continue;
+    satelliteMask |= 1ull << (64 - observation.svId);
+    signalMask |= 1u << (32 - signalOf(gnssId, observation.sigId)->signal);
+  }
+
+  uint8_t signals[32];
+  uint8_t signalCount = 0;
+  int8_t signalIndex[33];
+  for (uint8_t signal = 1; signal <= 32; signal++) {
+    signalIndex[signal] = -1;
+    if (signalMask & (1u << (32 - signal))) {
+      signalIndex[signal] = signalCount;
+      signals[signalCount++] = signal;
+    }
+  }
+  if (signalCount == 0)
+    return (0);
+
+  //At most 64 cells. Any satellites past that are left out
+  uint8_t maxSatellites = 64 / signalCount;
+  uint8_t satelliteCount = 0;
+  int8_t satelliteIndex[65];
+  for (uint8_t svId = 1; svId <= 64; svId++) {
+    satelliteIndex[svId] = -1;
+    if ((satelliteMask & (1ull << (64 - svId))) == 0)
+      continue;
+    if (satelliteCount == maxSatellites) {
+      satelliteMask &= ~(1ull << (64 - svId));
+      continue;
+    }
+    satelliteIndex[svId] = satelliteCount++;
+  }
+
+  Cell cells[64] = {};
+  for (uint8_t x = 0; x < count; x++) {
+    const RTCMObservation& observation = observations[x];
+    if (observation.gnssId != gnssId || !_usable(observation) || satelliteIndex[observation.svId] < 0)
+      continue;
+    const SignalMap* map = signalOf(gnssId, observation.sigId);
+    Cell& cell = cells[satelliteIndex[observation.svId] * signalCount + signalIndex[map->signal]];
+    if (cell.observation == nullptr || map < signalOf(gnssId, cell.observation->sigId)) {
+      cell.observation = &observation;
+      cell.wavelength_m = wavelength(gnssId, map->band, observation.freqId);
+    }
+  }
+
+  //Rough range and range rate from each satellite's first signal, rounded to what the fields carry
+  MSMFields& msm = _fields;
+  msm.messageNumber = MESSAGE_BASE[index] + _msm;
+  msm.stationId = _stationId;
+  msm.epoch = epoch;
+  msm.flags = (more << 18) | (2 << 6); //IODS 0, clock steering unknown, internal clock, no smoothing
+  msm.satelliteMask = satelliteMask;
+  msm.signalMask = signalMask;
+  msm.satellites = satelliteCount;
+  msm.signals = signalCount;
+
+  double roughRange_m[64];
+  double roughRate[64];
+  for (uint8_t s = 0; s < satelliteCount; s++) {
+    const Cell* first = &cells[s * signalCount];
+    while (first->observation == nullptr)
+      first++;
+    double rough_ms = round(first->observation->pseudorange_m / RANGE_MS / P2_10) * P2_10;
+    if (rough_ms > 0 && rough_ms < MSM_INVALID_ROUGH_MS)
+      msm.rough[s] = lround(rough_ms / P2_10);
+    else
+      msm.rough[s] = MSM_INVALID_ROUGH_MS << 10;
+    roughRange_m[s] = rough_ms * RANGE_MS;
+    roughRate[s] = round(-first->observation->doppler_Hz * first->wavelength_m);
+    msm.roughRate[s] = field(roughRate[s], 14);
+    msm.extended[s] = gnssId == RTCM_GLONASS ? first->observation->freqId : 0;
+  }
+
+  //Signal fields, at MSM4/5 or MSM7 resolution
+  bool high = msm.high();
+  double prResolution = high ? P2_29 : P2_24;
+  double phaseResolution = high ? P2_31 : P2_29;
+
+  uint8_t cellCount = 0;
+  uint64_t cellMask = 0;
+  uint8_t cellBits = satelliteCount * signalCount;
+  for (uint8_t c = 0; c < cellBits; c++) {
+    Cell& cell = cells[c];
+    if (cell.observation == nullptr)
+      continue;
+    cellMask |= 1ull << (cellBits - 1 - c);
+    const RTCMObservation& observation = *cell.observation;
+    uint8_t s = c / signalCount;
+    bool roughValid = (msm.rough[s] >> 10) != MSM_INVALID_ROUGH_MS;
+
+    double pr_ms = (observation.pseudorange_m - roughRange_m[s]) / RANGE_MS;
+    msm.pseudorange[cellCount] = field(roughValid ? pr_ms / prResolution : NAN, msm.pseudorangeBits());
+
+    if (observation.phaseValid && roughValid) {
+      _track(cell, signals[c % signalCount], roughRange_m[s]);
+      msm.phase[cellCount] = field(cell.phase_m / RANGE_MS / phaseResolution, msm.phaseBits());
+      msm.halfCycle[cellCount] = !observation.halfCycleResolved;
+    }
+    else {
+      msm.phase[cellCount] = field(NAN, msm.phaseBits());
+      msm.halfCycle[cellCount] = 0;
+    }
+    msm.lock[cellCount] = high ? lockIndicatorExtended(cell.lock_ms) : lockIndicator(cell.lock_ms);
+    msm.cnr[cellCount] = high ? min(observation.cno * 16, 1023) : min(observation.cno, (uint8_t)63);
+    double rate = -observation.doppler_Hz * cell.wavelength_m;
+    msm.rate[cellCount] = field(msm.roughRate[s] == MSM_INVALID_ROUGH_RATE ? NAN : (rate - roughRate[s]) / 0.0001, 15);
+    cellCount++;
+  }
+  msm.cellMask = cellMask;
+  msm.cells = cellCount;
+
+  return (packMSM(msm, frame));
+}
@@ -0,0 +1,107 @@
+#include "rtcm.h"
+#include "rtcm_msm.h"
+#include "rtcm_bits.h"
+
+bool isMSM(uint16_t messageNumber) {
+  uint8_t type = messageNumber % 10;
+  return (messageNumber >= 1070 && messageNumber < 1140 && (type == 4 || type == 5 || type == 7));
+}
+
+bool parseMSM(const uint8_t* frame, uint16_t length, MSMFields& msm) {
+  if (length < 6 || frame[0] != 0xD3 || (frame[1] & 0xFC) != 0)
+    return (false);
+  uint16_t payloadLength = ((frame[1] & 0x03) << 8) | frame[2];
+  if (length != payloadLength + 6)
+    return (false);
+
+  RTCMBitReader bits(frame + 3, payloadLength);
+  msm.messageNumber = bits.get(12);
+  if (!isMSM(msm.messageNumber))
+    return (false);
+  msm.stationId = bits.get(12);
+  msm.epoch = bits.get(30);
+  msm.flags = bits.get(19);
+  msm.satelliteMask = bits.get64(64);
+  msm.signalMask = bits.get(32);
+  msm.satellites = __builtin_popcountll(msm.satelliteMask);
+  msm.signals = __builtin_popcount(msm.signalMask);
+  uint16_t cellBits = msm.satellites * msm.signals;
+  if (cellBits == 0 || cellBits > 64)
+    return (false);
+  msm.cellMask = bits.get64(cellBits);
+  msm.cells = __builtin_popcountll(msm.cellMask);
+
+  bool extended = msm.type() != 4;
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    msm.rough[s] = bits.get(8) << 10;
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    msm.extended[s] = extended ? bits.get(4) : 0;
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    msm.rough[s] |= bits.get(10);
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    msm.roughRate[s] = extended ? bits.getSigned(14) : 0;
+
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.pseudorange[c] = bits.getSigned(msm.pseudorangeBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.phase[c] = bits.getSigned(msm.phaseBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.lock[c] = bits.get(msm.lockBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.halfCycle[c] = bits.get(1);
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.cnr[c] = bits.get(msm.cnrBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    msm.rate[c] = extended ? bits.getSigned(15) : 0;
+
+  //Exactly the payload, padded with zeros
+  uint32_t used = bits.position();
+  if (bits.overflow() || (used + 7) / 8 != payloadLength)
+    return (false);
+  return (used % 8 == 0 || bits.get(8 - used % 8) == 0);
+}
+
+uint16_t packMSM(const MSMFields& msm, uint8_t* frame) {
+  RTCMBitWriter bits(frame + 3, RTCM_MAX_FRAME - 6);
+  bits.put(msm.messageNumber, 12);
+  bits.put(msm.stationId, 12);
+  bits.put(msm.epoch, 30);
+  bits.put(msm.flags, 19);
+  bits.put64(msm.satelliteMask, 64);
+  bits.put(msm.signalMask, 32);
+  uint8_t cellBits = msm.satellites * msm.signals;
+  if (cellBits > 32)
+    bits.put(msm.cellMask >> 32, cellBits - 32);
+  bits.put(msm.cellMask, min(cellBits, (uint8_t)32));
+
+  bool extended = msm.type() != 4;
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    bits.put(msm.rough[s] >> 10, 8);
+  if (extended)
+    for (uint8_t s = 0; s < msm.satellites; s++)
+      bits.put(msm.extended[s], 4);
+  for (uint8_t s = 0; s < msm.satellites; s++)
+    bits.put(msm.rough[s], 10);
+  if (extended)
+    for (uint8_t s = 0; s < msm.satellites; s++)
+      bits.put(msm.roughRate[s], 14);
+
+  for (uint8_t c = 0; c < msm.cells; c++)
+    bits.put(msm.pseudorange[c], msm.pseudorangeBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    bits.put(msm.phase[c], msm.phaseBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    bits.put(msm.lock[c], msm.lockBits());
+  for (uint8_t c = 0; c < msm.cells; c++)
+    bits.put(msm.halfCycle[c], 1);
+  for (uint8_t c = 0; c < msm.cells; c++)
+    bits.put(msm.cnr[c], msm.cnrBits());
+  if (extended)
+    for (uint8_t c = 0; c < msm.cells; c++)
+      bits.put(msm.rate[c], 15);
+
+  uint16_t length = bits.finish();
+  if (bits.overflow())
+    return (0);
+  return (RTCMEncoder::frame(frame, length));
+}
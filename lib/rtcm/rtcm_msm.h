@@ -0,0 +1,53 @@
+//The fields of an MSM4, MSM5 or MSM7 exactly as they are sent, so a message can be taken apart and put back
+//together bit for bit. Satellite fields are in satellite mask order, signal fields in cell mask order.
+//RTCM 10403.3 section 3.5.12
+
+#ifndef _RTCM_MSM_H_
+#define _RTCM_MSM_H_
+
+#include <Arduino.h>
+
+//Invalid values of the signed fields
+const int32_t MSM_INVALID_ROUGH_MS = 255;
+const int32_t MSM_INVALID_ROUGH_RATE = -8192;
+const int32_t MSM_INVALID_RATE = -16384;
+
+struct MSMFields {
+  uint16_t messageNumber;
+  uint16_t stationId;
+  uint32_t epoch;
+  uint32_t flags;             //Multiple message bit through smoothing interval, 19 bits as sent
+  uint64_t satelliteMask;
+  uint32_t signalMask;
+  uint64_t cellMask;          //satellites x signals bits, right aligned
+  uint8_t  satellites;
+  uint8_t  signals;
+  uint8_t  cells;
+  uint32_t rough[64];         //DF397 and DF398 as one 18-bit value, in 2^-10 ms
+  uint8_t  extended[64];      //MSM5 and MSM7
+  int16_t  roughRate[64];     //MSM5 and MSM7
+  int32_t  pseudorange[64];
+  int32_t  phase[64];
+  uint16_t lock[64];
+  uint8_t  halfCycle[64];
+  uint16_t cnr[64];
+  int16_t  rate[64];          //MSM5 and MSM7
+
+  uint8_t type() const { return (messageNumber % 10); }
+  bool high() const { return (type() == 7); }
+  uint8_t pseudorangeBits() const { return (high() ? 20 : 15); }
+  uint8_t phaseBits() const { return (high() ? 24 : 22); }
+  uint8_t lockBits() const { return (high() ? 10 : 4); }
+  uint8_t cnrBits() const { return (high() ? 10 : 6); }
+};
+
+//MSM4, MSM5 or MSM7 of any constellation, from the message number
+bool isMSM(uint16_t messageNumber);
+
+//A whole frame. False for any other message, or a frame that would not be rebuilt exactly
+bool parseMSM(const uint8_t* frame, uint16_t length, MSMFields& msm);
+
+//Returns the frame length, or 0 if it does not fit
+uint16_t packMSM(const MSMFields& msm, uint8_t* frame);
+
+#endif
@@ -0,0 +1,34 @@
+#include "rtcm.h"
+#include "rtcm_bits.h"
+#include <checksum.h>
+
+//Preamble, 6 reserved bits and the 10-bit payload length, then the payload and its CRC-24Q
+uint16_t RTCMEncoder::frame(uint8_t* frame, uint16_t payloadLength) {
+  frame[0] = 0xD3;
+  frame[1] = (payloadLength >> 8) & 0x03;
+  frame[2] = payloadLength & 0xFF;
+  uint32_t crc = crc24q(frame, 3 + payloadLength);
+  frame[3 + payloadLength] = crc >> 16;
+  frame[4 + payloadLength] = crc >> 8;
+  frame[5 + payloadLength] = crc;
+  return (payloadLength + 6);
+}
+
+//1005: station ID, the constellations the station serves and the antenna reference point. RTCM 10403.3 table 3.5-9
+uint16_t RTCMEncoder::encodeStation(double x, double y, double z, bool gps, bool glonass, bool galileo, uint8_t* frame) {
+  RTCMBitWriter bits(frame + 3, RTCM_MAX_FRAME - 6);
+  bits.put(1005, 12);
+  bits.put(_stationId, 12);
+  bits.put(0, 6); //ITRF realization year, not given
+  bits.put(gps, 1);
+  bits.put(glonass, 1);
+  bits.put(galileo, 1);
+  bits.put(0, 1); //Physical reference station
+  bits.put64(llround(x * 10000.0), 38); //m * 0.0001
+  bits.put(1, 1); //All raw data from one receiver oscillator
+  bits.put(0, 1); //Reserved
+  bits.put64(llround(y * 10000.0), 38);
+  bits.put(0, 2); //Quarter cycle correction not given
+  bits.put64(llround(z * 10000.0), 38);
+  return (RTCMEncoder::frame(frame, bits.finish()));
+}
@@ -17,7 +17,10 @@ void RTCM_Link::attachDelayWDT(void(*delayWDT_func)(uint16_t delayAmount)){
 
 
 void RTCM_Link::begin(RTCMSettings *settings, uint8_t pin_txen, uint8_t pin_rxen, uint8_t pin_cs, uint8_t pin_dio0, uint8_t pin_dio1, uint8_t pin_rst){
-  _settings = settings;
+  //Adapted rates and powers only ever reach the live copy, so a reboot comes back up on the user's settings
+  _userSettings = settings;
+  _linkSettings = *settings;
+  _settings = &_linkSettings;
   Serial.println("Settings attached");
   _pin_txen = pin_txen;
   _pin_rxen = pin_rxen;
@@ -30,7 +33,6 @@ void RTCM_Link::begin(RTCMSettings *settings, uint8_t pin_txen, uint8_t pin_rxen
   _radio = new Module(_pin_cs, _pin_dio0, _pin_rst, _pin_dio1);
   Serial.println("Radio Module attached");
 
-  _frequencyCorrection = 0;
   _trainConfig = false;
   _transactionComplete = false;
   _timeToHop = false;
@@ -57,7 +59,8 @@ void RTCM_Link::begin(RTCMSettings *settings, uint8_t pin_txen, uint8_t pin_rxen
 //Apply settings to radio
 //Called after begin() and once user exits from command interface
 void RTCM_Link::configure() {
-  _radio.setFrequency(_settings->getChannel(0));
+  _afcBuildTable();
+  _radio.setFrequency(_afcChannel(0));
 
   //The SX1276 and RadioLib accepts a value of 2 to 17, with 20 enabling the power amplifier
   //Measuring actual power output the radio will output 14dBm (25mW) to 27.9dBm (617mW) in constant transmission
@@ -81,6 +84,7 @@ void RTCM_Link::configure() {
   _radio.setRfSwitchPins(_pin_rxen, _pin_txen);
 
   _radio.setFHSSHoppingPeriod(_settings->hoppingPeriod());
+  _frameLimit = _settings->frameSize(); //Adaptive frame sizing starts over at each new air speed
   _trainConfig = false;
 }
 
@@ -92,7 +96,7 @@ void RTCM_Link::changeState(RadioStateBase& newState){
 }
 
 void RTCM_Link::_returnToRX() {
-  _radio.setFrequency(_settings->getChannel(_radio.getFHSSChannel()));
+  _radio.setFrequency(_afcChannel(_radio.getFHSSChannel()));
 
   _timeToHop = false;
 
@@ -120,6 +124,108 @@ void RTCM_Link::configureTraining()
   _trainConfig = true;
 }
 
+//Queue new link settings (netID, airSpeed, bandwidth, etc) without retraining.
+//The settings are announced in-band several times, interleaved with data frames, along with the time
+//left until the switch-over. Base and rovers then apply them at the same instant so corrections resume
+//on the new settings after at most one lost frame.
+bool RTCM_Link::scheduleReconfigure(RTCMSettings& newSettings) {
+  return (_scheduleReconfigure(newSettings, true));
+}
+
+//home marks settings chosen by the user, which both ends keep. Settings adapted to the link are left
+//again if the other end is lost
+bool RTCM_Link::_scheduleReconfigure(RTCMSettings& newSettings, bool home) {
+  if (_settings == nullptr)
+    return (false); //Link has not been started, the new settings will be used by begin()
+
+  if (newSettings.linkConfigMatches(*_settings))
+    return (false); //Nothing the other end needs to know about
+
+  uint8_t linkConfig[MAX_PACKET_SIZE];
+  newSettings.writeLinkConfig(linkConfig);
+  _pendingSettings.readLinkConfig(linkConfig);
+  _pendingHome = home;
+
+  //Leave room for every announcement plus a data frame after each one
+  _reconfigAt_ms = (uint32_t)_announcePeriod() * (_settings->reconfigAnnouncements() + 1);
+  _reconfigTimer = 0;
+  _lastAnnounce = _announcePeriod(); //Announce at the first opportunity
+  _reconfigAnnounced = 0;
+  _reconfigPending = true;
+  return (true);
+}
+
+//Size on air of a configuration announcement: link config + switch-over time + home flag + control trailer
+uint8_t RTCM_Link::_configPacketSize() {
+  if (_settings->spreadFactor() == 6)
+    return 255; //SF6 uses an implicit header, every packet is full size
+  return _settings->trainDataPacketSize() + sizeof(_reconfigAt_ms) + 1 + 2;
+}
+
+uint16_t RTCM_Link::_announcePeriod() {
+  return _settings->airTime(_configPacketSize()) + _settings->airTime(_settings->frameSize());
+}
+
+//Return true if the announcing end should send the pending configuration again
+bool RTCM_Link::_announceDue() {
+  if (!_reconfigPending || _reconfigAnnounced >= _settings->reconfigAnnouncements())
+    return (false);
+
+  if (_lastAnnounce < _announcePeriod())
+    return (false); //Let a data frame through between announcements
+
+  //Never let an announcement straddle the switch-over
+  if (_reconfigTimer + _settings->airTime(_configPacketSize()) >= _reconfigAt_ms)
+    return (false);
+
+  return (true);
+}
+
+//Switch to the announced settings and regenerate the hop table from them
+void RTCM_Link::_applyPendingConfig() {
+  uint8_t linkConfig[MAX_PACKET_SIZE];
+  _pendingSettings.writeLinkConfig(linkConfig);
+  _settings->readLinkConfig(linkConfig);
+  _settings->generateHopTable();
+  if (_pendingHome) {
+    _userSettings->readLinkConfig(linkConfig);
+    _homeChanges++;
+  }
+
+  configure();
+  _settingsChanges++;
+  _reconfigPending = false;
+  _lastHeard = 0;
+  _returnToRX();
+}
+
+//Return true if nothing has been heard from the other end for LINK_FALLBACK_REPORTS report intervals
+//while on adapted settings. A rover that missed every announcement is still on the old settings, and
+//neither end hears the other. The base opens a report slot for each rover every interval, so both ends
+//hear each other at least that often while the link is up.
+bool RTCM_Link::_fallbackDue() {
+  if (_reconfigPending)
+    return (false);
+  if (_lastHeard < (uint32_t)LINK_FALLBACK_REPORTS * _settings->linkReportInterval_ms())
+    return (false);
+  return (!_settings->linkConfigMatches(*_userSettings));
+}
+
+//Return to the home settings straight away, there is no one to announce them to. Both ends do this, so
+//they meet there again. An adapted TX power goes back to the user's as well
+void RTCM_Link::_fallBack() {
+  uint8_t linkConfig[MAX_PACKET_SIZE];
+  _userSettings->writeLinkConfig(linkConfig);
+  _settings->readLinkConfig(linkConfig);
+  _settings->generateHopTable();
+  _settings->broadcastPower_dbm(_userSettings->broadcastPower_dbm());
+
+  configure();
+  _settingsChanges++;
+  _lastHeard = 0;
+  _returnToRX();
+}
+
 //Periodic update of the radio subsystem
 void RTCM_Link::update() {
   _state->update(this);
@@ -131,7 +237,7 @@ void RTCM_Link::update() {
 void RTCM_Link::_hopChannel() {
   _radio.clearFHSSInt();
   _timeToHop = false;
-  _radio.setFrequency(_settings->getChannel(_radio.getFHSSChannel()) - _frequencyCorrection);
+  _radio.setFrequency(_afcChannel(_radio.getFHSSChannel()));
 }
 
 
@@ -32,6 +32,32 @@ public:
   PacketType identifyPacketType();
   
   void bufferTXByte(uint8_t data);
+  bool bufferTXFrame(const uint8_t* data, uint16_t length);
+
+  //Announce new link settings in-band, then switch base and rovers over at the same instant
+  //Returns false, with nothing scheduled, if the link parameters would not change
+  bool scheduleReconfigure(RTCMSettings& newSettings);
+  bool reconfigurePending() { return _reconfigPending; }
+  RTCMSettings& settings() { return *_settings; } //Live settings, including any adapted rate and power
+  uint16_t settingsChanges() { return _settingsChanges; } //Counts switch-overs, fallbacks and power changes
+  uint16_t homeChanges() { return _homeChanges; } //Counts switch-overs to settings chosen by the user, to save on
+
+  ARQStats& arqStats() { return _arqStats; }
+  void printARQStatus(Print& out);
+
+  //Rover link reports and adaptive data rate
+  void setRoverFixState(uint8_t fixType, uint8_t carrSoln);
+  RoverStatus& roverStatus(uint8_t id) { return _rovers[id]; }
+  void printRoverStatus(Print& out);
+
+  //Automatic frequency correction
+  float afcOffset_ppm() { return _afcOffset_ppm; }
+  AFCStats& afcStats() { return _afcStats; }
+  void printAFCStatus(Print& out);
+
+  //Frame sizing
+  FrameStats& frameStats() { return _frameStats; }
+  void printFramePlan(Print& out) const;
 
   void update();
 
@@ -53,7 +79,9 @@ private:
   //Radio hardware and settings references
   //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
   SX1276 _radio = NULL;
-  RTCMSettings* _settings = nullptr;
+  RTCMSettings* _settings = nullptr; //Points at _linkSettings once the link has begun
+  RTCMSettings* _userSettings = nullptr; //Settings chosen by the user, the only ones the link writes back
+  RTCMSettings _linkSettings; //Live copy the link adapts, kept in RAM only
   RTCMSettings* _trainSettings = nullptr;
   //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
   
@@ -75,11 +103,93 @@ private:
 
   bool _transactionComplete;
   bool _timeToHop;
-  float _frequencyCorrection;
   void _returnToRX();
   void _hopChannel();
   void _sendPacket();
+
+  //Automatic frequency correction
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+  float _afcOffset_ppm = 0; //Estimated crystal offset of the base relative to this radio
+  float _afcChannels[NUMBER_OF_CHANNELS]; //Hop table with the offset applied
+  AFCStats _afcStats = {};
+  void _afcUpdate();
+  void _afcBuildTable();
+  float _afcChannel(uint8_t number) { return _afcChannels[number]; }
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+  //Coordinated reconfiguration status
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+  RTCMSettings _pendingSettings; //Link settings that take effect at the switch-over
+  bool _pendingHome = false; //Pending settings were chosen by the user, rather than adapted to the link
+  elapsedMillis _lastHeard = 0; //Time since a packet on our network arrived
+  bool _reconfigPending = false;
+  uint8_t _reconfigAnnounced = 0; //Number of announcements sent for the pending settings
+  uint32_t _reconfigAt_ms = 0; //Switch-over time, measured from when _reconfigTimer was reset
+  elapsedMillis _reconfigTimer = 0;
+  elapsedMillis _lastAnnounce = 0; //Timer to interleave announcements with data frames
+  uint8_t _configPacketSize();
+  uint16_t _announcePeriod();
+  bool _announceDue();
+  bool _scheduleReconfigure(RTCMSettings& newSettings, bool home);
+  void _applyPendingConfig();
+  bool _fallbackDue();
+  void _fallBack();
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
   
+  //Selective repeat / NACK window status
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+  ARQFrame _arqWindow[ARQ_MAX_WINDOW]; //Frames sent and held for retransmission (base) or received out of order (rover)
+  uint8_t _arqBase = 0; //Oldest sequence number still held
+  uint8_t _arqNextSeq = 0; //Next sequence number to send (base) or deliver (rover)
+  bool _arqSender = false; //Only the end sending sequenced frames retransmits and tracks ACKs
+  ARQStats _arqStats = {};
+  bool _arqWindowOpen();
+  int8_t _arqRetransmitSlot();
+  bool _arqRetransmitDue() { return _arqRetransmitSlot() >= 0; }
+  void _arqExpire();
+  void _arqLoadFrame(uint16_t maxBytes);
+  void _arqProcessACK(const uint8_t* status);
+  void _arqWriteStatus(uint8_t* status);
+  bool _arqReceiveFrame();
+  void _arqDeliver(ARQFrame& frame);
+  void _bufferRXBytes(const uint8_t* data, uint8_t size);
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+  //Rover link reports
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+  RoverStatus _rovers[MAX_LINK_ROVERS]; //Base: latest report from each rover
+  uint8_t _reportSlotOwner = 0; //Base: rover given the current slot. Rover: owner of the last slot heard
+  elapsedMillis _reportSlotTimer = 0; //Base: time since the last report slot was opened
+  elapsedMillis _adaptHoldoff = 0; //Base: time since the last rate or power change
+  uint16_t _rxGood = 0; //Rover: data frames received, wrapping, the base differences it between reports
+  uint16_t _reportFramesSent = 0; //Rover: base frame count carried by the last report slot heard
+  float _linkRSSI = 0; //Rover: smoothed RSSI of the base
+  float _linkSNR = 0; //Rover: smoothed SNR of the base
+  uint8_t _roverFixType = 0;
+  uint8_t _roverCarrSoln = 0;
+  bool _reportSlotDue();
+  void _deferReportSlot();
+  void _updateLinkQuality();
+  void _writeLinkReport();
+  void _processLinkReport();
+  void _adaptLink();
+  void _changeBroadcastPower(uint8_t power);
+  uint16_t _settingsChanges = 0; //Changes made to the live settings by the link itself
+  uint16_t _homeChanges = 0; //User-chosen settings taken up at a switch-over
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+  //Frame sizing
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+  uint8_t _frameLimit = 0; //Base: largest frame the adaptive sizing currently allows
+  elapsedMillis _frameAdaptTimer = 0; //Base: time since the frame limit was last reviewed
+  uint32_t _frameAdaptSent = 0; //Base: ARQ counters at the last review
+  uint32_t _frameAdaptRetransmissions = 0;
+  FrameStats _frameStats = {};
+  uint16_t _frameSizeLimit();
+  uint16_t _currentFrameLimit() const;
+  void _adaptFrameSize();
+  //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
   //Training status
   //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
   bool _trainConfig;
@@ -88,6 +198,7 @@ private:
   elapsedMillis _trainTime = 0; //Stores when a training mode was entered for timeout purposes
   elapsedMillis _learnCycle = 0; //Timer for sending the next training ping
   elapsedMillis _ackDelay = 0; //Timer to wait for an ACK packet
+  uint16_t _replyWindow_ms = 0; //Base: hold off transmitting this long after a frame, while the rovers NACK in turn
   //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
   
   //Radio Data buffers
@@ -119,6 +230,11 @@ private:
   friend class RXStandby;
   friend class RXPacket;
   friend class TX;
+  friend class ConfigTX;
+  friend class ReplyWait;
+  friend class ACKTX;
+  friend class NACKWait;
+  friend class ReportTX;
 
   friend class TeachRXWait;
   friend class TeachRXPacket;
@@ -0,0 +1,268 @@
+#include "rtcm_link.h"
+
+//Closed loop link adaptation
+//The base opens a report slot after a data frame every linkReportInterval / MAX_LINK_ROVERS, cycling
+//through the rover IDs so each rover reports once per interval. Slots only follow frames the base is
+//already sending, so reports fill the gaps between correction bursts rather than competing with them.
+//The base keeps the weakest rover inside its link budget: when margin is short it first raises TX power,
+//then steps down an airSpeed preset; with margin to spare it steps up a preset, then lowers TX power.
+
+//airSpeed presets ordered from most robust to fastest
+static const uint32_t AIR_SPEED_PRESETS[] = {40, 150, 400, 1200, 2400, 4800, 9600, 19200, 28800, 38400};
+static const uint8_t NUMBER_OF_PRESETS = sizeof(AIR_SPEED_PRESETS) / sizeof(AIR_SPEED_PRESETS[0]);
+
+static const float ADR_MARGIN_LOW = 3.0; //dB above the demodulation floor before backing off
+static const float ADR_MARGIN_HIGH = 10.0; //dB that must remain at the faster preset before stepping up
+static const uint8_t ADR_PER_HIGH = 26; //~10% packet error rate, back off
+static const uint8_t ADR_PER_LOW = 5; //~2% packet error rate, allowed to speed up
+static const uint8_t ADR_POWER_STEP = 2; //dB
+
+//Base: return true, and pick the owner, if the next data frame should open a report slot
+bool RTCM_Link::_reportSlotDue() {
+  if (_reportSlotTimer < _settings->linkReportInterval_ms() / MAX_LINK_ROVERS)
+    return (false);
+
+  _reportSlotTimer = 0;
+  _reportSlotOwner = (_reportSlotOwner + 1) % MAX_LINK_ROVERS;
+  return (true);
+}
+
+//Base: the frame had no room for the report slot, so give the same rover the slot on the next frame
+void RTCM_Link::_deferReportSlot() {
+  _reportSlotOwner = (_reportSlotOwner + MAX_LINK_ROVERS - 1) % MAX_LINK_ROVERS;
+  _reportSlotTimer = _settings->linkReportInterval_ms() / MAX_LINK_ROVERS;
+}
+
+//Rover: track signal quality of packets from the base
+void RTCM_Link::_updateLinkQuality() {
+  _rxGood++;
+  _linkRSSI = 0.75 * _linkRSSI + 0.25 * _radio.getRSSI();
+  _linkSNR = 0.75 * _linkSNR + 0.25 * _radio.getSNR();
+}
+
+//Rover: the GNSS receiver's fix state is included in each report
+void RTCM_Link::setRoverFixState(uint8_t fixType, uint8_t carrSoln) {
+  _roverFixType = fixType;
+  _roverCarrSoln = carrSoln;
+}
+
+//Rover: build the report payload,
+//[ARQ status][roverID][RSSI][SNR * 4][frames sent (2)][frames received (2)][fix type][carrier solution]
+//A rover can't count the frames it never heard, so it reports what it received and the base, which knows
+//how many it sent, works out the error rate. Both counts are running totals, sent back with the base's count
+//from the slot frame, so a report that is lost only lengthens the span the next one measures
+void RTCM_Link::_writeLinkReport() {
+  _arqWriteStatus(_outgoingPacket);
+
+  uint8_t offset = ARQ_HEADER_SIZE;
+  _outgoingPacket[offset++] = _settings->roverID();
+  _outgoingPacket[offset++] = (int8_t)constrain(_linkRSSI, -128.0, 127.0);
+  _outgoingPacket[offset++] = (int8_t)constrain(_linkSNR * 4, -128.0, 127.0);
+  memcpy(&_outgoingPacket[offset], &_reportFramesSent, sizeof(_reportFramesSent));
+  offset += sizeof(_reportFramesSent);
+  memcpy(&_outgoingPacket[offset], &_rxGood, sizeof(_rxGood));
+  offset += sizeof(_rxGood);
+  _outgoingPacket[offset++] = _roverFixType;
+  _outgoingPacket[offset++] = _roverCarrSoln;
+  _packetSize = offset;
+}
+
+//Base: store a rover's report, and apply its ARQ status when it is the only rover
+void RTCM_Link::_processLinkReport() {
+  if (_lastPacketSize != LINK_REPORT_SIZE)
+    return;
+
+  if (_settings->arqMode() == ARQMode::SELECTIVE_REPEAT)
+    _arqProcessACK(_lastPacket);
+
+  uint8_t offset = ARQ_HEADER_SIZE;
+  uint8_t id = _lastPacket[offset++];
+  if (id >= MAX_LINK_ROVERS)
+    return;
+
+  RoverStatus& rover = _rovers[id];
+  rover.rssi = (int8_t)_lastPacket[offset++];
+  rover.snr = (int8_t)_lastPacket[offset++] / 4.0;
+
+  //Frames lost on the way count as well as frames that failed their CRC. Measured since the last report
+  //that arrived, however many were lost in between
+  uint16_t framesSent, framesReceived;
+  memcpy(&framesSent, &_lastPacket[offset], sizeof(framesSent));
+  offset += sizeof(framesSent);
+  memcpy(&framesReceived, &_lastPacket[offset], sizeof(framesReceived));
+  offset += sizeof(framesReceived);
+  uint16_t sent = framesSent - rover.framesSent;
+  uint16_t received = framesReceived - rover.framesReceived;
+  if (!rover.active || sent == 0)
+    rover.per = 0; //No count since a report to measure from
+  else
+    rover.per = (received >= sent) ? 0 : (uint32_t)(sent - received) * 255 / sent;
+  rover.framesSent = framesSent;
+  rover.framesReceived = framesReceived;
+
+  rover.fixType = _lastPacket[offset++];
+  rover.carrSoln = _lastPacket[offset++];
+  rover.lastReport = 0;
+  rover.active = true;
+}
+
+//Base: move between airSpeed presets and TX powers to keep the weakest rover inside its link budget
+void RTCM_Link::_adaptLink() {
+  if (!_settings->adaptiveRate() || _settings->airSpeed() == 0 || _reconfigPending)
+    return;
+
+  //Give every rover a chance to report on the current settings before changing again
+  if (_adaptHoldoff < 2 * (uint32_t)_settings->linkReportInterval_ms())
+    return;
+
+  bool anyRover = false;
+  float worstSNR = 100;
+  uint8_t worstPER = 0;
+  for (uint8_t x = 0; x < MAX_LINK_ROVERS; x++) {
+    RoverStatus& rover = _rovers[x];
+    if (rover.active && rover.lastReport > 3 * (uint32_t)_settings->linkReportInterval_ms())
+      rover.active = false; //Rover has gone quiet
+    if (!rover.active)
+      continue;
+    anyRover = true;
+    worstSNR = min(worstSNR, rover.snr);
+    worstPER = max(worstPER, rover.per);
+  }
+  if (!anyRover)
+    return;
+
+  uint8_t preset = 0;
+  while (preset < NUMBER_OF_PRESETS - 1 && AIR_SPEED_PRESETS[preset] != _settings->airSpeed())
+    preset++;
+
+  float margin = worstSNR - _settings->snrFloor();
+  uint8_t power = _settings->broadcastPower_dbm();
+
+  RTCMSettings candidate;
+  uint8_t linkConfig[MAX_PACKET_SIZE];
+  _settings->writeLinkConfig(linkConfig);
+  candidate.readLinkConfig(linkConfig);
+
+  if (margin < ADR_MARGIN_LOW || worstPER > ADR_PER_HIGH) {
+    if (power < 30) {
+      _changeBroadcastPower(min(power + ADR_POWER_STEP, 30));
+    }
+    else if (preset > 0) {
+      candidate.airSpeed(AIR_SPEED_PRESETS[preset - 1]);
+      _scheduleReconfigure(candidate, false);
+      _adaptHoldoff = 0;
+    }
+  }
+  else if (worstPER <= ADR_PER_LOW) {
+    if (preset < NUMBER_OF_PRESETS - 1) {
+      //Predict the SNR at the faster preset, noise grows with bandwidth
+      candidate.airSpeed(AIR_SPEED_PRESETS[preset + 1]);
+      float snrNext = worstSNR - 10 * log10(candidate.bandwidth() / _settings->bandwidth());
+      if (snrNext - candidate.snrFloor() >= ADR_MARGIN_HIGH) {
+        _scheduleReconfigure(candidate, false);
+        _adaptHoldoff = 0;
+        return;
+      }
+    }
+    if (margin >= ADR_MARGIN_HIGH + ADR_POWER_STEP && power > 14)
+      _changeBroadcastPower(max(power - ADR_POWER_STEP, 14));
+  }
+}
+
+//TX power is not shared with the rovers, so it changes immediately
+void RTCM_Link::_changeBroadcastPower(uint8_t power) {
+  _settings->broadcastPower_dbm(power);
+  _settingsChanges++;
+  _radio.setOutputPower(covertdBmToSetting(_settings->broadcastPower_dbm()));
+  _adaptHoldoff = 0;
+}
+
+//Print the rover status table for telemetry
+void RTCM_Link::printRoverStatus(Print& out) {
+  out.printf("Air speed %lu, power %u dBm\r\n", _settings->airSpeed(), _settings->broadcastPower_dbm());
+  for (uint8_t x = 0; x < MAX_LINK_ROVERS; x++) {
+    RoverStatus& rover = _rovers[x];
+    if (!rover.active)
+      continue;
+    out.printf("Rover %u: RSSI %d dBm, SNR %.1f dB, PER %.1f%%, fix %u, RTK %u, age %lu ms\r\n",
+               x, rover.rssi, rover.snr, rover.per * 100.0 / 255, rover.fixType, rover.carrSoln, (uint32_t)rover.lastReport);
+  }
+}
+
+//Base: frame size cap for the next data frame, reviewed once a report interval
+uint16_t RTCM_Link::_frameSizeLimit() {
+  if (_settings->frameSizing() == FrameSizing::ADAPTIVE)
+    _adaptFrameSize();
+  return (_currentFrameLimit());
+}
+
+//Base: frame size cap in force, without reviewing it
+uint16_t RTCM_Link::_currentFrameLimit() const {
+  if (_settings->frameSizing() != FrameSizing::ADAPTIVE)
+    return (_settings->frameSize());
+  if (_frameLimit < MIN_FRAME_SIZE || _frameLimit > _settings->frameSize())
+    return (_settings->frameSize()); //Not reviewed yet on these settings
+  return (_frameLimit);
+}
+
+//Base: shrink frames while loss is high and grow them back while it is low
+//Loss is the worst rover PER, or the ARQ retransmission rate when that is higher. A shorter frame
+//spends less time exposed to interference and costs less air time when it has to be repeated.
+void RTCM_Link::_adaptFrameSize() {
+  if (_frameLimit < MIN_FRAME_SIZE || _frameLimit > _settings->frameSize())
+    _frameLimit = _settings->frameSize();
+
+  if (_frameAdaptTimer < _settings->linkReportInterval_ms())
+    return;
+  _frameAdaptTimer = 0;
+
+  uint8_t loss = 0;
+  for (uint8_t x = 0; x < MAX_LINK_ROVERS; x++) {
+    RoverStatus& rover = _rovers[x];
+    if (rover.active && rover.lastReport < 3 * (uint32_t)_settings->linkReportInterval_ms())
+      loss = max(loss, rover.per);
+  }
+
+  uint32_t sent = _arqStats.framesSent - _frameAdaptSent;
+  uint32_t retransmissions = _arqStats.retransmissions - _frameAdaptRetransmissions;
+  _frameAdaptSent = _arqStats.framesSent;
+  _frameAdaptRetransmissions = _arqStats.retransmissions;
+  if (sent > 0)
+    loss = max(loss, (uint8_t)(retransmissions * 255 / (sent + retransmissions)));
+
+  if (loss > ADR_PER_HIGH) {
+    _frameLimit = max(_frameLimit * 3 / 4, MIN_FRAME_SIZE);
+  }
+  else if (loss <= ADR_PER_LOW && _frameLimit < _settings->frameSize()) {
+    _frameLimit = min(_frameLimit + _frameLimit / 8, (int)_settings->frameSize());
+  }
+}
+
+//Print, for each airSpeed preset, how a full frame lines up with the hop period and
+//what dwell aligned sizing gives instead, followed by what the link has actually achieved
+void RTCM_Link::printFramePlan(Print& out) const {
+  RTCMSettings candidate;
+  uint8_t linkConfig[MAX_PACKET_SIZE];
+  _settings->writeLinkConfig(linkConfig);
+  candidate.readLinkConfig(linkConfig);
+
+  out.println("Air speed, hop period (sym), full frame (ms, hops), aligned frame (bytes, ms, hops), payload B/s");
+  for (uint8_t preset = 0; preset < NUMBER_OF_PRESETS; preset++) {
+    candidate.airSpeed(AIR_SPEED_PRESETS[preset]);
+    uint8_t period = candidate.hoppingPeriod();
+    uint8_t fullSize = _settings->frameSize() + 2;
+    uint8_t alignedSize = candidate.dwellPacketSize(fullSize);
+    uint16_t fullHops = (period == 0) ? 0 : candidate.packetSymbols(fullSize) / period;
+    uint16_t alignedHops = (period == 0) ? 0 : candidate.packetSymbols(alignedSize) / period;
+    uint16_t alignedTime = candidate.airTime(alignedSize);
+    out.printf("%lu, %u, %u %u, %u %u %u, %lu\r\n", AIR_SPEED_PRESETS[preset], period,
+               candidate.airTime(fullSize), fullHops, alignedSize, alignedTime, alignedHops,
+               (uint32_t)(alignedSize - 2) * 1000 / alignedTime);
+  }
+
+  uint32_t sent = _arqStats.framesSent + _arqStats.retransmissions;
+  out.printf("Sent %lu frames, limit %u bytes, %lu payload B/s of air time, loss %.1f%%\r\n",
+             _frameStats.framesSent, _currentFrameLimit(),
+             (_frameStats.airTime_ms == 0) ? 0 : _frameStats.payloadBytes * 1000 / _frameStats.airTime_ms,
+             (sent == 0) ? 0.0 : _arqStats.retransmissions * 100.0 / sent);
+}
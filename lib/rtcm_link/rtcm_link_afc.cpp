@@ -0,0 +1,56 @@
+#include "rtcm_link.h"
+
+//Automatic frequency correction
+//The offset between two radios is almost entirely the difference between their crystals, which scales
+//with the carrier. So rather than a correction in MHz per channel, one offset in ppm is tracked and
+//applied to the whole hop table. The table is rebuilt whenever the estimate moves, so TX, RX and every
+//hop use the same corrected frequency.
+//Each packet's frequency error is what is left after the current correction, so it is folded into the
+//estimate with a small gain. A larger gain is used for the first few packets to lock on quickly.
+
+static const float AFC_MAX_PPM = 50.0; //Two +/-20ppm crystals plus margin. Anything larger is not crystal offset
+static const float AFC_ACQUIRE_GAIN = 0.5;
+static const float AFC_TRACK_GAIN = 0.125;
+static const uint8_t AFC_ACQUIRE_SAMPLES = 4;
+
+//Rover: fold the frequency error of the packet just received into the offset estimate
+void RTCM_Link::_afcUpdate() {
+  float channelFrequency = _settings->getChannel(_radio.getFHSSChannel()); //MHz
+  float residual_Hz = _radio.getFrequencyError();
+  float residual_ppm = residual_Hz / channelFrequency; //Hz per MHz is ppm
+
+  if (fabs(residual_ppm) > AFC_MAX_PPM) {
+    _afcStats.rejected++;
+    return;
+  }
+
+  _afcStats.samples++;
+  _afcStats.residualSum_Hz += residual_Hz;
+  _afcStats.residualSqSum_Hz2 += residual_Hz * residual_Hz;
+  if (fabs(residual_Hz) > _afcStats.residualMax_Hz)
+    _afcStats.residualMax_Hz = fabs(residual_Hz);
+
+  float gain = (_afcStats.samples <= AFC_ACQUIRE_SAMPLES) ? AFC_ACQUIRE_GAIN : AFC_TRACK_GAIN;
+  _afcOffset_ppm = constrain(_afcOffset_ppm + gain * residual_ppm, -AFC_MAX_PPM, AFC_MAX_PPM);
+
+  _afcBuildTable();
+}
+
+//Apply the offset estimate to each channel of the hop table
+void RTCM_Link::_afcBuildTable() {
+  float scale = 1.0 - _afcOffset_ppm / 1000000.0;
+  for (uint8_t x = 0; x < _settings->numberOfChannels(); x++)
+    _afcChannels[x] = _settings->getChannel(x) * scale;
+}
+
+//Print the offset estimate and the residual error statistics
+void RTCM_Link::printAFCStatus(Print& out) {
+  float mean = 0;
+  float rms = 0;
+  if (_afcStats.samples > 0) {
+    mean = _afcStats.residualSum_Hz / _afcStats.samples;
+    rms = sqrt(_afcStats.residualSqSum_Hz2 / _afcStats.samples);
+  }
+  out.printf("AFC offset %.2f ppm, residual mean %.0f Hz, RMS %.0f Hz, max %.0f Hz, %lu samples, %lu rejected\r\n",
+             _afcOffset_ppm, mean, rms, _afcStats.residualMax_Hz, _afcStats.samples, _afcStats.rejected);
+}
@@ -0,0 +1,229 @@
+#include "rtcm_link.h"
+
+//Selective repeat ARQ
+//The base keeps every data frame in a sliding window until it is acknowledged or would arrive too late to
+//be useful (maxCorrectionAge). Each frame carries a sequence number plus the oldest sequence the base still
+//holds, so a rover never waits on a frame the base has given up on. Rovers reply with the next sequence they
+//need plus a bitmap of the frames they hold beyond it. In NACK mode rovers only reply when they see a gap.
+
+//Return true if a new frame can be added to the window
+bool RTCM_Link::_arqWindowOpen() {
+  _arqExpire();
+  return ((uint8_t)(_arqNextSeq - _arqBase) < _settings->arqWindowSize());
+}
+
+//Slide the window past frames that are acknowledged or can no longer arrive in time
+void RTCM_Link::_arqExpire() {
+  for (uint8_t seq = _arqBase; seq != _arqNextSeq; seq++) {
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    if (frame.inUse && !frame.acked) {
+      bool tooOld = frame.age + _settings->airTime(frame.size) >= _settings->maxCorrectionAge_ms();
+      bool outOfRetries = frame.retries >= _settings->arqRetryBudget() && frame.sinceSent > _settings->ackTimeout();
+      if (!tooOld && !outOfRetries)
+        continue;
+      _arqStats.framesExpired++;
+    }
+    frame.inUse = false;
+  }
+
+  //Only the contiguous run of released frames at the start of the window can be dropped
+  while (_arqBase != _arqNextSeq && _arqWindow[_arqBase % ARQ_MAX_WINDOW].inUse == false)
+    _arqBase++;
+}
+
+//Return the window slot of the oldest frame that should be sent again, or -1 if none
+//Only called while the channel is free, so retransmissions never preempt a reception
+int8_t RTCM_Link::_arqRetransmitSlot() {
+  if (_settings->arqMode() == ARQMode::BROADCAST || !_arqSender)
+    return (-1);
+
+  _arqExpire();
+  for (uint8_t seq = _arqBase; seq != _arqNextSeq; seq++) {
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    if (!frame.inUse || frame.acked || frame.retries >= _settings->arqRetryBudget())
+      continue;
+
+    //NACK mode has no per-frame ACK, so only frames reported missing are resent
+    bool timedOut = _settings->arqMode() == ARQMode::SELECTIVE_REPEAT && frame.sinceSent > _settings->ackTimeout();
+    if (frame.resend || timedOut)
+      return (seq % ARQ_MAX_WINDOW);
+  }
+  return (-1);
+}
+
+//Fill _outgoingPacket with either a retransmission or a new frame, followed by the sequence header
+void RTCM_Link::_arqLoadFrame(uint16_t maxBytes) {
+  int8_t slot = _arqRetransmitSlot();
+  ARQFrame* frame;
+
+  if (slot >= 0) {
+    frame = &_arqWindow[slot];
+    frame->retries++;
+    frame->resend = false;
+    _arqStats.retransmissions++;
+  }
+  else {
+    maxBytes -= ARQ_HEADER_SIZE;
+    uint16_t bytesToSend = availableTXBytes();
+    if (bytesToSend > maxBytes)
+      bytesToSend = maxBytes;
+
+    frame = &_arqWindow[_arqNextSeq % ARQ_MAX_WINDOW];
+    for (uint8_t x = 0 ; x < bytesToSend ; x++) {
+      frame->data[x] = _txBuffer[_txTail++];
+      _txTail %= sizeof(_txBuffer);
+    }
+    frame->size = bytesToSend;
+    frame->seq = _arqNextSeq++;
+    frame->retries = 0;
+    frame->inUse = true;
+    frame->acked = false;
+    frame->resend = false;
+    frame->age = 0;
+    _arqStats.framesSent++;
+    _arqSender = true;
+  }
+  frame->sinceSent = 0;
+
+  memcpy(_outgoingPacket, frame->data, frame->size);
+  _outgoingPacket[frame->size] = frame->seq;
+  _outgoingPacket[frame->size + 1] = _arqBase;
+  _packetSize = frame->size + ARQ_HEADER_SIZE;
+}
+
+//Base: apply an ACK/NACK of the form [next sequence needed][bitmap of sequences held beyond it]
+void RTCM_Link::_arqProcessACK(const uint8_t* status) {
+  if (!_arqSender)
+    return; //Rovers hear each other's NACKs, ignore them
+
+  uint8_t next = status[0];
+  uint8_t held = status[1];
+
+  //Ignore reports that refer to sequences outside of the window
+  if ((uint8_t)(next - _arqBase) > (uint8_t)(_arqNextSeq - _arqBase))
+    return;
+
+  //Everything before next has been delivered
+  uint8_t highest = next;
+  for (uint8_t seq = _arqBase; seq != _arqNextSeq; seq++) {
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    uint8_t offset = seq - next;
+    bool delivered = (uint8_t)(seq - _arqBase) < (uint8_t)(next - _arqBase);
+    bool selected = offset >= 1 && offset <= 8 && (held & (1 << (offset - 1)));
+
+    if (!delivered && !selected)
+      continue;
+    if (selected)
+      highest = seq;
+    if (frame.inUse && !frame.acked) {
+      frame.acked = true;
+      _arqStats.framesAcked++;
+      _arqStats.bytesAcked += frame.size;
+      _arqStats.ackLatencySum_ms += frame.age;
+    }
+  }
+
+  //Anything missing below the highest frame held by the rover was lost, resend it
+  for (uint8_t seq = next; seq != highest; seq++) {
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    if (frame.inUse && !frame.acked)
+      frame.resend = true;
+  }
+
+  _arqExpire();
+}
+
+//Rover: accept a sequenced data frame, deliver everything now in order
+//Returns true if an ACK/NACK should be sent back
+bool RTCM_Link::_arqReceiveFrame() {
+  if (_lastPacketSize < ARQ_HEADER_SIZE)
+    return (false);
+
+  uint8_t payloadSize = _lastPacketSize - ARQ_HEADER_SIZE;
+  uint8_t seq = _lastPacket[payloadSize];
+  uint8_t senderBase = _lastPacket[payloadSize + 1];
+
+  //The base no longer holds frames before senderBase, stop waiting for them. The base counts the ones we lost
+  while (_arqNextSeq != senderBase && (uint8_t)(senderBase - _arqNextSeq) < 128) {
+    ARQFrame& frame = _arqWindow[_arqNextSeq % ARQ_MAX_WINDOW];
+    if (frame.inUse && frame.seq == _arqNextSeq)
+      _arqDeliver(frame);
+    _arqNextSeq++;
+  }
+
+  //We are further ahead than the base could be, it has restarted its sequence
+  if ((uint8_t)(_arqNextSeq - senderBase) > ARQ_MAX_WINDOW) {
+    for (uint8_t x = 0; x < ARQ_MAX_WINDOW; x++)
+      _arqWindow[x].inUse = false;
+    _arqNextSeq = senderBase;
+  }
+
+  //Hold the frame if it is inside the window and not a duplicate
+  uint8_t offset = seq - _arqNextSeq;
+  if (offset < ARQ_MAX_WINDOW) {
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    if (!frame.inUse || frame.seq != seq) {
+      memcpy(frame.data, _lastPacket, payloadSize);
+      frame.size = payloadSize;
+      frame.seq = seq;
+      frame.inUse = true;
+    }
+  }
+
+  //Deliver the in order run
+  bool gap = false;
+  while (_arqWindow[_arqNextSeq % ARQ_MAX_WINDOW].inUse && _arqWindow[_arqNextSeq % ARQ_MAX_WINDOW].seq == _arqNextSeq) {
+    _arqDeliver(_arqWindow[_arqNextSeq % ARQ_MAX_WINDOW]);
+    _arqNextSeq++;
+  }
+  for (uint8_t x = 1; x < ARQ_MAX_WINDOW; x++) {
+    ARQFrame& frame = _arqWindow[(uint8_t)(_arqNextSeq + x) % ARQ_MAX_WINDOW];
+    if (frame.inUse && frame.seq == (uint8_t)(_arqNextSeq + x))
+      gap = true;
+  }
+
+  if (_RXTrailer.nack == 1)
+    return (gap);
+  return (true);
+}
+
+//Rover: write the next sequence needed and a bitmap of the frames held beyond it
+void RTCM_Link::_arqWriteStatus(uint8_t* status) {
+  uint8_t held = 0;
+  for (uint8_t x = 1; x < ARQ_MAX_WINDOW; x++) {
+    uint8_t seq = _arqNextSeq + x;
+    ARQFrame& frame = _arqWindow[seq % ARQ_MAX_WINDOW];
+    if (frame.inUse && frame.seq == seq)
+      held |= 1 << (x - 1);
+  }
+  status[0] = _arqNextSeq;
+  status[1] = held;
+}
+
+//Base: ARQ counters, with goodput as correction bytes delivered per second of data frame air time
+void RTCM_Link::printARQStatus(Print& out) {
+  static const char* const modeNames[] = { "broadcast", "selective repeat", "NACK" };
+  uint32_t delivered = (_settings->arqMode() == ARQMode::BROADCAST) ? _frameStats.payloadBytes : _arqStats.bytesAcked;
+  float goodput = 0;
+  if (_frameStats.airTime_ms > 0)
+    goodput = delivered * 1000.0 / _frameStats.airTime_ms;
+  uint32_t latency = 0;
+  if (_arqStats.framesAcked > 0)
+    latency = _arqStats.ackLatencySum_ms / _arqStats.framesAcked;
+  out.printf("ARQ %s: %lu sent, %lu retransmitted, %lu acked, %lu expired, goodput %.0f B/s, ACK latency %lu ms\r\n",
+             modeNames[(uint8_t)_settings->arqMode()], _arqStats.framesSent, _arqStats.retransmissions,
+             _arqStats.framesAcked, _arqStats.framesExpired, goodput, latency);
+}
+
+void RTCM_Link::_arqDeliver(ARQFrame& frame) {
+  _bufferRXBytes(frame.data, frame.size);
+  frame.inUse = false;
+}
+
+//Move received data into the receive buffer
+void RTCM_Link::_bufferRXBytes(const uint8_t* data, uint8_t size) {
+  for (int x = 0 ; x < size ; x++) {
+    _rxBuffer[_rxHead++] = data[x];
+    _rxHead %= sizeof(_rxBuffer);
+  }
+}
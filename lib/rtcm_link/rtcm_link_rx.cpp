@@ -38,10 +38,10 @@ bool RTCM_Link::receiveInProcess() {
 //Move any data to incomingPacket buffer
 PacketType RTCM_Link::identifyPacketType() {
   uint8_t incomingBuffer[MAX_PACKET_SIZE];
-  _radio.readData(incomingBuffer, MAX_PACKET_SIZE);
+  int state = _radio.readData(incomingBuffer, MAX_PACKET_SIZE);
   uint8_t receivedBytes = _radio.getPacketLength();
 
-  if (receivedBytes < 2) {
+  if (state != RADIOLIB_ERR_NONE || receivedBytes < 2) {
     return (PacketType::BAD);
   }
 
@@ -61,6 +61,13 @@ PacketType RTCM_Link::identifyPacketType() {
 
   receivedBytes -= 2; //Remove control bytes
 
+  //Data packets that open a report slot end with the base's frame count and the ID of the rover that owns it
+  if (_RXTrailer.report == 1 && _RXTrailer.ack == 0 && receivedBytes >= REPORT_SLOT_SIZE) {
+    _reportSlotOwner = incomingBuffer[receivedBytes - 1];
+    memcpy(&_reportFramesSent, &incomingBuffer[receivedBytes - REPORT_SLOT_SIZE], sizeof(_reportFramesSent));
+    receivedBytes -= REPORT_SLOT_SIZE;
+  }
+
   
   if (receivedNetID != _settings->netID()) {
     return (PacketType::NETID_MISMATCH);
@@ -81,11 +88,27 @@ PacketType RTCM_Link::identifyPacketType() {
   memcpy(_lastPacket, incomingBuffer, receivedBytes);
   _lastPacketSize = receivedBytes;
 
+  //ACK/NACK carrying the next sequence needed and the frames held beyond it
+  if (_RXTrailer.ack == 1) {
+    if (_RXTrailer.train == 1) {
+      return (PacketType::TRAINING_ACK);
+    }
+    if (_RXTrailer.report == 1) {
+      return (PacketType::LINK_REPORT);
+    }
+    return (PacketType::ACK);
+  }
+
   //If this packet is marked as training data,
   //payload contains new AES key and netID which will be processed externally
   if (_RXTrailer.train == 1) {
     return (PacketType::TRAINING_DATA);
   }
 
+  //Payload contains pending link settings and the time until the switch-over
+  if (_RXTrailer.config == 1) {
+    return (PacketType::CONFIG);
+  }
+
   return (PacketType::DATA);
 }
\ No newline at end of file
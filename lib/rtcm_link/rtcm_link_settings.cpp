@@ -20,6 +20,16 @@ void RTCMSettings::defaultSettings() {
   _codingRate = 6; //5 to 8. 6 was chosen to allow higher spread factor. Higher coding rates ensure less packets dropped.
   _preambleLength = 8; //Number of symbols. Different lengths does *not* guarantee a remote radio privacy. 8 to 11 works. 8 to 15 drops some. 8 to 20 is silent.
 
+  //Reliability settings
+  _arqMode = ARQMode::BROADCAST; //Broadcast, selective repeat (single rover) or NACK (multi-rover)
+  _maxCorrectionAge_ms = 1000; //Retransmissions are never scheduled past this age
+  _frameSizing = FrameSizing::DWELL_ALIGNED; //Fixed, aligned to hop boundaries, or aligned and shrunk under loss
+
+  //Link adaptation settings
+  _roverID = 0; //Which report slot this rover answers in, 0 to MAX_LINK_ROVERS - 1
+  _adaptiveRate = false; //Base moves between airSpeed presets and TX powers based on rover reports
+  _linkReportInterval_ms = 5000; //How often each rover is given a report slot
+
  //These settings can technically be changed, but the end user typically should not alter them
   _timeoutBeforeSendingFrame_ms = 50; //Send partial buffer if time expires
   _responseDelayDivisor = 4; //Add on to max response time after packet has been sent. Factor of 2. 8 is ok. 4 is good. A smaller number increases the delay.
@@ -30,6 +40,7 @@ void RTCMSettings::defaultSettings() {
   _frequencyMax = FREQUENCY_MAX; //MHz
   _numberOfChannels = NUMBER_OF_CHANNELS; //Divide the min/max freq band into this number of channels and hop between.
   _maxDwellTime = MAX_DWELL_TIME; //Max number of ms before hopping (if enabled). Useful for configuring radio to be within regulator limits (FCC = 400ms max)
+  _reconfigAnnouncements = 3; //Number of times a pending link configuration is announced before both ends switch over
 }
 
 void RTCMSettings::trainSettings() {
@@ -54,6 +65,9 @@ void RTCMSettings::netID(uint8_t netID) {
 
 void RTCMSettings::broadcastPower_dbm(uint16_t power){
   if (power >= 14 && power <= 30) {
+    if (_broadcastPower_dbm != power) {
+      _dirty = true;
+    }
     _broadcastPower_dbm = power;
   }
 }
@@ -189,36 +203,183 @@ void RTCMSettings::preambleLength(uint8_t preambleLength){
   }
 }
 
+void RTCMSettings::arqMode(ARQMode mode) {
+  if (mode <= ARQMode::NACK) { //Stored as a number, so a bad file can hold anything
+    if (_arqMode != mode) {
+      _dirty = true;
+    }
+    _arqMode = mode;
+  }
+}
+
+void RTCMSettings::maxCorrectionAge_ms(uint16_t age) {
+  if (age >= 100 && age <= 10000) {
+    if (_maxCorrectionAge_ms != age) {
+      _dirty = true;
+    }
+    _maxCorrectionAge_ms = age;
+  }
+}
+
+void RTCMSettings::frameSizing(FrameSizing sizing) {
+  if (sizing <= FrameSizing::ADAPTIVE) { //Stored as a number, so a bad file can hold anything
+    if (_frameSizing != sizing) {
+      _dirty = true;
+    }
+    _frameSizing = sizing;
+  }
+}
+
+void RTCMSettings::roverID(uint8_t id) {
+  if (id < MAX_LINK_ROVERS) {
+    if (_roverID != id) {
+      _dirty = true;
+    }
+    _roverID = id;
+  }
+}
+
+void RTCMSettings::adaptiveRate(bool enable) {
+  if (_adaptiveRate != enable) {
+    _dirty = true;
+  }
+  _adaptiveRate = enable;
+}
+
+void RTCMSettings::linkReportInterval_ms(uint16_t interval) {
+  if (interval >= 1000 && interval <= 60000) {
+    if (_linkReportInterval_ms != interval) {
+      _dirty = true;
+    }
+    _linkReportInterval_ms = interval;
+  }
+}
+
 uint8_t RTCMSettings::trainDataPacketSize(){
   return sizeof(_netID) + sizeof(_airSpeed) + sizeof(_bandwidth) + sizeof(_spreadFactor) + sizeof(_codingRate) + sizeof(_preambleLength);
 }
 
+//Pack the shared link parameters into buffer, which must hold trainDataPacketSize() bytes
+void RTCMSettings::writeLinkConfig(uint8_t* buffer) {
+  uint16_t offset = 0;
+  buffer[offset] = _netID;
+  offset += sizeof(_netID);
+  memcpy(&buffer[offset], &_airSpeed, sizeof(_airSpeed));
+  offset += sizeof(_airSpeed);
+  memcpy(&buffer[offset], &_bandwidth, sizeof(_bandwidth));
+  offset += sizeof(_bandwidth);
+  buffer[offset] = _spreadFactor;
+  offset += sizeof(_spreadFactor);
+  buffer[offset] = _codingRate;
+  offset += sizeof(_codingRate);
+  buffer[offset] = _preambleLength;
+}
+
+//Return true if other shares every link parameter with these settings
+bool RTCMSettings::linkConfigMatches(RTCMSettings& other) {
+  uint8_t ours[MAX_PACKET_SIZE];
+  uint8_t theirs[MAX_PACKET_SIZE];
+  writeLinkConfig(ours);
+  other.writeLinkConfig(theirs);
+  return (memcmp(ours, theirs, trainDataPacketSize()) == 0);
+}
+
+//Apply link parameters packed by writeLinkConfig
+//An airSpeed preset overrides bandwidth, spread factor and coding rate, so only apply those for custom settings
+void RTCMSettings::readLinkConfig(const uint8_t* buffer) {
+  uint16_t offset = 0;
+  netID(buffer[offset]);
+  offset += sizeof(_netID);
+
+  uint32_t tempAirSpeed;
+  memcpy(&tempAirSpeed, &buffer[offset], sizeof(tempAirSpeed));
+  offset += sizeof(_airSpeed);
+
+  float tempBandwidth;
+  memcpy(&tempBandwidth, &buffer[offset], sizeof(tempBandwidth));
+  offset += sizeof(_bandwidth);
+
+  uint8_t tempSpreadFactor = buffer[offset];
+  offset += sizeof(_spreadFactor);
+  uint8_t tempCodingRate = buffer[offset];
+  offset += sizeof(_codingRate);
+
+  airSpeed(tempAirSpeed);
+  if (tempAirSpeed == 0) {
+    bandwidth(tempBandwidth);
+    spreadFactor(tempSpreadFactor);
+    codingRate(tempCodingRate);
+  }
+  preambleLength(buffer[offset]);
+}
+
 float RTCMSettings::symbolTime() {
   return pow(2, _spreadFactor) / _bandwidth;
 }
 
-//Given spread factor, bandwidth, coding rate and number of bytes, return total Air Time in ms for packet
-uint16_t RTCMSettings::airTime(uint8_t bytesToSend) {
-  float tSym = symbolTime();
-  float tPreamble = (_preambleLength + 4.25) * tSym;
+//Given spread factor, bandwidth, coding rate and number of bytes, return the number of symbols in the packet
+float RTCMSettings::packetSymbols(uint8_t bytesToSend) {
+  float nPreamble = _preambleLength + 4.25;
   float p1 = (8 * bytesToSend - 4 * _spreadFactor + 28 + 16 * 1 - 20 * 0) / (4.0 * (_spreadFactor - 2 * 0));
   p1 = ceil(p1) * _codingRate;
   if (p1 < 0) p1 = 0;
-  uint16_t payloadBytes = 8 + p1;
-  float tPayload = payloadBytes * tSym;
-  float tPacket = tPreamble + tPayload;
+  uint16_t payloadSymbols = 8 + p1;
+
+  return (nPreamble + payloadSymbols);
+}
+
+//Given spread factor, bandwidth, coding rate and number of bytes, return total Air Time in ms for packet
+uint16_t RTCMSettings::airTime(uint8_t bytesToSend) {
+  float tPacket = packetSymbols(bytesToSend) * symbolTime();
 
   return ((uint16_t)ceil(tPacket));
 }
 
+//Return the largest packet, no bigger than packetSize, that ends before the next hop boundary
+//A packet that fits inside one dwell never hops. A longer packet is trimmed back to the last
+//boundary it crosses so it does not start a new channel only to send a few symbols on it.
+uint8_t RTCMSettings::dwellPacketSize(uint8_t packetSize) {
+  uint8_t period = hoppingPeriod();
+  if (period == 0)
+    return (packetSize);
+
+  uint16_t hops = packetSymbols(packetSize) / period;
+  if (hops == 0)
+    return (packetSize);
+
+  float boundary = hops * period;
+  uint8_t size = packetSize;
+  while (size > 1 && packetSymbols(size) > boundary)
+    size--;
+
+  return (size);
+}
+
 //Given spread factor, bandwidth, coding rate and frame size, return most bytes we can push per second
 uint16_t RTCMSettings::maxThroughput() {
-  uint8_t mostFramesPerSecond = 1000 / airTime(_frameSize);
+  float mostFramesPerSecond = 1000.0 / airTime(_frameSize); //Under one at slow air speeds
   uint16_t mostBytesPerSecond = _frameSize * mostFramesPerSecond;
 
   return (mostBytesPerSecond);
 }
 
+//Correction bytes per second left once the link's own traffic is taken out: the ARQ header on each frame, the wait
+//for an ACK or NACK after it, and the rover report slots
+uint16_t RTCMSettings::rtcmThroughput() {
+  float frameTime = airTime(_frameSize);
+  uint8_t payloadBytes = _frameSize;
+  if (_arqMode != ARQMode::BROADCAST) {
+    frameTime += ackTimeout();
+    payloadBytes -= ARQ_HEADER_SIZE;
+  }
+
+  float reportShare = (float)MAX_LINK_ROVERS * reportTimeout() / _linkReportInterval_ms;
+  if (reportShare > 1.0)
+    reportShare = 1.0;
+
+  return ((uint16_t)(payloadBytes * 1000.0 * (1.0 - reportShare) / frameTime));
+}
+
 // HoppingPeriod = Tsym * FreqHoppingPeriod
 // Given defaults of spreadfactor = 9, bandwidth = 125, it follows Tsym = 4.10ms
 // HoppingPeriod = 4.10 * x = Yms. Can be as high as 400ms to be within regulatory limits
@@ -231,6 +392,67 @@ uint8_t RTCMSettings::hoppingPeriod() {
   return hoppingPeriod;
 }
 
+//Time to wait for an ACK/NACK after a data frame: ACK air time plus a turnaround allowance
+//In NACK mode the rovers answer one after another, so the base waits through every rover's slot
+uint16_t RTCMSettings::ackTimeout() {
+  uint8_t ackSize = (_spreadFactor == 6) ? 255 : ARQ_HEADER_SIZE + 2;
+  uint16_t timeout = airTime(ackSize) + airTime(_frameSize) / _responseDelayDivisor;
+  if (_arqMode == ARQMode::NACK)
+    timeout += (MAX_LINK_ROVERS - 1) * nackSlot();
+  return timeout;
+}
+
+//Time to wait for a rover link report after opening its slot, and in NACK mode the NACK slots after it
+uint16_t RTCMSettings::reportTimeout() {
+  uint8_t reportSize = (_spreadFactor == 6) ? 255 : LINK_REPORT_SIZE + 2;
+  uint16_t timeout = airTime(reportSize) + airTime(_frameSize) / _responseDelayDivisor;
+  if (_arqMode == ARQMode::NACK)
+    timeout += MAX_LINK_ROVERS * nackSlot();
+  return timeout;
+}
+
+//Air time of one NACK plus the turnaround before the next rover's slot
+uint16_t RTCMSettings::nackSlot() {
+  uint8_t ackSize = (_spreadFactor == 6) ? 255 : ARQ_HEADER_SIZE + 2;
+  return airTime(ackSize) + NACK_SLOT_GUARD_MS;
+}
+
+//Rover: time after a data frame before this rover's NACK slot. The slots go in roverID order, after the link
+//report when the frame opened a report slot, the same IDs that share out the report slots
+uint16_t RTCMSettings::nackDelay(bool afterReport) {
+  uint16_t delay = _roverID * nackSlot();
+  if (afterReport) {
+    uint8_t reportSize = (_spreadFactor == 6) ? 255 : LINK_REPORT_SIZE + 2;
+    delay += airTime(reportSize) + NACK_SLOT_GUARD_MS;
+  }
+  return delay;
+}
+
+//Lowest SNR in dB the SX1276 can demodulate at the current spread factor (datasheet table 13)
+float RTCMSettings::snrFloor() {
+  return -5.0 - 2.5 * (_spreadFactor - 6);
+}
+
+//Number of frames that can be outstanding before the oldest exceeds the correction age limit
+uint8_t RTCMSettings::arqWindowSize() {
+  uint16_t window = _maxCorrectionAge_ms / airTime(_frameSize);
+  if (window < 1)
+    window = 1;
+  if (window > ARQ_MAX_WINDOW)
+    window = ARQ_MAX_WINDOW;
+  return window;
+}
+
+//Number of retransmissions of a frame that still land inside the correction age limit
+uint8_t RTCMSettings::arqRetryBudget() {
+  uint16_t attempts = _maxCorrectionAge_ms / (airTime(_frameSize) + ackTimeout());
+  if (attempts < 1)
+    return 0;
+  if (attempts > 8)
+    attempts = 8;
+  return attempts - 1;
+}
+
 //Generate unique hop table based on radio settings
 void RTCMSettings::generateHopTable() {
   if (_channels != NULL)
@@ -4,12 +4,13 @@
 #include <Arduino.h>
 #include <Array.h>
 
+#include "rtcm_link_types.h"
+
 const float FREQUENCY_MIN = 902.0;
 const float FREQUENCY_MAX = 928.0;
 const uint8_t NUMBER_OF_CHANNELS = 50;
 const uint16_t MAX_DWELL_TIME = 400; 
 const uint8_t RADIO_SYNC_WORD = 0x12; 
-#define MAX_PACKET_SIZE 255 //Limited by SX127x
 const int FIRMWARE_VERSION_MAJOR = 1;
 const int FIRMWARE_VERSION_MINOR = 0;
 #define FIRMWARE_VERSION (FIRMWARE_VERSION_MAJOR * 0x10 + FIRMWARE_VERSION_MINOR)
@@ -48,6 +49,24 @@ public:
   uint8_t  preambleLength() { return _preambleLength; }
   void     preambleLength(uint8_t preambleLength);
 
+  ARQMode  arqMode() { return _arqMode; }
+  void     arqMode(ARQMode mode);
+
+  uint16_t maxCorrectionAge_ms() { return _maxCorrectionAge_ms; }
+  void     maxCorrectionAge_ms(uint16_t age);
+
+  FrameSizing frameSizing() { return _frameSizing; }
+  void     frameSizing(FrameSizing sizing);
+
+  uint8_t  roverID() { return _roverID; }
+  void     roverID(uint8_t id);
+
+  bool     adaptiveRate() { return _adaptiveRate; }
+  void     adaptiveRate(bool enable);
+
+  uint16_t linkReportInterval_ms() { return _linkReportInterval_ms; }
+  void     linkReportInterval_ms(uint16_t interval);
+
   uint16_t timeoutBeforeSendingFrame_ms() { return _timeoutBeforeSendingFrame_ms; }
   uint8_t  responseDelayDivisor() { return _responseDelayDivisor; }
   bool     frequencyHop() { return _frequencyHop; }
@@ -57,16 +76,32 @@ public:
   float    frequencyMax() { return _frequencyMax; }
   uint8_t  numberOfChannels() { return _numberOfChannels; }
   uint16_t maxDwellTime() { return _maxDwellTime; }
+  uint8_t  reconfigAnnouncements() { return _reconfigAnnouncements; }
 
 
   //values computed from the settings
   uint8_t  trainDataPacketSize();
   float    symbolTime();
+  float    packetSymbols(uint8_t bytesToSend);
   uint16_t airTime(uint8_t bytesToSend);
+  uint8_t  dwellPacketSize(uint8_t packetSize);
   uint16_t maxThroughput();
+  uint16_t rtcmThroughput();
   uint8_t  hoppingPeriod();
+  uint16_t ackTimeout();
+  uint16_t reportTimeout();
+  uint16_t nackSlot();
+  uint16_t nackDelay(bool afterReport);
+  float    snrFloor();
+  uint8_t  arqWindowSize();
+  uint8_t  arqRetryBudget();
   float    getChannel(uint8_t number) { return _channels[number]; }
 
+  //Link parameters that both ends must share, packed for over the air transfer
+  void     writeLinkConfig(uint8_t* buffer);
+  void     readLinkConfig(const uint8_t* buffer);
+  bool     linkConfigMatches(RTCMSettings& other);
+
 private:
   bool     _dirty; //indicates if the settings are changed
 
@@ -85,6 +120,16 @@ private:
   uint8_t  _codingRate; //5 to 8. 6 was chosen to allow higher spread factor. Higher coding rates ensure less packets dropped.
   uint8_t  _preambleLength; //Number of symbols. Different lengths does *not* guarantee a remote radio privacy. 8 to 11 works. 8 to 15 drops some. 8 to 20 is silent.
 
+  //Reliability settings
+  ARQMode  _arqMode; //Broadcast, selective repeat (single rover) or NACK (multi-rover)
+  uint16_t _maxCorrectionAge_ms; //Retransmissions are never scheduled past this age
+  FrameSizing _frameSizing; //Fixed, aligned to hop boundaries, or aligned and shrunk under loss
+
+  //Link adaptation settings
+  uint8_t  _roverID; //Which report slot this rover answers in, 0 to MAX_LINK_ROVERS - 1
+  bool     _adaptiveRate; //Base moves between airSpeed presets and TX powers based on rover reports
+  uint16_t _linkReportInterval_ms; //How often each rover is given a report slot
+
  //These settings can technically be changed, but the end user typically should not alter them
   uint16_t _timeoutBeforeSendingFrame_ms; //Send partial buffer if time expires
   uint8_t  _responseDelayDivisor; //Add on to max response time after packet has been sent. Factor of 2. 8 is ok. 4 is good. A smaller number increases the delay.
@@ -95,8 +140,9 @@ private:
   float    _frequencyMax; //MHz
   uint8_t  _numberOfChannels; //Divide the min/max freq band into this number of channels and hop between.
   uint16_t _maxDwellTime; //Max number of ms before hopping (if enabled). Useful for configuring radio to be within regulator limits (FCC = 400ms max)
+  uint8_t  _reconfigAnnouncements; //Number of times a pending link configuration is announced before both ends switch over
 
-  float *_channels; // CHannel frequencies for hopping
+  float *_channels = nullptr; // CHannel frequencies for hopping
 
   //Encryption
   uint16_t _seed;
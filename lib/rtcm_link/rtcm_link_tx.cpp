@@ -10,7 +10,27 @@ uint16_t RTCM_Link::availableTXBytes() {
 }
 
 void RTCM_Link::bufferTXByte(uint8_t data) {
-    _txBuffer[_txHead++] = data;
+  _txBuffer[_txHead++] = data;
+  _txHead %= sizeof(_txBuffer);
+  _lastByteReceived_ms = 0;
+}
+
+//Copy a whole frame into the transmit buffer. The frame is dropped, rather than split, if it does not fit
+bool RTCM_Link::bufferTXFrame(const uint8_t* data, uint16_t length) {
+  if (length >= sizeof(_txBuffer) - availableTXBytes())
+    return (false);
+
+  uint16_t untilWrap = sizeof(_txBuffer) - _txHead;
+  if (length <= untilWrap) {
+    memcpy(&_txBuffer[_txHead], data, length);
+  }
+  else {
+    memcpy(&_txBuffer[_txHead], data, untilWrap);
+    memcpy(_txBuffer, &data[untilWrap], length - untilWrap);
+  }
+  _txHead = (_txHead + length) % sizeof(_txBuffer);
+  _lastByteReceived_ms = 0;
+  return (true);
 }
 
 //Return true if there is a full frame of data in the buffer, or the timeout has been exceded
@@ -39,7 +59,7 @@ void RTCM_Link::_sendPacket() {
   if (_settings->airSpeed() == 28800 || _settings->airSpeed() == 38400)
     delay(2);
 
-  _radio.setFrequency(_settings->getChannel(_radio.getFHSSChannel())); //Return home before every transmission
+  _radio.setFrequency(_afcChannel(_radio.getFHSSChannel())); //Return home before every transmission
   
   int state = _radio.startTransmit(_outgoingPacket, _packetSize);
   if (state == RADIOLIB_ERR_NONE) {
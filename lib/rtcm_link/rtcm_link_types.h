@@ -4,6 +4,16 @@
 
 #include <Arduino.h>
 
+#define MAX_PACKET_SIZE 255 //Limited by SX127x
+#define ARQ_MAX_WINDOW 8 //Frames held for retransmission, also the width of the selective ACK bitmap
+#define ARQ_HEADER_SIZE 2 //Sequence number + oldest sequence still held by the sender
+#define MIN_FRAME_SIZE 32 //Adaptive frame sizing never shrinks frames below this
+#define MAX_LINK_ROVERS 4 //Rover IDs that get a link report slot
+#define LINK_FALLBACK_REPORTS 6 //Report intervals without hearing the other end before returning to the home link settings
+#define NACK_SLOT_GUARD_MS 4 //Radio turnaround between one rover's NACK slot and the next
+#define REPORT_SLOT_SIZE 3 //Frames sent (2) and slot owner, at the end of a data frame that opens a report slot
+#define LINK_REPORT_SIZE (ARQ_HEADER_SIZE + 9) //ARQ status + rover ID, RSSI, SNR, frames sent (2), frames received (2), fix type, carrier solution
+
 //Possible types of packets received
 enum class PacketType {
   BAD = 0,
@@ -14,7 +24,10 @@ enum class PacketType {
 
   TRAINING_PING,
   TRAINING_DATA,
-  TRAINING_ACK
+  TRAINING_ACK,
+
+  CONFIG,
+  LINK_REPORT
 };
 
 //Bit field to indicate what type of packet we are dealing with
@@ -22,8 +35,78 @@ struct ControlTrailer {
   uint8_t ping : 1;
   uint8_t ack : 1;
   uint8_t train : 1;
-  uint8_t filler : 5;
+  uint8_t config : 1;
+  uint8_t seq : 1;  //Data packet carries an ARQ sequence header
+  uint8_t nack : 1; //Receivers only report gaps (multi-rover NACK mode)
+  uint8_t report : 1; //Data: a rover report slot follows, owner ID appended. ACK: carries a link report
+  uint8_t filler : 1;
+};
+
+//How data packets are protected against loss
+enum class ARQMode : uint8_t {
+  BROADCAST = 0,    //Send once, no feedback
+  SELECTIVE_REPEAT, //Single rover, every frame acknowledged
+  NACK              //Multi-rover broadcast, rovers report gaps in a slot after each frame
+};
+
+//How the base sizes data frames
+enum class FrameSizing : uint8_t {
+  FIXED = 0,     //Always fill up to frameSize
+  DWELL_ALIGNED, //Trim frames so they end on a hop boundary
+  ADAPTIVE       //Dwell aligned, and shrink frames while loss is high
+};
+
+//One frame held in a sliding window, on either end of the link
+struct ARQFrame {
+  uint8_t data[MAX_PACKET_SIZE];
+  uint8_t size;
+  uint8_t seq;
+  uint8_t retries;
+  bool inUse;
+  bool acked;
+  bool resend;
+  elapsedMillis age;       //Time since first transmission
+  elapsedMillis sinceSent; //Time since last (re)transmission
 };
 
+//Link statistics for comparing ARQ modes against pure broadcast
+struct ARQStats {
+  uint32_t framesSent;
+  uint32_t retransmissions;
+  uint32_t framesAcked;
+  uint32_t framesExpired;
+  uint32_t bytesAcked;
+  uint32_t ackLatencySum_ms; //Sum of first send to ACK times, divide by framesAcked for the mean
+};
+
+//Base: how well data frames use the air time they occupy
+struct FrameStats {
+  uint32_t framesSent;
+  uint32_t payloadBytes; //Correction bytes, excluding headers, trailer and SF6 padding
+  uint32_t airTime_ms;
+};
+
+
+//Rover: how closely the AFC estimate tracks the base, from the frequency error left on each packet
+struct AFCStats {
+  uint32_t samples;
+  uint32_t rejected;       //Errors too large to be crystal offset
+  float residualSum_Hz;    //Divide by samples for the mean
+  float residualSqSum_Hz2; //Divide by samples and take the root for the RMS
+  float residualMax_Hz;    //Largest magnitude seen
+};
+
+//Latest link quality reported by a rover
+struct RoverStatus {
+  bool active;
+  int8_t rssi;        //dBm
+  float snr;          //dB
+  uint8_t per;        //Packet error rate, 0-255 = 0-100%, frames missed or corrupted against frames sent
+  uint8_t fixType;    //GNSS fix type of the rover
+  uint8_t carrSoln;   //0 = none, 1 = RTK float, 2 = RTK fixed
+  elapsedMillis lastReport;
+  uint16_t framesSent;     //Base frame count the last report arrived against, wrapping
+  uint16_t framesReceived; //Rover frame count in the last report, wrapping
+};
 
 #endif
\ No newline at end of file
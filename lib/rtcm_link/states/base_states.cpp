@@ -9,12 +9,27 @@ void RXStandby::update(RTCM_Link* radio) {
     radio->_transactionComplete = false; //Reset ISR flag
     radio->changeState(RXPacket::getInstance());
   }
+  else if (radio->_reconfigPending && radio->_reconfigTimer >= radio->_reconfigAt_ms) {//Announced switch-over time reached
+    radio->_applyPendingConfig();
+  }
+  else if (radio->_fallbackDue()) {//The other end has been lost on adapted settings
+    radio->_fallBack();
+  }
   else if (radio->_timeToHop == true) {//If the dio1ISR has fired, move to next frequency
     radio->_hopChannel();
   }
-  else {//Transmit data if the radio is available and transmit data is ready
-    if (radio->receiveInProcess() == false && radio->checkTX() == true) {
-      radio->changeState(TX::getInstance());
+  else {//Transmit data if the radio is available, transmit data is ready and the rovers' NACK slots are over
+    if (radio->receiveInProcess() == false && radio->_ackDelay >= radio->_replyWindow_ms) {
+      if (radio->_announceDue()) {
+        radio->changeState(ConfigTX::getInstance());
+      }
+      else if (radio->_arqRetransmitDue()) {
+        radio->changeState(TX::getInstance());
+      }
+      else if (radio->checkTX() == true) {
+        if (radio->_settings->arqMode() == ARQMode::BROADCAST || radio->_arqWindowOpen())
+          radio->changeState(TX::getInstance());
+      }
     }
   } //End Process Waiting Serial
 }
@@ -26,20 +41,59 @@ RadioStateBase& RXStandby::getInstance() {
 
 void RXPacket::update(RTCM_Link* radio) {
   PacketType packetType = radio->identifyPacketType(); //Look at the packet we just received
+  if (packetType != PacketType::BAD && packetType != PacketType::NETID_MISMATCH)
+    radio->_lastHeard = 0;
 
   if (packetType == PacketType::TRAINING_PING || packetType == PacketType::TRAINING_DATA) {
     //We should not be receiving ack or training packets packets, but if we do, just ignore
-    radio->_frequencyCorrection += radio->_radio.getFrequencyError() / 1000000.0;
+    radio->_afcUpdate();
     radio->changeState(RXStandby::getInstance());
   }
   else if (packetType == PacketType::DATA) {
-    //Move this packet into the receive buffer
-    for (int x = 0 ; x < radio->_lastPacketSize ; x++) {
-      radio->_rxBuffer[radio->_rxHead++] = radio->_lastPacket[x];
-      radio->_rxHead %= sizeof(radio->_rxBuffer);
+    radio->_afcUpdate();
+    radio->_updateLinkQuality();
+
+    bool ackDue = false;
+    if (radio->_RXTrailer.seq == 1) {
+      ackDue = radio->_arqReceiveFrame(); //Sequenced frame, reorder and acknowledge
+    }
+    else {
+      //Move this packet into the receive buffer
+      radio->_bufferRXBytes(radio->_lastPacket, radio->_lastPacketSize);
     }
 
-    radio->_frequencyCorrection += radio->_radio.getFrequencyError() / 1000000.0;
+    if (radio->_RXTrailer.report == 1 && radio->_reportSlotOwner == radio->_settings->roverID())
+      radio->changeState(ReportTX::getInstance()); //Our report slot, the report carries the ACK too
+    else if (ackDue && radio->_RXTrailer.nack == 1)
+      radio->changeState(NACKWait::getInstance()); //Rovers answer in turn, in roverID order
+    else if (ackDue)
+      radio->changeState(ACKTX::getInstance());
+    else
+      radio->changeState(RXStandby::getInstance());
+  }
+  else if (packetType == PacketType::ACK) {
+    //A rover is reporting which frames it holds
+    if (radio->_lastPacketSize == ARQ_HEADER_SIZE)
+      radio->_arqProcessACK(radio->_lastPacket);
+    radio->changeState(RXStandby::getInstance());
+  }
+  else if (packetType == PacketType::LINK_REPORT) {
+    //A rover is reporting link quality in its slot
+    radio->_processLinkReport();
+    radio->_adaptLink();
+    radio->changeState(RXStandby::getInstance());
+  }
+  else if (packetType == PacketType::CONFIG) {
+    //The base has announced new link settings, switch over at the same instant it does
+    uint8_t configSize = radio->_settings->trainDataPacketSize();
+    if (radio->_lastPacketSize == configSize + sizeof(radio->_reconfigAt_ms) + 1) {
+      radio->_pendingSettings.readLinkConfig(radio->_lastPacket);
+      memcpy(&radio->_reconfigAt_ms, &radio->_lastPacket[configSize], sizeof(radio->_reconfigAt_ms));
+      radio->_pendingHome = radio->_lastPacket[configSize + sizeof(radio->_reconfigAt_ms)];
+      radio->_reconfigTimer = 0;
+      radio->_reconfigAnnounced = radio->_settings->reconfigAnnouncements(); //Only the announcing end repeats it
+      radio->_reconfigPending = true;
+    }
     radio->changeState(RXStandby::getInstance());
   }
   else {//PACKET_BAD, PACKET_NETID_MISMATCH
@@ -55,27 +109,65 @@ RadioStateBase& RXPacket::getInstance() {
 
 
 void TX::enter(RTCM_Link* radio) {
-  uint16_t bytesToSend = radio->availableTXBytes();
-  if (bytesToSend > radio->_settings->frameSize())
-    bytesToSend = radio->_settings->frameSize();
+  uint16_t maxBytes = radio->_frameSizeLimit();
 
   //SF6 requires an implicit header which means there is no dataLength in the header
   if (radio->_settings->spreadFactor() == 6) {
-    if (bytesToSend > 255 - 3) 
-      bytesToSend = 255 - 3; //We are going to transmit 255 bytes no matter what
+    if (maxBytes > 255 - 3) 
+      maxBytes = 255 - 3; //We are going to transmit 255 bytes no matter what
+  }
+  else if (radio->_settings->frameSizing() != FrameSizing::FIXED) {
+    maxBytes = radio->_settings->dwellPacketSize(maxBytes + 2) - 2; //End the packet, with its control bytes, before a hop
+  }
+
+  //Open a report slot for one of the rovers after this frame
+  bool reportSlot = radio->_reportSlotDue();
+  if (reportSlot)
+    maxBytes -= REPORT_SLOT_SIZE; //Make room for the frame count and slot owner
+
+  if (radio->_settings->arqMode() != ARQMode::BROADCAST) {
+    radio->_arqLoadFrame(maxBytes); //Retransmission or new frame, followed by the sequence header
+  }
+  else {
+    uint16_t bytesToSend = radio->availableTXBytes();
+    if (bytesToSend > maxBytes)
+      bytesToSend = maxBytes;
+
+    radio->_packetSize = bytesToSend;
+
+    //Move this portion of the circular buffer into the outgoingPacket
+    for (uint8_t x = 0 ; x < radio->_packetSize ; x++) {
+      radio->_outgoingPacket[x] = radio->_txBuffer[radio->_txTail++];
+      radio->_txTail %= sizeof(radio->_txBuffer);
+    }
   }
 
-  radio->_packetSize = bytesToSend;
+  //A retransmission keeps the size it was first sent at, which may leave no room for the slot
+  if (reportSlot && radio->_packetSize > maxBytes) {
+    radio->_deferReportSlot();
+    reportSlot = false;
+  }
 
-  //Move this portion of the circular buffer into the outgoingPacket
-  for (uint8_t x = 0 ; x < radio->_packetSize ; x++) {
-    radio->_outgoingPacket[x] = radio->_txBuffer[radio->_txTail++];
-    radio->_txTail %= sizeof(radio->_txBuffer);
+  //Frames sent, counting this one, for the rover to send back in its report
+  if (reportSlot) {
+    uint16_t framesSent = radio->_frameStats.framesSent + 1;
+    memcpy(&radio->_outgoingPacket[radio->_packetSize], &framesSent, sizeof(framesSent));
+    radio->_packetSize += sizeof(framesSent);
+    radio->_outgoingPacket[radio->_packetSize++] = radio->_reportSlotOwner;
   }
 
   radio->_TXTrailer.ping  = 0; //This is not an empty ping packet
   radio->_TXTrailer.ack   = 0; //This is not an ACK packet
   radio->_TXTrailer.train = 0; //This is not a training packet
+  radio->_TXTrailer.config = 0; //This is not a configuration announcement
+  radio->_TXTrailer.seq = (radio->_settings->arqMode() != ARQMode::BROADCAST);
+  radio->_TXTrailer.nack = (radio->_settings->arqMode() == ARQMode::NACK);
+  radio->_TXTrailer.report = reportSlot;
+
+  //Count only the correction bytes, not the sequence header or report slot
+  uint8_t payloadBytes = radio->_packetSize - (reportSlot ? REPORT_SLOT_SIZE : 0);
+  if (radio->_settings->arqMode() != ARQMode::BROADCAST)
+    payloadBytes -= ARQ_HEADER_SIZE;
 
   radio->_packetSize += 2; //Make room for control bytes
 
@@ -86,13 +178,20 @@ void TX::enter(RTCM_Link* radio) {
     radio->_outgoingPacket[255 - 3] = radio->_packetSize + 1;
     radio->_packetSize = 255; //We're now going to transmit 255 bytes
   }
+
+  radio->_frameStats.framesSent++;
+  radio->_frameStats.payloadBytes += payloadBytes;
+  radio->_frameStats.airTime_ms += radio->_settings->airTime(radio->_packetSize);
   radio->_sendPacket();
 }
 
 void TX::update(RTCM_Link* radio) {
   if (radio->_transactionComplete == true) {//If dio0ISR has fired, we are done transmitting
     radio->_transactionComplete = false; //Reset ISR flag
-    radio->changeState(RXStandby::getInstance()); //No ack response when in broadcasting mode
+    if (radio->_settings->arqMode() == ARQMode::BROADCAST && radio->_TXTrailer.report == 0)
+      radio->changeState(RXStandby::getInstance()); //No ack response when in broadcasting mode
+    else
+      radio->changeState(ReplyWait::getInstance()); //Leave the channel free for the ACK/NACK or link report
   }
   else if (radio->_timeToHop == true) //If the dio1ISR has fired, move to next frequency
     radio->_hopChannel();
@@ -102,4 +201,180 @@ RadioStateBase& TX::getInstance()
 {
 	static TX singleton;
 	return singleton;
+}
+
+void ConfigTX::enter(RTCM_Link* radio) {
+  uint8_t configSize = radio->_settings->trainDataPacketSize();
+  radio->_pendingSettings.writeLinkConfig(radio->_outgoingPacket);
+
+  //Time left once this packet has landed, so the rovers can start their switch-over timer on reception
+  uint32_t switchDelay = radio->_reconfigAt_ms - radio->_reconfigTimer - radio->_settings->airTime(radio->_configPacketSize());
+  memcpy(&radio->_outgoingPacket[configSize], &switchDelay, sizeof(switchDelay));
+  radio->_outgoingPacket[configSize + sizeof(switchDelay)] = radio->_pendingHome; //Chosen by the user, the rovers keep it too
+  radio->_packetSize = configSize + sizeof(switchDelay) + 1;
+
+  radio->_TXTrailer.ping  = 0; //This is not an empty ping packet
+  radio->_TXTrailer.ack   = 0; //This is not an ACK packet
+  radio->_TXTrailer.train = 0; //This is not a training packet
+  radio->_TXTrailer.config = 1; //This is a configuration announcement
+  radio->_TXTrailer.seq = 0; //There is no sequence header
+  radio->_TXTrailer.nack = 0;
+  radio->_TXTrailer.report = 0; //No report slot follows
+
+  radio->_packetSize += 2; //Make room for control bytes
+
+  //SF6 requires an implicit header which means there is no dataLength in the header
+  if (radio->_settings->spreadFactor() == 6) {
+    radio->_outgoingPacket[255 - 3] = radio->_packetSize + 1;
+    radio->_packetSize = 255; //We're now going to transmit 255 bytes
+  }
+
+  radio->_reconfigAnnounced++;
+  radio->_lastAnnounce = 0;
+  radio->_sendPacket();
+}
+
+void ConfigTX::update(RTCM_Link* radio) {
+  if (radio->_transactionComplete == true) {//If dio0ISR has fired, we are done transmitting
+    radio->_transactionComplete = false; //Reset ISR flag
+    radio->changeState(RXStandby::getInstance());
+  }
+  else if (radio->_timeToHop == true) //If the dio1ISR has fired, move to next frequency
+    radio->_hopChannel();
+}
+
+RadioStateBase& ConfigTX::getInstance()
+{
+	static ConfigTX singleton;
+	return singleton;
+}
+
+//Listen for an ACK (selective repeat), NACK (NACK slot) or link report after a data frame
+//In NACK mode the first reply is not the last, so RXStandby keeps the channel clear until every slot is over
+void ReplyWait::enter(RTCM_Link* radio) {
+  radio->_returnToRX();
+  radio->_ackDelay = 0;
+  uint16_t timeout = radio->_TXTrailer.report ? radio->_settings->reportTimeout() : radio->_settings->ackTimeout();
+  radio->_replyWindow_ms = (radio->_settings->arqMode() == ARQMode::NACK) ? timeout : 0;
+}
+
+void ReplyWait::update(RTCM_Link* radio) {
+  uint16_t timeout = radio->_TXTrailer.report ? radio->_settings->reportTimeout() : radio->_settings->ackTimeout();
+
+  if (radio->_transactionComplete == true) {//If dio0ISR has fired, a packet has arrived
+    radio->_transactionComplete = false; //Reset ISR flag
+    radio->changeState(RXPacket::getInstance());
+  }
+  else if (radio->_timeToHop == true) {//If the dio1ISR has fired, move to next frequency
+    radio->_hopChannel();
+  }
+  else if (radio->_ackDelay > timeout && radio->receiveInProcess() == false) {
+    radio->changeState(RXStandby::getInstance()); //Nothing heard, carry on
+  }
+}
+
+RadioStateBase& ReplyWait::getInstance()
+{
+	static ReplyWait singleton;
+	return singleton;
+}
+
+//Rover: report the next frame needed and the frames held beyond it
+void ACKTX::enter(RTCM_Link* radio) {
+  radio->_arqWriteStatus(radio->_outgoingPacket);
+  radio->_packetSize = ARQ_HEADER_SIZE;
+
+  radio->_TXTrailer.ping  = 0; //This is not an empty ping packet
+  radio->_TXTrailer.ack   = 1; //This is an ACK packet
+  radio->_TXTrailer.train = 0; //This is not a training packet
+  radio->_TXTrailer.config = 0; //This is not a configuration announcement
+  radio->_TXTrailer.seq = 0; //There is no sequence header
+  radio->_TXTrailer.nack = 0;
+  radio->_TXTrailer.report = 0; //There is no link report
+
+  radio->_packetSize += 2; //Make room for control bytes
+
+  //SF6 requires an implicit header which means there is no dataLength in the header
+  if (radio->_settings->spreadFactor() == 6) {
+    radio->_outgoingPacket[255 - 3] = radio->_packetSize + 1;
+    radio->_packetSize = 255; //We're now going to transmit 255 bytes
+  }
+  radio->_sendPacket();
+}
+
+void ACKTX::update(RTCM_Link* radio) {
+  if (radio->_transactionComplete == true) {//If dio0ISR has fired, we are done transmitting
+    radio->_transactionComplete = false; //Reset ISR flag
+    radio->changeState(RXStandby::getInstance());
+  }
+  else if (radio->_timeToHop == true) //If the dio1ISR has fired, move to next frequency
+    radio->_hopChannel();
+}
+
+RadioStateBase& ACKTX::getInstance()
+{
+	static ACKTX singleton;
+	return singleton;
+}
+
+//Rover: hold a NACK until this rover's slot, after the link report and the slots of the lower rover IDs
+void NACKWait::enter(RTCM_Link* radio) {
+  radio->_returnToRX();
+  radio->_ackDelay = 0;
+}
+
+void NACKWait::update(RTCM_Link* radio) {
+  if (radio->_transactionComplete == true) {//Another rover's reply, not for us
+    radio->_transactionComplete = false; //Reset ISR flag
+    radio->_returnToRX();
+  }
+  else if (radio->_timeToHop == true) {//If the dio1ISR has fired, move to next frequency
+    radio->_hopChannel();
+  }
+  else if (radio->_ackDelay >= radio->_settings->nackDelay(radio->_RXTrailer.report) && radio->receiveInProcess() == false) {
+    radio->changeState(ACKTX::getInstance());
+  }
+}
+
+RadioStateBase& NACKWait::getInstance()
+{
+	static NACKWait singleton;
+	return singleton;
+}
+
+//Rover: send link quality, and the ARQ status, in our report slot
+void ReportTX::enter(RTCM_Link* radio) {
+  radio->_writeLinkReport();
+
+  radio->_TXTrailer.ping  = 0; //This is not an empty ping packet
+  radio->_TXTrailer.ack   = 1; //This is an ACK packet
+  radio->_TXTrailer.train = 0; //This is not a training packet
+  radio->_TXTrailer.config = 0; //This is not a configuration announcement
+  radio->_TXTrailer.seq = 0; //There is no sequence header
+  radio->_TXTrailer.nack = 0;
+  radio->_TXTrailer.report = 1; //This ACK carries a link report
+
+  radio->_packetSize += 2; //Make room for control bytes
+
+  //SF6 requires an implicit header which means there is no dataLength in the header
+  if (radio->_settings->spreadFactor() == 6) {
+    radio->_outgoingPacket[255 - 3] = radio->_packetSize + 1;
+    radio->_packetSize = 255; //We're now going to transmit 255 bytes
+  }
+  radio->_sendPacket();
+}
+
+void ReportTX::update(RTCM_Link* radio) {
+  if (radio->_transactionComplete == true) {//If dio0ISR has fired, we are done transmitting
+    radio->_transactionComplete = false; //Reset ISR flag
+    radio->changeState(RXStandby::getInstance());
+  }
+  else if (radio->_timeToHop == true) //If the dio1ISR has fired, move to next frequency
+    radio->_hopChannel();
+}
+
+RadioStateBase& ReportTX::getInstance()
+{
+	static ReportTX singleton;
+	return singleton;
 }
\ No newline at end of file
@@ -44,4 +44,69 @@ private:
 	TX& operator=(const TX& other);
 };
 
+class ConfigTX : public RadioStateBase {
+public:
+	void enter(RTCM_Link* radio);
+	void update(RTCM_Link* radio);
+	void exit(RTCM_Link* radio) {}
+	static RadioStateBase& getInstance();
+
+private:
+	ConfigTX() {}
+	ConfigTX(const ConfigTX& other);
+	ConfigTX& operator=(const ConfigTX& other);
+};
+
+class ReplyWait : public RadioStateBase {
+public:
+	void enter(RTCM_Link* radio);
+	void update(RTCM_Link* radio);
+	void exit(RTCM_Link* radio) {}
+	static RadioStateBase& getInstance();
+
+private:
+	ReplyWait() {}
+	ReplyWait(const ReplyWait& other);
+	ReplyWait& operator=(const ReplyWait& other);
+};
+
+class ACKTX : public RadioStateBase {
+public:
+	void enter(RTCM_Link* radio);
+	void update(RTCM_Link* radio);
+	void exit(RTCM_Link* radio) {}
+	static RadioStateBase& getInstance();
+
+private:
+	ACKTX() {}
+	ACKTX(const ACKTX& other);
+	ACKTX& operator=(const ACKTX& other);
+};
+
+class NACKWait : public RadioStateBase {
+public:
+	void enter(RTCM_Link* radio);
+	void update(RTCM_Link* radio);
+	void exit(RTCM_Link* radio) {}
+	static RadioStateBase& getInstance();
+
+private:
+	NACKWait() {}
+	NACKWait(const NACKWait& other);
+	NACKWait& operator=(const NACKWait& other);
+};
+
+class ReportTX : public RadioStateBase {
+public:
+	void enter(RTCM_Link* radio);
+	void update(RTCM_Link* radio);
+	void exit(RTCM_Link* radio) {}
+	static RadioStateBase& getInstance();
+
+private:
+	ReportTX() {}
+	ReportTX(const ReportTX& other);
+	ReportTX& operator=(const ReportTX& other);
+};
+
 #endif
\ No newline at end of file
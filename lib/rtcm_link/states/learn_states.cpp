@@ -18,12 +18,20 @@ void LearnTX::enter(RTCM_Link* radio) {
     radio->_TXTrailer.ping  = 1; //This is an empty ping packet
     radio->_TXTrailer.ack   = 0; //This is not an ACK packet
     radio->_TXTrailer.train = 1; //This is a training packet
+    radio->_TXTrailer.config = 0; //This is not a configuration announcement
+    radio->_TXTrailer.seq = 0; //There is no sequence header
+    radio->_TXTrailer.nack = 0;
+    radio->_TXTrailer.report = 0;
     radio->_packetSize = 2;
   } else {
     //Send an ACK packet
     radio->_TXTrailer.ping  = 0; //This is an empty ping packet
     radio->_TXTrailer.ack   = 1; //This is not an ACK packet
     radio->_TXTrailer.train = 1; //This is a training packet
+    radio->_TXTrailer.config = 0; //This is not a configuration announcement
+    radio->_TXTrailer.seq = 0; //There is no sequence header
+    radio->_TXTrailer.nack = 0;
+    radio->_TXTrailer.report = 0;
     radio->_packetSize = 2;
   }
 
@@ -17,7 +17,7 @@ void gnssBaseSettings::load() {
   // Allocate a temporary JsonDocument
   // Don't forget to change the capacity to match your requirements.
   // Use arduinojson.org/v6/assistant to compute the capacity.
-  StaticJsonDocument<512> doc;
+  StaticJsonDocument<1024> doc;
 
   // Deserialize the JSON document
   DeserializationError error = deserializeJson(doc, configFile);
@@ -33,6 +33,28 @@ void gnssBaseSettings::load() {
   radioSettings.spreadFactor(doc["rtcmLink"]["spreadFactor"]);
   radioSettings.codingRate(doc["rtcmLink"]["codingRate"]);
   radioSettings.preambleLength(doc["rtcmLink"]["preambleLength"]);
+  radioSettings.arqMode((ARQMode)doc["rtcmLink"]["arqMode"].as<uint8_t>());
+  radioSettings.maxCorrectionAge_ms(doc["rtcmLink"]["maxCorrectionAge"]);
+  radioSettings.frameSizing((FrameSizing)doc["rtcmLink"]["frameSizing"].as<uint8_t>());
+  radioSettings.roverID(doc["rtcmLink"]["roverID"]);
+  radioSettings.adaptiveRate(doc["rtcmLink"]["adaptiveRate"]);
+  radioSettings.linkReportInterval_ms(doc["rtcmLink"]["linkReportInterval"]);
+
+  // Copy the GNSS settings. Files saved before these were stored keep the defaults
+  gnssSettings.defaultSettings();
+  gnssSettings.gps(doc["gnss"]["gps"] | gnssSettings.gps());
+  gnssSettings.glonass(doc["gnss"]["glonass"] | gnssSettings.glonass());
+  gnssSettings.galileo(doc["gnss"]["galileo"] | gnssSettings.galileo());
+  gnssSettings.beidou(doc["gnss"]["beidou"] | gnssSettings.beidou());
+  gnssSettings.lat(doc["gnss"]["lat"] | gnssSettings.lat());
+  gnssSettings.latHP(doc["gnss"]["latHP"] | gnssSettings.latHP());
+  gnssSettings.lon(doc["gnss"]["lon"] | gnssSettings.lon());
+  gnssSettings.lonHP(doc["gnss"]["lonHP"] | gnssSettings.lonHP());
+  gnssSettings.alt(doc["gnss"]["alt"] | gnssSettings.alt());
+  gnssSettings.altHP(doc["gnss"]["altHP"] | gnssSettings.altHP());
+  gnssSettings.baseMode((BaseMode)(doc["gnss"]["baseMode"] | (uint8_t)gnssSettings.baseMode()));
+  gnssSettings.surveyTime_s(doc["gnss"]["surveyTime"] | gnssSettings.surveyTime_s());
+  gnssSettings.surveyAccuracy_mm(doc["gnss"]["surveyAccuracy"] | gnssSettings.surveyAccuracy_mm());
   
   // Close the file (Curiously, File's destructor doesn't close the file)
   configFile.close();
@@ -49,7 +71,7 @@ void gnssBaseSettings::save() {
   // Allocate a temporary JsonDocument
   // Don't forget to change the capacity to match your requirements.
   // Use arduinojson.org/v6/assistant to compute the capacity.
-  StaticJsonDocument<512> doc;
+  StaticJsonDocument<1024> doc;
 
   // Copy the radio settings
   doc["rtcmLink"]["netID"] = radioSettings.netID();
@@ -60,6 +82,27 @@ void gnssBaseSettings::save() {
   doc["rtcmLink"]["spreadFactor"] = radioSettings.spreadFactor();
   doc["rtcmLink"]["codingRate"] = radioSettings.codingRate();
   doc["rtcmLink"]["preambleLength"] = radioSettings.preambleLength();
+  doc["rtcmLink"]["arqMode"] = (uint8_t)radioSettings.arqMode();
+  doc["rtcmLink"]["maxCorrectionAge"] = radioSettings.maxCorrectionAge_ms();
+  doc["rtcmLink"]["frameSizing"] = (uint8_t)radioSettings.frameSizing();
+  doc["rtcmLink"]["roverID"] = radioSettings.roverID();
+  doc["rtcmLink"]["adaptiveRate"] = radioSettings.adaptiveRate();
+  doc["rtcmLink"]["linkReportInterval"] = radioSettings.linkReportInterval_ms();
+
+  // Copy the GNSS settings
+  doc["gnss"]["gps"] = gnssSettings.gps();
+  doc["gnss"]["glonass"] = gnssSettings.glonass();
+  doc["gnss"]["galileo"] = gnssSettings.galileo();
+  doc["gnss"]["beidou"] = gnssSettings.beidou();
+  doc["gnss"]["lat"] = gnssSettings.lat();
+  doc["gnss"]["latHP"] = gnssSettings.latHP();
+  doc["gnss"]["lon"] = gnssSettings.lon();
+  doc["gnss"]["lonHP"] = gnssSettings.lonHP();
+  doc["gnss"]["alt"] = gnssSettings.alt();
+  doc["gnss"]["altHP"] = gnssSettings.altHP();
+  doc["gnss"]["baseMode"] = (uint8_t)gnssSettings.baseMode();
+  doc["gnss"]["surveyTime"] = gnssSettings.surveyTime_s();
+  doc["gnss"]["surveyAccuracy"] = gnssSettings.surveyAccuracy_mm();
 
   // Serialize JSON to file
   if (serializeJson(doc, configFile) == 0) {
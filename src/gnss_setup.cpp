@@ -0,0 +1,414 @@
+#include "system.h"
+#include "settings.h"
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <gnss_config.h>
+#include <gnss_base_mode.h>
+#include <gnss_averager.h>
+#include <gnss_rtcm_planner.h>
+#include <gnss_nav_database.h>
+#include <gnss_raw_logger.h>
+#include <gnss_clock.h>
+#include <gnss_rtcm_encoder.h>
+#include <gnss_bus_budget.h>
+#include <gnss_transport.h>
+#include <rtcm_link.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <LittleFS.h>
+
+extern SFE_UBLOX_GNSS zedf9p;
+extern gnssBaseSettings systemSettings;
+extern GNSSTelemetry gnssTelemetry;
+extern LittleFS_QSPIFlash systemFS;
+extern RTCM_Link radioLink;
+
+//Receiver Configuration
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+GNSSConfig gnssConfig;
+GNSSBaseMode gnssBaseMode;
+GNSSAverager gnssAverager;
+GNSSRTCMPlanner rtcmPlanner;
+GNSSRTCMEncoder rtcmEncoder;
+GNSSNavDatabase navDatabase;
+File navDatabaseFile;
+GNSSRawLogger rawLogger;
+GNSSClock gnssClock;
+GNSSBusBudget busBudget;
+GNSSTransport gnssTransport;
+bool hotStart = false; //A saved navigation database was sent to the receiver this boot
+
+const uint8_t NAVIGATION_RATE_HZ = 20;
+
+const char AVERAGE_FILE[] = "/average";
+const uint32_t AVERAGE_CHECKPOINT_MS = 600000; //Lose at most ten minutes of averaging to a reboot
+
+const char NAV_DATABASE_FILE[] = "/navdb";
+const char NAV_DATABASE_TEMP_FILE[] = "/navdb.tmp"; //Written first, so a reset mid-save leaves the last copy intact
+const uint32_t NAV_DATABASE_SAVE_MS = 1800000; //Ephemerides last a few hours, so a copy this old still hot starts
+
+const uint8_t RAW_LOG_RATE_HZ = 10;
+
+//Build the MSMs and 1005 from RAWX in firmware rather than in the receiver. Limited to the RAWX rate
+const bool FIRMWARE_RTCM = false;
+const uint32_t RTCM_ENCODER_REPORT_MS = 60000;
+const uint32_t RAW_LOG_REPORT_MS = 60000;
+
+const uint8_t GNSS_PPS_PIN = 2; //Receiver TIMEPULSE
+const uint32_t CLOCK_REPORT_MS = 60000;
+
+//How the receiver is connected. UART1 at 921600 baud or SPI have room for full-constellation MSM7 and RAWX that
+//I2C does not. SPI needs the receiver's D_SEL pin strapped low, which turns I2C and UART1 off
+const GNSSPort GNSS_PORT = GNSSPort::I2C;
+const uint32_t I2C_CLOCK_HZ = 400000;
+HardwareSerial& GNSS_SERIAL = Serial2;      //Pins 7 and 8 to the receiver's TXD and RXD
+const uint32_t GNSS_UART_BAUD = 921600;
+SPIClass& GNSS_SPI = SPI1;                  //The display has SPI
+const uint8_t GNSS_SPI_CS_PIN = 38;
+const uint32_t GNSS_SPI_CLOCK_HZ = 5500000; //The ZED-F9P's limit
+const uint8_t GNSS_SPI_TRANSACTION = 128;   //Bytes read per transaction. Idle bytes cost a transaction's worth at most
+const uint32_t BUS_REPORT_MS = 60000;
+//=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+//Message output keys are named here by their I2C key, and moved to the port in use as they are set
+static uint32_t portKey(uint32_t i2cKey) {
+  return (gnssTransport.outputKey(i2cKey));
+}
+
+//Observation message keys for each constellation, in Constellation order
+static const uint32_t MSM4_KEYS[] = { UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1074_I2C, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1084_I2C,
+                                      UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1094_I2C, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1124_I2C };
+static const uint32_t MSM7_KEYS[] = { UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1077_I2C, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1087_I2C,
+                                      UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1097_I2C, UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1127_I2C };
+
+//A queued configuration was NACKed or timed out, so the next one has to write every key
+static void configureGNSSDone(uint8_t cls, uint8_t id, sfe_ublox_status_e status) {
+  if (status != SFE_UBLOX_STATUS_DATA_SENT) {
+    gnssConfig.forget();
+    Serial.printf("GNSS configuration failed: %s\r\n", zedf9p.statusString(status));
+  }
+}
+
+//Build the whole receiver configuration from the settings and apply it as one transaction.
+//Only keys that differ from what the receiver already has are written, to RAM and BBR together.
+//With wait false the write is queued and the ACK is handled from checkUblox, so the loop keeps running.
+bool configureGNSS(bool wait) {
+  GNSSSettings& settings = systemSettings.gnssSettings;
+  gnssConfig.clear();
+
+  //UBX for the UI, RTCM for the radio, no NMEA
+  gnssConfig.set(gnssTransport.protocolKey(UBLOX_CFG_I2COUTPROT_UBX), 1);
+  gnssConfig.set(gnssTransport.protocolKey(UBLOX_CFG_I2COUTPROT_NMEA), 0);
+  gnssConfig.set(gnssTransport.protocolKey(UBLOX_CFG_I2COUTPROT_RTCM3X), 1);
+  gnssConfig.set(UBLOX_CFG_RATE_MEAS, 1000 / NAVIGATION_RATE_HZ);
+
+  gnssConfig.set(UBLOX_CFG_SIGNAL_GPS_ENA, settings.gps());
+  gnssConfig.set(UBLOX_CFG_SIGNAL_GLO_ENA, settings.glonass());
+  gnssConfig.set(UBLOX_CFG_SIGNAL_GAL_ENA, settings.galileo());
+  gnssConfig.set(UBLOX_CFG_SIGNAL_BDS_ENA, settings.beidou());
+
+  //Station position once a second. Observations for each enabled constellation as the link allows
+  const RTCMPlan& plan = rtcmPlanner.plan();
+  bool enabled[] = { settings.gps(), settings.glonass(), settings.galileo(), settings.beidou() };
+  for (uint8_t x = 0; x < (uint8_t)Constellation::COUNT; x++) {
+    gnssConfig.set(portKey(MSM4_KEYS[x]), (enabled[x] && !FIRMWARE_RTCM && plan.msm == MSMType::MSM4) ? plan.interval : 0);
+    gnssConfig.set(portKey(MSM7_KEYS[x]), (enabled[x] && !FIRMWARE_RTCM && plan.msm == MSMType::MSM7) ? plan.interval : 0);
+  }
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1005_I2C), FIRMWARE_RTCM ? 0 : NAVIGATION_RATE_HZ);
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_RTCM_3X_TYPE1230_I2C), settings.glonass() ? NAVIGATION_RATE_HZ : 0);
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_SAT_I2C), NAVIGATION_RATE_HZ * 10); //Tracked satellites for the planner and sky view
+
+  //Navigation for the UI every epoch, or less often while the bus is needed for RTCM and the raw log
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_PVT_I2C), busBudget.uiInterval());
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_HPPOSLLH_I2C), busBudget.uiInterval());
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_STATUS_I2C), busBudget.uiInterval());
+
+  //Raw observations and navigation subframes for post-processing
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_RXM_RAWX_I2C), NAVIGATION_RATE_HZ / RAW_LOG_RATE_HZ);
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_RXM_SFRBX_I2C), 1);
+
+  //Time pulse for the system clock: rising at the top of each GPS second, and only once locked to GNSS time
+  gnssConfig.set(UBLOX_CFG_TP_TP1_ENA, 1);
+  gnssConfig.set(UBLOX_CFG_TP_TIMEGRID_TP1, 1); //GPS
+  gnssConfig.set(UBLOX_CFG_TP_ALIGN_TO_TOW_TP1, 1);
+  gnssConfig.set(UBLOX_CFG_TP_POL_TP1, 1);
+  gnssConfig.set(UBLOX_CFG_TP_USE_LOCKED_TP1, 1);
+  gnssConfig.set(UBLOX_CFG_TP_PERIOD_LOCK_TP1, 1000000); //us
+  gnssConfig.set(UBLOX_CFG_TP_LEN_LOCK_TP1, 100000);     //us
+  gnssConfig.set(UBLOX_CFG_TP_LEN_TP1, 0);               //No pulse until locked
+
+  //High precision ECEF for the long-term average once a second. Consecutive epochs are too correlated to add much
+  gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_HPPOSECEF_I2C), NAVIGATION_RATE_HZ);
+
+  //Survey-in until a position has been stored, then fixed from the stored position. Averaging turns base mode off
+  //so the receiver navigates
+  if (settings.baseMode() == BaseMode::AVERAGE) {
+    gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_SVIN_I2C), 0);
+    gnssConfig.set(UBLOX_CFG_TMODE_MODE, 0); //Disabled
+  }
+  else if (settings.baseMode() == BaseMode::SURVEY_IN) {
+    gnssConfig.set(UBLOX_CFG_TMODE_MODE, 1); //Survey-in
+    gnssConfig.set(UBLOX_CFG_TMODE_SVIN_MIN_DUR, settings.surveyTime_s());
+    gnssConfig.set(UBLOX_CFG_TMODE_SVIN_ACC_LIMIT, (uint32_t)settings.surveyAccuracy_mm() * 10); //mm * 0.1
+    gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_SVIN_I2C), NAVIGATION_RATE_HZ); //Progress once a second
+  }
+  else {
+    gnssConfig.set(portKey(UBLOX_CFG_MSGOUT_UBX_NAV_SVIN_I2C), 0);
+    gnssConfig.set(UBLOX_CFG_TMODE_MODE, 2);     //Fixed
+    gnssConfig.set(UBLOX_CFG_TMODE_POS_TYPE, 1); //LLH
+    gnssConfig.set(UBLOX_CFG_TMODE_LAT, (uint32_t)settings.lat());
+    gnssConfig.set(UBLOX_CFG_TMODE_LAT_HP, (uint8_t)settings.latHP());
+    gnssConfig.set(UBLOX_CFG_TMODE_LON, (uint32_t)settings.lon());
+    gnssConfig.set(UBLOX_CFG_TMODE_LON_HP, (uint8_t)settings.lonHP());
+    gnssConfig.set(UBLOX_CFG_TMODE_HEIGHT, (uint32_t)settings.alt());
+    gnssConfig.set(UBLOX_CFG_TMODE_HEIGHT_HP, (uint8_t)settings.altHP());
+  }
+
+  bool success = wait ? gnssConfig.apply(zedf9p) : gnssConfig.applyAsync(zedf9p, &configureGNSSDone);
+  Serial.printf("GNSS configuration: %u keys, %u changed, %u messages, %lu ms%s\r\n",
+                gnssConfig.keys(), gnssConfig.changedKeys(), gnssConfig.messagesSent(),
+                gnssConfig.applyTime_ms(), success ? "" : " FAILED");
+  return (success);
+}
+
+//Connect to the receiver on the port chosen above
+bool beginGNSS() {
+  bool connected;
+  if (GNSS_PORT == GNSSPort::UART) {
+    connected = gnssTransport.beginUART(zedf9p, GNSS_SERIAL, GNSS_UART_BAUD);
+  }
+  else if (GNSS_PORT == GNSSPort::SPI) {
+    connected = gnssTransport.beginSPI(zedf9p, GNSS_SPI, GNSS_SPI_CS_PIN, GNSS_SPI_CLOCK_HZ, GNSS_SPI_TRANSACTION);
+  }
+  else {
+    connected = gnssTransport.beginI2C(zedf9p, Wire, I2C_CLOCK_HZ);
+    //Poll four times an epoch, as setNavigationFrequency would. The rate goes in through CFG-RATE-MEAS, which
+    //leaves the library polling every 100ms
+    zedf9p.setI2CpollingWait(1000 / NAVIGATION_RATE_HZ / 4);
+  }
+  Serial.printf("u-blox GNSS %s on %s at %lu\r\n", connected ? "started" : "not detected", gnssTransport.name(),
+                gnssTransport.clock_Hz());
+  return (connected);
+}
+
+//Watch survey-in through NAV-SVIN. Must be called before configureGNSS, which sets the NAV-SVIN rate
+bool beginBaseMode() {
+  return (gnssBaseMode.begin(zedf9p, systemSettings.gnssSettings));
+}
+
+//Start the long-term position average, carrying on from the last checkpoint. Must be called before configureGNSS
+bool beginPositionAverage() {
+  bool success = gnssAverager.begin(zedf9p, gnssTelemetry);
+
+  if (systemFS.exists(AVERAGE_FILE)) {
+    AveragerState state;
+    File averageFile = systemFS.open(AVERAGE_FILE);
+    if (averageFile.read(&state, sizeof(state)) == sizeof(state) && gnssAverager.restore(state))
+      Serial.printf("Position average restored: %llu samples\r\n", gnssAverager.count());
+    averageFile.close();
+  }
+  return (success);
+}
+
+//Write the accumulator to flash, over the last checkpoint. FILE_WRITE would open at the end and append, so the
+//restore would keep reading the first checkpoint ever written. Read it back to check
+void checkpointPositionAverage() {
+  File averageFile = systemFS.open(AVERAGE_FILE, FILE_WRITE_BEGIN);
+  averageFile.write(&gnssAverager.state(), sizeof(AveragerState));
+  averageFile.truncate(sizeof(AveragerState));
+  averageFile.close();
+
+  AveragerState state;
+  averageFile = systemFS.open(AVERAGE_FILE);
+  bool verified = averageFile.size() == sizeof(state) && averageFile.read(&state, sizeof(state)) == sizeof(state) &&
+                  memcmp(&state, &gnssAverager.state(), sizeof(state)) == 0;
+  averageFile.close();
+  if (!verified)
+    Serial.println("Position average checkpoint did not read back");
+}
+
+void updatePositionAverage() {
+  static elapsedMillis lastCheckpoint = 0;
+  if (lastCheckpoint > AVERAGE_CHECKPOINT_MS) {
+    lastCheckpoint = 0;
+    checkpointPositionAverage();
+  }
+}
+
+//Make the averaged position the base position and switch the receiver to fixed mode
+bool applyPositionAverage() {
+  double lat, lon, height;
+  if (!gnssAverager.meanLLH(lat, lon, height))
+    return (false);
+
+  GNSSSettings& settings = systemSettings.gnssSettings;
+  settings.position(lat, lon, height);
+  settings.baseMode(BaseMode::FIXED);
+  systemSettings.save();
+  Serial.printf("Base position from %llu averaged samples, scatter %.3fm\r\n", gnssAverager.count(), gnssAverager.sigma_m());
+  return (configureGNSS(false));
+}
+
+//Start a new average
+void resetPositionAverage() {
+  gnssAverager.reset();
+  checkpointPositionAverage();
+}
+
+//Plan the RTCM output against the radio link capacity. Must be called before configureGNSS
+void beginRTCMPlanner() {
+  rtcmPlanner.navigationRate(NAVIGATION_RATE_HZ);
+}
+
+//Encode RTCM from RAWX in firmware, if it is turned on. Must be called before configureGNSS
+bool beginRTCMEncoder() {
+  if (!FIRMWARE_RTCM)
+    return (false);
+  return (rtcmEncoder.begin(zedf9p, systemSettings.gnssSettings, &rtcmFrameReady));
+}
+
+//Re-plan as the tracked satellites, enabled constellations or radio settings change. The capacity comes from the
+//link's live settings, which adaptive rate and switch-overs change without touching the stored ones
+void updateRTCMPlan() {
+  static bool planned = false;
+  static uint16_t linkChanges = 0;
+  GNSSSettings& settings = systemSettings.gnssSettings;
+  rtcmPlanner.satellites(gnssTelemetry.sky());
+  rtcmPlanner.constellations(settings.gps(), settings.glonass(), settings.galileo(), settings.beidou());
+  if (!planned || radioLink.settingsChanges() != linkChanges) {
+    planned = true;
+    linkChanges = radioLink.settingsChanges();
+    rtcmPlanner.capacity(radioLink.settings().rtcmThroughput());
+  }
+  if (rtcmPlanner.update())
+    configureGNSS(false);
+  if (!FIRMWARE_RTCM)
+    return;
+
+  //The plan interval is in navigation epochs, the encoder's in RAWX epochs
+  static elapsedMillis lastReport = 0;
+  const RTCMPlan& plan = rtcmPlanner.plan();
+  rtcmEncoder.plan(plan.msm, plan.interval / (NAVIGATION_RATE_HZ / RAW_LOG_RATE_HZ));
+  rtcmEncoder.constellations(settings.gps(), settings.glonass(), settings.galileo(), settings.beidou());
+  if (lastReport > RTCM_ENCODER_REPORT_MS) {
+    lastReport = 0;
+    rtcmEncoder.printStatus(Serial);
+  }
+}
+
+//Once survey-in finishes, store the position and switch the receiver to fixed mode
+void updateBaseMode() {
+  if (gnssBaseMode.update()) {
+    systemSettings.save();
+    configureGNSS(false);
+  }
+}
+
+//Send the saved navigation database to the receiver so it can hot start. Call straight after begin
+bool beginNavDatabase() {
+  navDatabase.begin(zedf9p);
+  if (!systemFS.exists(NAV_DATABASE_FILE)) {
+    Serial.println("No navigation database saved. Cold start");
+    return (false);
+  }
+
+  navDatabaseFile = systemFS.open(NAV_DATABASE_FILE);
+  if (!navDatabase.restore(navDatabaseFile)) {
+    navDatabaseFile.close();
+    Serial.println("Navigation database restore failed. Cold start");
+    return (false);
+  }
+  return (true);
+}
+
+//Start a save of the navigation database
+static void saveNavDatabase() {
+  systemFS.remove(NAV_DATABASE_TEMP_FILE);
+  navDatabaseFile = systemFS.open(NAV_DATABASE_TEMP_FILE, FILE_WRITE);
+  if (!navDatabaseFile || !navDatabase.save(navDatabaseFile))
+    navDatabaseFile.close();
+}
+
+//Carry on with a restore or save, save periodically once there is a fix, and report the start up times
+//so a hot start can be compared with a cold one
+void updateNavDatabase() {
+  static elapsedMillis lastSave = 0;
+  static uint32_t firstFix_ms = 0;
+  static bool startReported = false;
+
+  NavDatabaseState state = navDatabase.state();
+  if (navDatabase.update()) {
+    navDatabaseFile.close();
+    if (state == NavDatabaseState::SAVING && navDatabase.succeeded()) {
+      systemFS.remove(NAV_DATABASE_FILE);
+      systemFS.rename(NAV_DATABASE_TEMP_FILE, NAV_DATABASE_FILE);
+    }
+    if (state == NavDatabaseState::RESTORING)
+      hotStart = navDatabase.succeeded();
+    Serial.printf("Navigation database %s %s: %lu entries, %lu bytes, %lu ms\r\n",
+                  state == NavDatabaseState::SAVING ? "save" : "restore", navDatabase.succeeded() ? "complete" : "FAILED",
+                  navDatabase.entries(), navDatabase.bytes(), navDatabase.duration_ms());
+  }
+
+  const GNSSSnapshot& snapshot = gnssTelemetry.snapshot();
+  bool fix = snapshot.valid && (snapshot.fixType == 3 || snapshot.fixType == 4);
+  if (fix && firstFix_ms == 0)
+    firstFix_ms = millis();
+
+  if (!startReported && firstFix_ms != 0 && gnssBaseMode.correctionsStarted()) {
+    startReported = true;
+    Serial.printf("%s start: first fix %lu ms (receiver TTFF %lu ms), first RTCM %lu ms after power up\r\n",
+                  hotStart ? "Hot" : "Cold", firstFix_ms, snapshot.ttff, gnssBaseMode.timeToFirstRTCM_ms());
+  }
+
+  if (fix && navDatabase.state() == NavDatabaseState::IDLE && lastSave > NAV_DATABASE_SAVE_MS) {
+    lastSave = 0;
+    saveNavDatabase();
+  }
+}
+
+//Record raw observations to flash for post-processing. Must be called before configureGNSS, which sets the rates
+bool beginRawLogger() {
+  return (rawLogger.begin(zedf9p, &systemFS));
+}
+
+void updateRawLogger() {
+  static elapsedMillis lastReport = 0;
+  rawLogger.update();
+  if (lastReport > RAW_LOG_REPORT_MS) {
+    lastReport = 0;
+    rawLogger.printStatus(Serial);
+  }
+}
+
+//Discipline the cycle counter to the receiver's time pulse, for GNSS timestamps
+void beginGNSSClock() {
+  gnssClock.begin(gnssTelemetry, GNSS_PPS_PIN);
+}
+
+void updateGNSSClock() {
+  static elapsedMillis lastReport = 0;
+  gnssClock.update();
+  if (lastReport > CLOCK_REPORT_MS) {
+    lastReport = 0;
+    gnssClock.printStatus(Serial);
+  }
+}
+
+//Meter the bus by message. Must be called before configureGNSS, which sets the UI message rates
+void beginBusBudget() {
+  busBudget.begin(zedf9p, gnssTransport);
+}
+
+//Derate or restore the UI messages as the bus needs
+void updateBusBudget() {
+  static elapsedMillis lastReport = 0;
+  if (busBudget.update()) {
+    Serial.printf("%s bus %.0f%% busy: UI navigation every %u epochs\r\n", gnssTransport.name(),
+                  busBudget.usage().utilisation * 100.0, busBudget.uiInterval());
+    configureGNSS(false);
+  }
+  if (lastReport > BUS_REPORT_MS) {
+    lastReport = 0;
+    busBudget.printStatus(Serial);
+  }
+}
@@ -5,6 +5,7 @@
 #include <LittleFS.h>
 #include <ILI9341_T4.h>
 #include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <gnss_telemetry.h>
 
 #include "system.h"
 #include "settings.h"
@@ -19,15 +20,13 @@ gnssBaseSettings systemSettings;
 extern ScreenManager screenManager;
 
 SFE_UBLOX_GNSS zedf9p;
+GNSSTelemetry gnssTelemetry;
 
 void setup() {
   Serial.begin(115200);
   while(!Serial){}
   beginDisplay();
 
-  Wire.begin();
-  Wire.setClock(400000);
-
   beginFileSystem();
   calibration.fileSystem(&systemFS);
   calibration.load();
@@ -37,18 +36,33 @@ void setup() {
   systemSettings.fileName(calibration.lastConfig);
   systemSettings.load();
 
-  if (zedf9p.begin(Wire) == false) { //Connect to the u-blox module using Wire port
-    Serial.println(F("u-blox GNSS not detected at default I2C address. Please check wiring. Freezing."));
+  //Read the receiver in bounded steps so a burst of RTCM does not stall the UI and radio. The I2C buffer is only
+  //used on I2C. A UART has its own receive ring, and SPI reads a transaction at a time
+  zedf9p.setI2CBufferSize(2048);
+  zedf9p.setI2CReadBudget(256);
+  zedf9p.setProcessTimeBudget(500);
+  //Raw observations queue here until they are written to flash. 10Hz RAWX with four constellations is about
+  //26KB/s, so this covers over half a second of flash stalls. The logger reports the peak it has seen
+  zedf9p.setFileBufferSize(16384);
+  if (beginGNSS() == false) { //Connect to the u-blox module on I2C, UART1 or SPI
+    Serial.println(F("Please check wiring. Freezing."));
     while (1);
-  } else {
-    Serial.println(F("u-blox GNSS started."));
   }
 
-  zedf9p.setI2COutput(COM_TYPE_UBX); //Set the I2C port to output UBX only (turn off NMEA noise)
-  zedf9p.setNavigationFrequency(20); //Set output to 20 times a second
+  beginNavDatabase(); //Hot start from the last saved ephemerides, sent a batch per loop
+  beginBaseMode(); //Survey-in progress, or straight to fixed mode from the stored position
+  beginPositionAverage(); //Long-term average of the base position, carried over reboots
+  beginRTCMPlanner(); //RTCM observations sized to what the radio link can carry
+  beginRTCMEncoder(); //MSMs built from RAWX in firmware, when FIRMWARE_RTCM is set
+  beginRawLogger(); //Raw observations to flash, for post-processing if the link fails
+  beginBusBudget(); //Bus bytes per message, and the UI message rates the bus can afford
+  configureGNSS(); //Output protocols, rate, constellations, RTCM messages and base position in one transaction
+  zedf9p.setRTCMFrameCallbackPtr(&rtcmFrameReady); //Pass checked RTCM frames straight to the radio
+  gnssTelemetry.begin(zedf9p); //Navigation data arrives each epoch, the UI reads it from a snapshot
+  beginGNSSClock(); //GNSS time from the time pulse, to stamp RTCM frames
 
   beginWDT();
-  //beginRTCMLink(systemSettings.radioSettings);
+  beginRTCMLink(systemSettings.radioSettings); //The link saves into the stored radio settings only what the user chose
   Serial.println("Configuration Complete.");
 }
 
@@ -56,6 +70,15 @@ void loop() {
   petWDT();
   lv_task_handler();
   screenManager.update();
+  gnssTelemetry.update();
+  updateBaseMode();
+  updatePositionAverage();
+  updateRTCMPlan();
+  updateNavDatabase();
+  updateRawLogger();
+  updateGNSSClock();
+  updateBusBudget();
 
-  //radioLink.update();
+  updateRTCMLink();
+  reportLinkStatus();
 }
\ No newline at end of file
@@ -1,13 +1,25 @@
 
 #include "system.h"
+#include "settings.h"
 #include "rtcm_link.h"
 #include "rtcm_link_settings.h"
+#include <gnss_base_mode.h>
+#include <gnss_clock.h>
+#include <rtcm_delta.h>
+
+extern gnssBaseSettings systemSettings;
+extern GNSSBaseMode gnssBaseMode;
+extern GNSSClock gnssClock;
 
 //RTCM Radio Link
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 RTCM_Link radioLink;
+RTCMDeltaEncoder rtcmDelta;
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
+//Send MSMs as deltas between keyframes, about half the bytes. Only for rovers that run the RTCMDeltaDecoder
+const bool RTCM_DELTA = false;
+
 //Radio Link ISRs
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 void DIO0ISR(){
@@ -30,7 +42,7 @@ void DIO1ISR(){
 //radio DIO1 = 4;   Triggered when it's time to hop frequencies
 //radio RST  = 255;
 //=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
-void beginRTCMLink(RTCMSettings settings) {
+void beginRTCMLink(RTCMSettings& settings) {
   Serial.println("Begining RTCM Link Initialization...");
   radioLink.attachPetWDT(petWDT);
   Serial.println("WDT attached");
@@ -42,3 +54,61 @@ void beginRTCMLink(RTCMSettings settings) {
   Serial.println("RTCM Link Initialized");
 }
 
+//Run the link, and save the settings when it switches over to ones the user chose, on this end or the other.
+//Rates and powers adapted to the link are never saved, so this end comes back up on the user's settings
+void updateRTCMLink() {
+  static uint16_t savedChanges = 0;
+  radioLink.update();
+  if (radioLink.homeChanges() != savedChanges) {
+    savedChanges = radioLink.homeChanges();
+    systemSettings.save();
+  }
+}
+
+//MSM epoch time as GPS time of week. GPS, Galileo, SBAS and QZSS use it directly, BeiDou time is 14s behind.
+//GLONASS is Moscow time of day, which needs the leap seconds, so it is not stamped
+static bool msmEpochToGpsTow(uint16_t messageNumber, uint32_t epoch, uint32_t& tow_ms) {
+  switch (messageNumber / 10) {
+    case 107: case 109: case 110: case 111:
+      tow_ms = epoch;
+      return (true);
+    case 112:
+      tow_ms = (epoch + 14000) % 604800000;
+      return (true);
+    default:
+      return (false);
+  }
+}
+
+//Corrections from the receiver go into the radio transmit buffer a whole frame at a time.
+//Observations are stamped against their epoch, for the latency from measurement to the radio
+void rtcmFrameReady(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t epoch) {
+  if (RTCM_DELTA) {
+    const uint8_t* out;
+    uint16_t outLength = rtcmDelta.encode(frame, length, out);
+    radioLink.bufferTXFrame(out, outLength);
+  }
+  else
+    radioLink.bufferTXFrame(frame, length);
+  gnssBaseMode.rtcmReceived(messageNumber);
+
+  uint32_t tow_ms;
+  if (msmEpochToGpsTow(messageNumber, epoch, tow_ms))
+    gnssClock.stamp(tow_ms);
+}
+
+//Send the rover link status table out as telemetry, with the frame plan once a minute
+void reportLinkStatus() {
+  static elapsedMillis lastReport = 0;
+  static uint8_t reports = 0;
+  if (lastReport > 10000) {
+    lastReport = 0;
+    radioLink.printRoverStatus(Serial);
+    radioLink.printARQStatus(Serial);
+    radioLink.printAFCStatus(Serial);
+    if (reports++ % 6 == 0)
+      radioLink.printFramePlan(Serial);
+    if (RTCM_DELTA)
+      rtcmDelta.printStatus(Serial);
+  }
+}
@@ -17,7 +17,7 @@ void ScreenManager::setup() {
 void ScreenManager::update() {
   // Service the current screen.
   _screen->update(this);
-  _statusBar.setGNSSStatus(zedf9p.getFixType());
+  _statusBar.setGNSSStatus(gnssTelemetry.snapshot().fixType);
 }
 
 void ScreenManager::changeScreen(Screen& newScreen) {
@@ -6,6 +6,7 @@
 #include "ui/screen_manager.h"
 #include "ui/widgets/spinbox_widgets.h"
 #include "ui/widgets/dropdown_widgets.h"
+#include "system.h"
 
 static void top_btns_cb(lv_event_t * e) {
   lv_event_code_t code = lv_event_get_code(e);
@@ -20,6 +21,7 @@ static void top_btns_cb(lv_event_t * e) {
       case 1:
         ((GNSSSettingsScreen*)screenManager->currentScreen())->updateSettings();
         systemSettings.save();
+        configureGNSS(false); //Queued, so the UI and radio keep running while the receiver ACKs
         break;
       case 2:
         ((GNSSSettingsScreen*)screenManager->currentScreen())->updateSettings();
@@ -60,6 +62,11 @@ void GNSSSettingsScreen::enter(ScreenManager* screenManager) {
   beidou_cb = lv_checkbox_create(pageArea_);
   lv_checkbox_set_text(beidou_cb, "BeiDou");
   
+  baseMode = dropdown(pageArea_, "Base Mode");
+  lv_dropdown_set_options(baseMode.dropdown, "Survey-in\n"
+                                             "Fixed\n"
+                                             "Average");
+
   lat = SpinboxInt32(pageArea_, "Lat");
   lat.setRange(-900000000, 900000000);
   lat.setFormat(9, 0);
@@ -119,10 +126,12 @@ void GNSSSettingsScreen::updateControls() {
     lv_obj_clear_state(beidou_cb, LV_STATE_CHECKED);
   }
   
+  lv_dropdown_set_selected(baseMode.dropdown, (uint16_t)systemSettings.gnssSettings.baseMode());
+
   lat.setValue(systemSettings.gnssSettings.lat());
   latHP.setValue(systemSettings.gnssSettings.latHP());
   lon.setValue(systemSettings.gnssSettings.lon());
-  latHP.setValue(systemSettings.gnssSettings.lonHP());
+  lonHP.setValue(systemSettings.gnssSettings.lonHP());
   alt.setValue(systemSettings.gnssSettings.alt());
   altHP.setValue(systemSettings.gnssSettings.altHP());
   
@@ -134,6 +143,20 @@ void GNSSSettingsScreen::updateSettings() {
   lv_obj_get_state(galileo_cb) & LV_STATE_CHECKED ? systemSettings.gnssSettings.galileo(true) : systemSettings.gnssSettings.galileo(false);
   lv_obj_get_state(beidou_cb) & LV_STATE_CHECKED ? systemSettings.gnssSettings.beidou(true) : systemSettings.gnssSettings.beidou(false);
 
+  //Choosing Survey-in starts a new survey when the receiver is configured. A position typed in is only used in
+  //fixed mode, so entering one switches to it
+  GNSSSettings& settings = systemSettings.gnssSettings;
+  bool positionEdited = lat.getValue() != settings.lat() || latHP.getValue() != settings.latHP() ||
+                        lon.getValue() != settings.lon() || lonHP.getValue() != settings.lonHP() ||
+                        alt.getValue() != settings.alt() || altHP.getValue() != settings.altHP();
+  if (positionEdited) {
+    settings.baseMode(BaseMode::FIXED);
+    lv_dropdown_set_selected(baseMode.dropdown, (uint16_t)BaseMode::FIXED);
+  }
+  else {
+    settings.baseMode((BaseMode)lv_dropdown_get_selected(baseMode.dropdown));
+  }
+
   systemSettings.gnssSettings.lat(lat.getValue());
   systemSettings.gnssSettings.latHP(latHP.getValue());
   systemSettings.gnssSettings.lon(lon.getValue());
@@ -25,18 +25,31 @@ void HomeScreen::enter(ScreenManager* screenManager) {
   lv_obj_t* accLabel = lv_label_create(pageArea_);
   lv_label_set_text(accLabel, "Accuracy(meters):");
   _accVal = lv_label_create(pageArea_);
-  
+
+  lv_obj_t* baseLabel = lv_label_create(pageArea_);
+  lv_label_set_text(baseLabel, "Base:");
+  _baseVal = lv_label_create(pageArea_);
+
+  lv_obj_t* rtcmLabel = lv_label_create(pageArea_);
+  lv_label_set_text(rtcmLabel, "First Corrections:");
+  _rtcmVal = lv_label_create(pageArea_);
+
+  lv_obj_t* satLabel = lv_label_create(pageArea_);
+  lv_label_set_text(satLabel, "Satellites (used/tracked):");
+  _satVal = lv_label_create(pageArea_);
+  _skyView = skyView(pageArea_, 120);
 }
 
 void HomeScreen::update(ScreenManager* screenManager) {
   if (_lastUpdate > 1000) {
     _lastUpdate = 0;
-    // First, let's collect the position data
-    int32_t latitude = zedf9p.getHighResLatitude();
-    int8_t latitudeHp = zedf9p.getHighResLatitudeHp();
-    int32_t longitude = zedf9p.getHighResLongitude();
-    int8_t longitudeHp = zedf9p.getHighResLongitudeHp();
-    uint32_t accuracy = zedf9p.getHorizontalAccuracy();
+    // First, let's collect the position data from the latest epoch
+    const GNSSSnapshot& nav = gnssTelemetry.snapshot();
+    int32_t latitude = nav.lat;
+    int8_t latitudeHp = nav.latHp;
+    int32_t longitude = nav.lon;
+    int8_t longitudeHp = nav.lonHp;
+    uint32_t accuracy = nav.hAcc;
 
     
     // Defines storage for the lat and lon units integer and fractional parts
@@ -70,6 +83,33 @@ void HomeScreen::update(ScreenManager* screenManager) {
     lv_label_set_text_fmt(_latVal, "%d.%ld", lat_int, lat_frac);
     lv_label_set_text_fmt(_lonVal, "%d.%ld", lon_int, lon_frac);
     lv_label_set_text_fmt(_accVal, "%.4f", f_accuracy);
+
+    // Survey-in progress, or fixed once a position is stored
+    if (gnssBaseMode.surveying()) {
+      const SurveyStatus& survey = gnssBaseMode.survey();
+      lv_label_set_text_fmt(_baseVal, "Survey %lus, %.3fm", survey.duration_s, survey.meanAcc / 10000.0);
+    }
+    else if (gnssBaseMode.averaging()) {
+      lv_label_set_text(_baseVal, "Averaging");
+    }
+    else {
+      lv_label_set_text(_baseVal, "Fixed");
+    }
+
+    if (gnssBaseMode.correctionsStarted())
+      lv_label_set_text_fmt(_rtcmVal, "%.1fs after power up", gnssBaseMode.timeToFirstRTCM_ms() / 1000.0);
+    else
+      lv_label_set_text(_rtcmVal, "Waiting");
+
+    // Satellites from the latest NAV-SAT, G GPS, R GLONASS, E Galileo, C BeiDou
+    const SkySummary& sky = gnssTelemetry.sky();
+    const ConstellationSummary& gps = sky.constellation(Constellation::GPS);
+    const ConstellationSummary& glonass = sky.constellation(Constellation::GLONASS);
+    const ConstellationSummary& galileo = sky.constellation(Constellation::GALILEO);
+    const ConstellationSummary& beidou = sky.constellation(Constellation::BEIDOU);
+    lv_label_set_text_fmt(_satVal, "G%u/%u R%u/%u E%u/%u C%u/%u", gps.used, gps.tracked, glonass.used, glonass.tracked,
+                          galileo.used, galileo.tracked, beidou.used, beidou.tracked);
+    skyViewUpdate(_skyView, sky);
   }
 }
 
@@ -0,0 +1,73 @@
+#include "ui/screens/link_status_screen.h"
+
+#include <Arduino.h>
+
+#include "ui/screen_manager.h"
+
+
+void LinkStatusScreen::enter(ScreenManager* screenManager) {
+  Serial.println("Entering the Link Status screen");
+  screen_ = lv_obj_create(NULL);
+  screenManager->setPageLabel("Link Status");
+  pageArea_ = lv_obj_create(screen_);
+  lv_obj_set_size(pageArea_, 240, 320-35);
+  lv_obj_set_pos(pageArea_, 0, 35);
+  lv_obj_set_flex_flow(pageArea_, LV_FLEX_FLOW_COLUMN);
+
+  _linkVal = lv_label_create(pageArea_);
+
+  //One row per rover ID, filled from the rover link reports
+  _roverTable = lv_table_create(pageArea_);
+  lv_obj_set_width(_roverTable, LV_PCT(100));
+  lv_obj_set_style_text_font(_roverTable, &lv_font_montserrat_12, LV_PART_ITEMS);
+  lv_obj_set_style_pad_all(_roverTable, 2, LV_PART_ITEMS);
+  lv_table_set_col_cnt(_roverTable, 5);
+  lv_table_set_row_cnt(_roverTable, MAX_LINK_ROVERS + 1);
+  for (uint8_t col = 0; col < 5; col++)
+    lv_table_set_col_width(_roverTable, col, 40);
+
+  lv_table_set_cell_value(_roverTable, 0, 0, "ID");
+  lv_table_set_cell_value(_roverTable, 0, 1, "RSSI");
+  lv_table_set_cell_value(_roverTable, 0, 2, "SNR");
+  lv_table_set_cell_value(_roverTable, 0, 3, "PER");
+  lv_table_set_cell_value(_roverTable, 0, 4, "RTK");
+
+  _lastUpdate = 1000; //Fill the table straight away
+}
+
+void LinkStatusScreen::update(ScreenManager* screenManager) {
+  static const char* rtkState[] = {"None", "Float", "Fixed"};
+
+  if (_lastUpdate > 1000) {
+    _lastUpdate = 0;
+
+    //The link's own settings, which adaptive rate moves away from what was entered
+    RTCMSettings& link = radioLink.settings();
+    lv_label_set_text_fmt(_linkVal, "Air speed: %lu  Power: %u dBm%s", link.airSpeed(), link.broadcastPower_dbm(),
+                          radioLink.reconfigurePending() ? "  Switching" : "");
+
+    for (uint8_t id = 0; id < MAX_LINK_ROVERS; id++) {
+      RoverStatus& rover = radioLink.roverStatus(id);
+      lv_table_set_cell_value_fmt(_roverTable, id + 1, 0, "%u", id);
+      if (rover.active) {
+        lv_table_set_cell_value_fmt(_roverTable, id + 1, 1, "%d", rover.rssi);
+        lv_table_set_cell_value_fmt(_roverTable, id + 1, 2, "%.1f", rover.snr);
+        lv_table_set_cell_value_fmt(_roverTable, id + 1, 3, "%u%%", rover.per * 100 / 255);
+        lv_table_set_cell_value(_roverTable, id + 1, 4, rtkState[rover.carrSoln > 2 ? 0 : rover.carrSoln]);
+      }
+      else {
+        for (uint8_t col = 1; col < 5; col++)
+          lv_table_set_cell_value(_roverTable, id + 1, col, "-");
+      }
+    }
+  }
+}
+
+void LinkStatusScreen::exit(ScreenManager* screenManager) { 
+  lv_obj_del(screen_);
+}
+
+Screen& LinkStatusScreen::getInstance() {
+	static LinkStatusScreen singleton;
+	return singleton;
+}
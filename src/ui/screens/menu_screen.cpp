@@ -2,6 +2,7 @@
 #include "ui/screens/radio_settings_screen.h"
 #include "ui/screens/gnss_settings_screen.h"
 #include "ui/screens/system_screen.h"
+#include "ui/screens/link_status_screen.h"
 
 static void menu_cb(lv_event_t* e) {
   lv_event_code_t code = lv_event_get_code(e);
@@ -20,6 +21,9 @@ static void menu_cb(lv_event_t* e) {
         screenManager->changeScreen(GNSSSettingsScreen::getInstance());
         break;
       case 3:
+        screenManager->changeScreen(LinkStatusScreen::getInstance());
+        break;
+      case 4:
         screenManager->changeScreen(SystemScreen::getInstance());
         break;
     }
@@ -38,6 +42,7 @@ void MenuScreen::enter(ScreenManager* screenManager) {
   static const char * menuButtons_map[] = {"Home","\n",
                                            "Radio Settings","\n",
                                            "GNSS Settings","\n",
+                                           "Link Status","\n",
                                            "System", ""
                                          };
 
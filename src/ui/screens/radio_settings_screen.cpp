@@ -19,10 +19,16 @@ static void top_btns_cb(lv_event_t * e) {
       case 1:
         ((SettingsScreen*)screenManager->currentScreen())->updateControls();
         break;
-      case 2:
-        ((SettingsScreen*)screenManager->currentScreen())->updateSettings();
-        systemSettings.save();
+      case 2: {
+        //Edit a copy, the link keeps running on the stored settings until the announced switch-over
+        RTCMSettings edited;
+        uint8_t linkConfig[MAX_PACKET_SIZE];
+        systemSettings.radioSettings.writeLinkConfig(linkConfig);
+        edited.readLinkConfig(linkConfig);
+        ((SettingsScreen*)screenManager->currentScreen())->updateSettings(edited);
+        radioLink.scheduleReconfigure(edited); //Move the rovers over without retraining, saved once it takes effect
         break;
+      }
     }
   }
 }
@@ -201,45 +207,45 @@ void SettingsScreen::updateControls() {
   */
 }
 
-void SettingsScreen::updateSettings() {
+void SettingsScreen::updateSettings(RTCMSettings& settings) {
   //Set the Net ID to match the settings
-  systemSettings.radioSettings.netID(netID.getValue());
+  settings.netID(netID.getValue());
 
 
   //Set the air speed control to match the settings
   switch (lv_dropdown_get_selected(airSpeed.dropdown)) {
     case 0:
-      systemSettings.radioSettings.airSpeed(0);
+      settings.airSpeed(0);
       break;
     case 1:
-      systemSettings.radioSettings.airSpeed(40);
+      settings.airSpeed(40);
       break;
     case 2:
-      systemSettings.radioSettings.airSpeed(150);
+      settings.airSpeed(150);
       break;
     case 3:
-      systemSettings.radioSettings.airSpeed(400);
+      settings.airSpeed(400);
       break;
     case 4:
-      systemSettings.radioSettings.airSpeed(1200);
+      settings.airSpeed(1200);
       break;
     case 5:
-      systemSettings.radioSettings.airSpeed(2400);
+      settings.airSpeed(2400);
       break;
     case 6:
-      systemSettings.radioSettings.airSpeed(4800);
+      settings.airSpeed(4800);
       break;
     case 7:
-      systemSettings.radioSettings.airSpeed(9600);
+      settings.airSpeed(9600);
       break;
     case 8:
-      systemSettings.radioSettings.airSpeed(19200);
+      settings.airSpeed(19200);
       break;
     case 9:
-      systemSettings.radioSettings.airSpeed(28800);
+      settings.airSpeed(28800);
       break;
     case 10:
-      systemSettings.radioSettings.airSpeed(38400);
+      settings.airSpeed(38400);
       break;
     default:
       break;
@@ -248,44 +254,44 @@ void SettingsScreen::updateSettings() {
   //Set the Radio Bandwidth to match the settings
   switch (lv_dropdown_get_selected(bandwidth.dropdown)) {
     case 0:
-      systemSettings.radioSettings.bandwidth(1040);
+      settings.bandwidth(1040);
       break;
     case 1:
-      systemSettings.radioSettings.bandwidth(1560);
+      settings.bandwidth(1560);
       break;
     case 2:
-      systemSettings.radioSettings.bandwidth(2080);
+      settings.bandwidth(2080);
       break;
     case 3:
-      systemSettings.radioSettings.bandwidth(3125);
+      settings.bandwidth(3125);
       break;
     case 4:
-      systemSettings.radioSettings.bandwidth(4170);
+      settings.bandwidth(4170);
       break;
     case 5:
-      systemSettings.radioSettings.bandwidth(6250);
+      settings.bandwidth(6250);
       break;
     case 6:
-      systemSettings.radioSettings.bandwidth(12500);
+      settings.bandwidth(12500);
       break;
     case 7:
-      systemSettings.radioSettings.bandwidth(25000);
+      settings.bandwidth(25000);
       break;
     case 8:
-      systemSettings.radioSettings.bandwidth(50000);
+      settings.bandwidth(50000);
       break;
     default:
       break;
   }
                                                    
   //Set the Spread Factor to match the settings
-  systemSettings.radioSettings.spreadFactor(spreadFactor.getValue());
+  settings.spreadFactor(spreadFactor.getValue());
                                       
   //Set the Coding Rate to match the settings
-  systemSettings.radioSettings.codingRate(codingRate.getValue());
+  settings.codingRate(codingRate.getValue());
 
   //Set the Preamble Length to match the settings
-  systemSettings.radioSettings.preambleLength(preambleLength.getValue());
+  settings.preambleLength(preambleLength.getValue());
   
   /*
   void setEncryptionKey(AESKey key);
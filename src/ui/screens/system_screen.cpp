@@ -6,6 +6,7 @@
 #include <Arduino.h>
 
 #include "ui/screen_manager.h"
+#include "system.h"
 
 static void calibrate_cb(lv_event_t* e) {
   lv_event_code_t code = lv_event_get_code(e);
@@ -34,6 +35,22 @@ static void load_cb(lv_event_t* e) {
   }
 }
 
+static void use_average_cb(lv_event_t* e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  
+  if (code == LV_EVENT_CLICKED) {
+    applyPositionAverage();
+  }
+}
+
+static void reset_average_cb(lv_event_t* e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  
+  if (code == LV_EVENT_CLICKED) {
+    resetPositionAverage();
+  }
+}
+
 void SystemScreen::enter(ScreenManager* screenManager) {
   Serial.println("Entering the System screen");
   screen_ = lv_obj_create(NULL);
@@ -43,6 +60,9 @@ void SystemScreen::enter(ScreenManager* screenManager) {
   lv_obj_set_pos(pageArea_, 0, 35);
   lv_obj_set_flex_flow(pageArea_, LV_FLEX_FLOW_COLUMN);
 
+  _busVal = lv_label_create(pageArea_);
+  lv_obj_set_width(_busVal, LV_PCT(100));
+
   lv_obj_t * calibrateButton = lv_btn_create(pageArea_);
   lv_obj_set_size(calibrateButton, LV_PCT(100), 35);
   lv_obj_add_event_cb(calibrateButton, calibrate_cb, LV_EVENT_ALL, screenManager);
@@ -63,6 +83,22 @@ void SystemScreen::enter(ScreenManager* screenManager) {
   lv_obj_t* loadButtonLabel = lv_label_create(loadButton);
   lv_label_set_text(loadButtonLabel, "Load Settings");
   lv_obj_set_style_text_align(loadButtonLabel, LV_TEXT_ALIGN_CENTER, 0);
+
+  _averageVal = lv_label_create(pageArea_);
+
+  lv_obj_t * useAverageButton = lv_btn_create(pageArea_);
+  lv_obj_set_size(useAverageButton, LV_PCT(100), 35);
+  lv_obj_add_event_cb(useAverageButton, use_average_cb, LV_EVENT_ALL, screenManager);
+  lv_obj_t* useAverageButtonLabel = lv_label_create(useAverageButton);
+  lv_label_set_text(useAverageButtonLabel, "Use Averaged Position");
+  lv_obj_set_style_text_align(useAverageButtonLabel, LV_TEXT_ALIGN_CENTER, 0);
+
+  lv_obj_t * resetAverageButton = lv_btn_create(pageArea_);
+  lv_obj_set_size(resetAverageButton, LV_PCT(100), 35);
+  lv_obj_add_event_cb(resetAverageButton, reset_average_cb, LV_EVENT_ALL, screenManager);
+  lv_obj_t* resetAverageButtonLabel = lv_label_create(resetAverageButton);
+  lv_label_set_text(resetAverageButtonLabel, "Restart Average");
+  lv_obj_set_style_text_align(resetAverageButtonLabel, LV_TEXT_ALIGN_CENTER, 0);
 };
 
 void SystemScreen::exit(ScreenManager* screenManager) {
@@ -70,7 +106,17 @@ void SystemScreen::exit(ScreenManager* screenManager) {
 };
 
 void SystemScreen::update(ScreenManager* screenManager) {
+  if (_lastUpdate > 1000) {
+    _lastUpdate = 0;
+    lv_label_set_text_fmt(_averageVal, "Average: %llu samples, %.3fm", gnssAverager.count(), gnssAverager.sigma_m());
 
+    const BusUsage& bus = busBudget.usage();
+    lv_label_set_text_fmt(_busVal, "%s bus: %.0f%%, UI every %u epochs\nRTCM %.0f%% Raw %.0f%% UI %.0f%% Sky %.0f%%\nOther %.0f%% Overhead %.0f%%",
+                          gnssTransport.name(), bus.utilisation * 100.0, busBudget.uiInterval(), bus.group[(uint8_t)BusGroup::RTCM] * 100.0,
+                          bus.group[(uint8_t)BusGroup::RAW] * 100.0, bus.group[(uint8_t)BusGroup::UI] * 100.0,
+                          bus.group[(uint8_t)BusGroup::SKY] * 100.0, bus.group[(uint8_t)BusGroup::OTHER] * 100.0,
+                          bus.overhead * 100.0);
+  }
 }
 
 Screen& SystemScreen::getInstance() {
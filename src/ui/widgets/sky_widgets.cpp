@@ -0,0 +1,47 @@
+#include <Arduino.h>
+#include <lvgl.h>
+#include "ui/widgets/sky_widgets.h"
+
+static const lv_coord_t SATELLITE_SIZE = 6;
+
+//Horizon at the edge, zenith in the centre, north up. The satellite dots are created once and moved
+SkyView skyView(lv_obj_t* parent, lv_coord_t size){
+  SkyView newSkyView;
+  newSkyView.radius = size / 2;
+
+  newSkyView.sky = lv_obj_create(parent);
+  lv_obj_set_size(newSkyView.sky, size, size);
+  lv_obj_set_style_radius(newSkyView.sky, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(newSkyView.sky, 0, LV_PART_MAIN);
+  lv_obj_clear_flag(newSkyView.sky, LV_OBJ_FLAG_SCROLLABLE);
+
+  for (uint8_t x = 0; x < SKY_MAX_SATELLITES; x++) {
+    lv_obj_t* satellite = lv_obj_create(newSkyView.sky);
+    lv_obj_set_size(satellite, SATELLITE_SIZE, SATELLITE_SIZE);
+    lv_obj_set_style_radius(satellite, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+    lv_obj_set_style_border_width(satellite, 0, LV_PART_MAIN);
+    lv_obj_add_flag(satellite, LV_OBJ_FLAG_HIDDEN);
+    newSkyView.satellites[x] = satellite;
+  }
+
+  return newSkyView;
+}
+
+//Satellites used in the solution are green, those only tracked are grey
+void skyViewUpdate(SkyView& view, const SkySummary& summary){
+  lv_coord_t edge = view.radius - SATELLITE_SIZE / 2;
+  for (uint8_t x = 0; x < SKY_MAX_SATELLITES; x++) {
+    lv_obj_t* dot = view.satellites[x];
+    if (x >= summary.satellites) {
+      lv_obj_add_flag(dot, LV_OBJ_FLAG_HIDDEN);
+      continue;
+    }
+
+    const SkySatellite& satellite = summary.sky[x];
+    float r = edge * (90 - satellite.elev) / 90.0;
+    float azimuth = radians(satellite.azim2 * 2);
+    lv_obj_set_pos(dot, edge + r * sin(azimuth), edge - r * cos(azimuth));
+    lv_obj_set_style_bg_color(dot, lv_palette_main(satellite.used ? LV_PALETTE_GREEN : LV_PALETTE_GREY), LV_PART_MAIN);
+    lv_obj_clear_flag(dot, LV_OBJ_FLAG_HIDDEN);
+  }
+}
@@ -0,0 +1,58 @@
+//Timing for the host benchmarks. Cycles come from the time stamp counter on x86, which runs at a fixed rate close
+//to the core clock. Elsewhere they are left at 0 and only the throughput is reported. Host figures compare one
+//version of the code with another; they are not Teensy figures
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class Stopwatch {
+public:
+  //Start from zero. A new Stopwatch is already at zero, so resume() can be used from the first lap
+  void start() {
+    _seconds = 0;
+    _cycles = 0;
+    resume();
+  }
+
+  //Carry on adding to the totals, after a stop() around work that is not being measured
+  void resume() {
+    _lapCycles = _cycleCount();
+    _start = std::chrono::steady_clock::now();
+  }
+
+  void stop() {
+    _seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    _cycles += _cycleCount() - _lapCycles;
+  }
+
+  double seconds() const { return (_seconds); }
+  uint64_t cycles() const { return (_cycles); }
+
+  //One line per measurement: name, MB/s and cycles per byte
+  void report(const char* name, uint64_t bytes) const {
+    printf("%-32s %9.1f MB/s %7.2f cycles/byte\r\n", name, bytes / _seconds / 1e6, (double)_cycles / bytes);
+  }
+
+private:
+  std::chrono::steady_clock::time_point _start;
+  double _seconds = 0;
+  uint64_t _cycles = 0;
+  uint64_t _lapCycles = 0;
+
+  static uint64_t _cycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return (__rdtsc());
+#else
+    return (0);
+#endif
+  }
+};
+
+#endif
@@ -0,0 +1,31 @@
+//Textbook byte and bit at a time checksums, for the tests to check lib/checksum against and the benchmarks to
+//measure it against. The Fletcher-8 is the loop SFE_UBLOX_GNSS::addToChecksum used to run on every byte
+
+#ifndef _REFERENCE_CHECKSUMS_H_
+#define _REFERENCE_CHECKSUMS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+static inline void referenceFletcher8(const uint8_t* bytes, size_t length, uint8_t& checksumA, uint8_t& checksumB) {
+  for (size_t x = 0; x < length; x++) {
+    checksumA += bytes[x];
+    checksumB += checksumA;
+  }
+}
+
+//RTCM 10403.3 section 4: polynomial 0x1864CFB, a bit at a time
+static inline uint32_t referenceCRC24Q(const uint8_t* bytes, size_t length) {
+  uint32_t crc = 0;
+  for (size_t x = 0; x < length; x++) {
+    crc ^= (uint32_t)bytes[x] << 16;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc <<= 1;
+      if (crc & 0x1000000)
+        crc ^= 0x1864CFB;
+    }
+  }
+  return (crc & 0xFFFFFF);
+}
+
+#endif
@@ -0,0 +1,45 @@
+//Synthetic satellites for the RTCM suites: the constellations and second-band signals they use, a repeatable
+//random source, carrier wavelengths, and a callback that collects the frames the encoder gives out
+
+#ifndef _RTCM_FIXTURE_H_
+#define _RTCM_FIXTURE_H_
+
+#include <math.h>
+#include <vector>
+#include <rtcm.h>
+
+static const double SPEED_OF_LIGHT = 299792458.0;
+static const double TOW_S = 417600.0;
+static const uint8_t GNSS[] = { RTCM_GPS, RTCM_GLONASS, RTCM_GALILEO, RTCM_BEIDOU };
+static const uint8_t BAND_2_SIGID[] = { 3, 2, 6, 2 };     //L2 CL, L2 OF, E5b Q, B2I D1
+
+//Each suite sets the seed in setUp
+static uint32_t seed;
+static inline double uniform() {
+  seed = seed * 1103515245 + 12345;
+  return ((seed >> 8) / 16777216.0);
+}
+
+//Band 2 is the second signal each constellation's receiver tracks; GLONASS channels are spaced by freqId
+static inline double wavelength(uint8_t gnssId, bool band2, uint8_t freqId) {
+  double frequency;
+  if (gnssId == RTCM_GPS)
+    frequency = band2 ? 1227.60e6 : 1575.42e6;
+  else if (gnssId == RTCM_GALILEO)
+    frequency = band2 ? 1207.14e6 : 1575.42e6;
+  else if (gnssId == RTCM_BEIDOU)
+    frequency = band2 ? 1207.14e6 : 1561.098e6;
+  else
+    frequency = band2 ? 1246.0e6 + (freqId - 7) * 0.4375e6 : 1602.0e6 + (freqId - 7) * 0.5625e6;
+  return (SPEED_OF_LIGHT / frequency);
+}
+
+//Frames from the encoder, in order, and their message numbers
+static std::vector<std::vector<uint8_t>> frames;
+static std::vector<uint16_t> messageNumbers;
+static inline void collect(const uint8_t* frame, uint16_t length, uint16_t messageNumber, uint32_t) {
+  frames.push_back(std::vector<uint8_t>(frame, frame + length));
+  messageNumbers.push_back(messageNumber);
+}
+
+#endif
@@ -0,0 +1,112 @@
+//Just enough of Arduino.h for the libraries to build on the host, for the native unit tests. Nothing here is used
+//on the Teensy. Time only moves when a test, or a stand-in bus, moves it, so timings are the same on every run
+
+#ifndef _NATIVE_ARDUINO_H_
+#define _NATIVE_ARDUINO_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(x) (x)
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+template <class T> T min(T a, T b) { return (a < b ? a : b); }
+template <class T> T max(T a, T b) { return (a > b ? a : b); }
+template <class T, class U> T constrain(T a, U low, U high) { return (a < low ? low : (a > high ? high : a)); }
+
+//Virtual time in microseconds
+inline uint32_t nativeMicros = 0;
+inline uint32_t micros() { return (nativeMicros); }
+inline uint32_t millis() { return (nativeMicros / 1000); }
+inline void delay(uint32_t ms) { nativeMicros += ms * 1000; }
+inline void delayMicroseconds(uint32_t us) { nativeMicros += us; }
+inline void yield() {}
+
+//Pin levels a test can set, for ready and interrupt lines
+inline uint8_t nativePins[64] = {};
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t level) { nativePins[pin % 64] = level; }
+inline int digitalRead(uint8_t pin) { return (nativePins[pin % 64]); }
+
+class String {
+public:
+  String(const char* text = "") : _text(text) {}
+  const char* c_str() const { return (_text); }
+  size_t length() const { return (strlen(_text)); }
+  char operator[](size_t index) const { return (_text[index]); }
+
+private:
+  const char* _text;
+};
+
+//Status reports go to stdout
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) { return (putchar(c) == EOF ? 0 : 1); }
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t x = 0; x < size; x++)
+      write(buffer[x]);
+    return (size);
+  }
+
+  size_t printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0)
+      return (0);
+    return (write((const uint8_t*)text, min((size_t)length, sizeof(text) - 1)));
+  }
+
+  size_t print(const char* text) { return (write((const uint8_t*)text, strlen(text))); }
+  size_t print(const String& text) { return (print(text.c_str())); }
+  size_t print(char c) { return (write((uint8_t)c)); }
+  size_t print(long long value, int base = DEC) { return (base == HEX ? printf("%llX", value) : printf("%lld", value)); }
+  size_t print(unsigned long long value, int base = DEC) { return (base == HEX ? printf("%llX", value) : printf("%llu", value)); }
+  size_t print(int value, int base = DEC) { return (print((long long)value, base)); }
+  size_t print(long value, int base = DEC) { return (print((long long)value, base)); }
+  size_t print(unsigned char value, int base = DEC) { return (print((unsigned long long)value, base)); }
+  size_t print(unsigned int value, int base = DEC) { return (print((unsigned long long)value, base)); }
+  size_t print(unsigned long value, int base = DEC) { return (print((unsigned long long)value, base)); }
+  size_t print(double value, int digits = 2) { return (printf("%.*f", digits, value)); }
+
+  size_t println() { return (print("\r\n")); }
+  template <class T> size_t println(T value) { return (print(value) + println()); }
+  template <class T> size_t println(T value, int format) { return (print(value, format) + println()); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return (0); }
+  virtual int read() { return (-1); }
+  virtual int peek() { return (-1); }
+  virtual void flush() {}
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(uint32_t) {}
+  operator bool() { return (true); }
+};
+
+inline HardwareSerial Serial;
+
+#endif
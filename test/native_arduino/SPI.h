@@ -0,0 +1,28 @@
+//SPI for the native unit tests: nothing is attached, every byte reads back idle
+
+#ifndef _NATIVE_SPI_H_
+#define _NATIVE_SPI_H_
+
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings {
+public:
+  SPISettings() {}
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+public:
+  void begin() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t) { return (0xFF); }
+  void transfer(void* buffer, size_t size) { memset(buffer, 0xFF, size); }
+};
+
+inline SPIClass SPI;
+
+#endif
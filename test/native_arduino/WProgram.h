@@ -0,0 +1,3 @@
+//The SparkFun library includes WProgram.h, the pre-1.0 name of Arduino.h, when ARDUINO is not defined, as on the host
+
+#include <Arduino.h>
@@ -0,0 +1,90 @@
+//A scripted u-blox receiver on the I2C bus, for the native unit tests. A test queues the bytes the receiver has
+//ready to send; the bus answers register 0xFD with how many are queued and reads from 0xFF with the bytes, 0xFF
+//once they run out. Each transfer moves the virtual clock on by its time on the wire, so a test can see how long a
+//check of the port keeps its caller waiting
+
+#ifndef _NATIVE_WIRE_H_
+#define _NATIVE_WIRE_H_
+
+#include <Arduino.h>
+#include <vector>
+
+class TwoWire : public Stream {
+public:
+  std::vector<uint8_t> ready; //Bytes the receiver has queued, sent from readyTail on
+  size_t readyTail = 0;
+  std::vector<uint8_t> received; //Bytes written to the receiver, outside register addressing
+  uint32_t transactions = 0;
+  uint32_t busBytes = 0; //Bytes clocked in both directions, address bytes included
+
+  void begin() {}
+  void setClock(uint32_t clock) { _clock = clock; }
+
+  void queue(const uint8_t* data, size_t length) { ready.insert(ready.end(), data, data + length); }
+  size_t queued() { return (ready.size() - readyTail); }
+
+  void beginTransmission(uint8_t) {
+    _writing = 0;
+    _clockOut(1);
+  }
+
+  size_t write(uint8_t c) {
+    if (_writing++ == 0 && (c == 0xFD || c == 0xFF))
+      _register = c;
+    else
+      received.push_back(c);
+    _clockOut(1);
+    return (1);
+  }
+
+  size_t write(const uint8_t* buffer, size_t size) {
+    for (size_t x = 0; x < size; x++)
+      write(buffer[x]);
+    return (size);
+  }
+
+  uint8_t endTransmission(bool = true) {
+    transactions++;
+    return (0);
+  }
+
+  uint8_t requestFrom(uint8_t, uint8_t length, bool = true) {
+    _rx.clear();
+    _rxPos = 0;
+    if (_register == 0xFD) {//Bytes available, then the stream register
+      size_t count = min(queued(), (size_t)0x7FFF);
+      _rx.push_back(count >> 8);
+      _rx.push_back(count & 0xFF);
+      _register = 0xFF;
+    }
+    while (_rx.size() < length)
+      _rx.push_back(readyTail < ready.size() ? ready[readyTail++] : 0xFF);
+    transactions++;
+    _clockOut(1 + length);
+    return (length);
+  }
+
+  uint8_t requestFrom(uint8_t address, size_t length, bool stop = true) { return (requestFrom(address, (uint8_t)length, stop)); }
+  uint8_t requestFrom(uint8_t address, int length, bool stop = true) { return (requestFrom(address, (uint8_t)length, stop)); }
+
+  int available() { return (_rx.size() - _rxPos); }
+  int read() { return (_rxPos < _rx.size() ? _rx[_rxPos++] : -1); }
+  int peek() { return (_rxPos < _rx.size() ? _rx[_rxPos] : -1); }
+
+private:
+  uint32_t _clock = 100000;
+  uint8_t _register = 0xFF;
+  size_t _writing = 0;
+  std::vector<uint8_t> _rx;
+  size_t _rxPos = 0;
+
+  //Nine clocks a byte, acknowledge included
+  void _clockOut(size_t bytes) {
+    busBytes += bytes;
+    nativeMicros += bytes * 9 * 1000000ULL / _clock;
+  }
+};
+
+inline TwoWire Wire;
+
+#endif
@@ -0,0 +1,70 @@
+//The word-at-a-time Fletcher-8 and slice-by-4 CRC-24Q against the textbook byte and bit at a time versions,
+//for every length up to a maximum size UBX payload, and carried on from a previous result at every split point
+
+#include <unity.h>
+#include <checksum.h>
+#include <reference_checksums.h>
+
+static const size_t MAX_LENGTH = 600;
+static uint8_t data[MAX_LENGTH];
+
+void setUp() {
+  uint32_t seed = 12345;
+  for (size_t x = 0; x < MAX_LENGTH; x++) {
+    seed = seed * 1103515245 + 12345;
+    data[x] = seed >> 16;
+  }
+}
+
+void tearDown() {}
+
+void test_fletcher8_lengths() {
+  for (size_t length = 0; length < MAX_LENGTH; length++) {
+    uint8_t expectedA = 0, expectedB = 0;
+    referenceFletcher8(data, length, expectedA, expectedB);
+    uint8_t checksumA = 0, checksumB = 0;
+    fletcher8(data, length, checksumA, checksumB);
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(expectedA, checksumA, "checksumA");
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(expectedB, checksumB, "checksumB");
+  }
+}
+
+void test_fletcher8_carries_on() {
+  uint8_t expectedA = 0, expectedB = 0;
+  referenceFletcher8(data, MAX_LENGTH, expectedA, expectedB);
+  for (size_t split = 0; split <= MAX_LENGTH; split++) {
+    uint8_t checksumA = 0, checksumB = 0;
+    fletcher8(data, split, checksumA, checksumB);
+    fletcher8(&data[split], MAX_LENGTH - split, checksumA, checksumB);
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(expectedA, checksumA, "checksumA");
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(expectedB, checksumB, "checksumB");
+  }
+}
+
+void test_crc24q_check_value() {
+  const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  TEST_ASSERT_EQUAL_HEX32(0xCDE703, crc24q(check, sizeof(check)));
+}
+
+void test_crc24q_lengths() {
+  for (size_t length = 0; length < MAX_LENGTH; length++)
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(referenceCRC24Q(data, length), crc24q(data, length), "crc24q");
+}
+
+void test_crc24q_carries_on() {
+  uint32_t expected = referenceCRC24Q(data, MAX_LENGTH);
+  for (size_t split = 0; split <= MAX_LENGTH; split++) {
+    uint32_t crc = crc24q(data, split);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(expected, crc24q(&data[split], MAX_LENGTH - split, crc), "crc24q");
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fletcher8_lengths);
+  RUN_TEST(test_fletcher8_carries_on);
+  RUN_TEST(test_crc24q_check_value);
+  RUN_TEST(test_crc24q_lengths);
+  RUN_TEST(test_crc24q_carries_on);
+  return (UNITY_END());
+}
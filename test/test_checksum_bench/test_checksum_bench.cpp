@@ -0,0 +1,81 @@
+//Cycles per byte of the lib/checksum kernels against the byte at a time Fletcher-8 the UBX parser used to run and
+//the bit at a time CRC-24Q, over RAWX-sized messages. Every kernel has to agree with its reference on the way
+
+#include <unity.h>
+#include <checksum.h>
+#include <reference_checksums.h>
+#include <bench.h>
+
+static const size_t MESSAGE_SIZE = 16 + 32 * 40; //UBX-RXM-RAWX payload, 40 signals
+static const uint32_t FAST_PASSES = 20000;
+static const uint32_t BITWISE_PASSES = 1000; //The bit at a time CRC is slow enough to measure in fewer passes
+static uint8_t message[MESSAGE_SIZE];
+
+void setUp() {
+  uint32_t seed = 777;
+  for (size_t x = 0; x < MESSAGE_SIZE; x++) {
+    seed = seed * 1103515245 + 12345;
+    message[x] = seed >> 16;
+  }
+}
+
+void tearDown() {}
+
+void test_fletcher8_speed() {
+  Stopwatch stopwatch;
+  uint8_t referenceA = 0, referenceB = 0;
+  stopwatch.start();
+  for (uint32_t pass = 0; pass < FAST_PASSES; pass++) {
+    message[0] = pass;
+    referenceFletcher8(message, MESSAGE_SIZE, referenceA, referenceB);
+  }
+  stopwatch.stop();
+  stopwatch.report("Fletcher-8, byte at a time", (uint64_t)FAST_PASSES * MESSAGE_SIZE);
+
+  uint8_t checksumA = 0, checksumB = 0;
+  stopwatch.start();
+  for (uint32_t pass = 0; pass < FAST_PASSES; pass++) {
+    message[0] = pass;
+    fletcher8(message, MESSAGE_SIZE, checksumA, checksumB);
+  }
+  stopwatch.stop();
+  stopwatch.report("Fletcher-8, word at a time", (uint64_t)FAST_PASSES * MESSAGE_SIZE);
+
+  TEST_ASSERT_EQUAL_HEX8(referenceA, checksumA);
+  TEST_ASSERT_EQUAL_HEX8(referenceB, checksumB);
+}
+
+void test_crc24q_speed() {
+  Stopwatch stopwatch;
+  uint32_t reference = 0;
+  stopwatch.start();
+  for (uint32_t pass = 0; pass < BITWISE_PASSES; pass++) {
+    message[0] = pass;
+    reference ^= referenceCRC24Q(message, MESSAGE_SIZE);
+  }
+  stopwatch.stop();
+  stopwatch.report("CRC-24Q, bit at a time", (uint64_t)BITWISE_PASSES * MESSAGE_SIZE);
+  double bitwise = stopwatch.seconds() / BITWISE_PASSES;
+
+  uint32_t crc = 0;
+  stopwatch.start();
+  for (uint32_t pass = 0; pass < FAST_PASSES; pass++) {
+    message[0] = pass;
+    uint32_t result = crc24q(message, MESSAGE_SIZE);
+    if (pass < BITWISE_PASSES)
+      crc ^= result;
+  }
+  stopwatch.stop();
+  stopwatch.report("CRC-24Q, slice-by-4", (uint64_t)FAST_PASSES * MESSAGE_SIZE);
+  double sliced = stopwatch.seconds() / FAST_PASSES;
+
+  TEST_ASSERT_EQUAL_HEX32(reference, crc);
+  TEST_ASSERT_LESS_THAN(bitwise, sliced); //Tables against eight shifts a byte: never close
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fletcher8_speed);
+  RUN_TEST(test_crc24q_speed);
+  return (UNITY_END());
+}
@@ -0,0 +1,188 @@
+//The SFE_UBLOX_GNSS file buffer at RAWX-sized messages: logged RAWX goes into the ring and is written out in 4KB
+//blocks, the way GNSSRawLogger drains it, once copied out through extractFileBufferData and once straight from the
+//ring through peekFileBuffer. A byte at a time ring, with a branch per byte, is timed on the same data to compare
+//against. Everything written out has to match what was logged, across every wrap of the ring
+
+#include <unity.h>
+#include <vector>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <bench.h>
+
+static const uint16_t FILE_BUFFER_SIZE = 16384;
+static const uint16_t BLOCK_SIZE = 4096;
+static const uint8_t RAWX_SIGNALS = 80;
+static const uint16_t RAWX_LENGTH = 16 + 32 * RAWX_SIGNALS;
+static const uint8_t MESSAGES = 8;
+static const uint32_t PASSES = 2000;
+
+static uint8_t payloads[MESSAGES][RAWX_LENGTH];
+static ubxPacket rawx[MESSAGES];
+static std::vector<uint8_t> logged; //What went into the file buffer, in order
+static std::vector<uint8_t> written; //What came out of it
+
+static uint8_t block[BLOCK_SIZE];
+static uint8_t flashPage[BLOCK_SIZE];
+
+//Stands in for the flash write: one copy, from wherever the data is
+static void writeFlash(const uint8_t* data, uint16_t length) {
+  memcpy(flashPage, data, length);
+}
+
+void setUp() {
+  uint32_t seed = 4242;
+  for (uint8_t m = 0; m < MESSAGES; m++) {
+    for (uint16_t x = 0; x < RAWX_LENGTH; x++) {
+      seed = seed * 1103515245 + 12345;
+      payloads[m][x] = seed >> 16;
+    }
+    payloads[m][11] = RAWX_SIGNALS;
+
+    ubxPacket& packet = rawx[m];
+    packet = {};
+    packet.cls = UBX_CLASS_RXM;
+    packet.id = UBX_RXM_RAWX;
+    packet.len = RAWX_LENGTH;
+    packet.payload = payloads[m];
+    uint8_t header[4] = { packet.cls, packet.id, (uint8_t)(RAWX_LENGTH & 0xFF), (uint8_t)(RAWX_LENGTH >> 8) };
+    fletcher8(header, sizeof(header), packet.checksumA, packet.checksumB);
+    fletcher8(payloads[m], RAWX_LENGTH, packet.checksumA, packet.checksumB);
+    packet.valid = SFE_UBLOX_PACKET_VALIDITY_VALID;
+  }
+  logged.clear();
+  written.clear();
+  nativeMicros = 0;
+}
+
+void tearDown() {}
+
+static void appendFrame(const ubxPacket& packet) {
+  uint8_t header[6] = { UBX_SYNCH_1, UBX_SYNCH_2, packet.cls, packet.id, (uint8_t)(packet.len & 0xFF), (uint8_t)(packet.len >> 8) };
+  logged.insert(logged.end(), header, header + sizeof(header));
+  logged.insert(logged.end(), packet.payload, packet.payload + packet.len);
+  logged.push_back(packet.checksumA);
+  logged.push_back(packet.checksumB);
+}
+
+static void start(SFE_UBLOX_GNSS& gnss) {
+  gnss.setFileBufferSize(FILE_BUFFER_SIZE);
+  gnss.begin(Wire, 0x42, 10);
+  gnss.setAutoRXMRAWX(true, false, 10); //Nothing answers, but the RAWX storage is set up
+  gnss.logRXMRAWX(true);
+}
+
+//Log RAWX and write it out a block at a time, by copying out or from the ring
+static void run(SFE_UBLOX_GNSS& gnss, bool peek, Stopwatch& store, Stopwatch& drain) {
+  for (uint32_t pass = 0; pass < PASSES; pass++) {
+    const ubxPacket& packet = rawx[pass % MESSAGES];
+    store.resume();
+    gnss.processUBXpacket((ubxPacket*)&packet);
+    store.stop();
+    appendFrame(packet);
+
+    while (gnss.fileBufferAvailable() >= BLOCK_SIZE) {
+      drain.resume();
+      if (peek) {
+        const uint8_t* first;
+        const uint8_t* second;
+        uint16_t firstLength, secondLength;
+        gnss.peekFileBuffer(&first, &firstLength, &second, &secondLength);
+        if (firstLength >= BLOCK_SIZE) {
+          writeFlash(first, BLOCK_SIZE);
+        }
+        else {//The block wraps, so it has to be put together
+          memcpy(block, first, firstLength);
+          memcpy(&block[firstLength], second, BLOCK_SIZE - firstLength);
+          writeFlash(block, BLOCK_SIZE);
+        }
+        gnss.discardFileBufferData(BLOCK_SIZE);
+      }
+      else {
+        gnss.extractFileBufferData(block, BLOCK_SIZE);
+        writeFlash(block, BLOCK_SIZE);
+      }
+      drain.stop();
+      written.insert(written.end(), flashPage, flashPage + BLOCK_SIZE);
+    }
+  }
+  TEST_ASSERT_EQUAL(0, gnss.getFileBufferDropped());
+  TEST_ASSERT_EQUAL_MEMORY(logged.data(), written.data(), written.size());
+}
+
+//The byte at a time ring, wrapping with a branch on every byte
+struct ByteRing {
+  uint8_t data[FILE_BUFFER_SIZE];
+  uint16_t head = 0;
+  uint16_t tail = 0;
+
+  uint16_t used() { return (head >= tail ? head - tail : FILE_BUFFER_SIZE - tail + head); }
+  void write(const uint8_t* bytes, uint16_t length) {
+    for (uint16_t x = 0; x < length; x++) {
+      data[head++] = bytes[x];
+      if (head == FILE_BUFFER_SIZE)
+        head = 0;
+    }
+  }
+  void read(uint8_t* bytes, uint16_t length) {
+    for (uint16_t x = 0; x < length; x++) {
+      bytes[x] = data[tail++];
+      if (tail == FILE_BUFFER_SIZE)
+        tail = 0;
+    }
+  }
+};
+
+void test_file_buffer_speed() {
+  uint64_t bytes = (uint64_t)PASSES * (RAWX_LENGTH + 8);
+
+  //RAWX handling alone, to set the store times against
+  static SFE_UBLOX_GNSS parseOnly;
+  start(parseOnly);
+  parseOnly.logRXMRAWX(false);
+  Stopwatch parse;
+  for (uint32_t pass = 0; pass < PASSES; pass++) {
+    parse.resume();
+    parseOnly.processUBXpacket(&rawx[pass % MESSAGES]);
+    parse.stop();
+  }
+  parse.report("RAWX handled, not logged", bytes);
+
+  static SFE_UBLOX_GNSS copying;
+  start(copying);
+  Stopwatch store, extract;
+  run(copying, false, store, extract);
+  store.report("RAWX handled and logged", bytes);
+  extract.report("Drain, extract then write", written.size());
+
+  setUp();
+  static SFE_UBLOX_GNSS zeroCopy;
+  start(zeroCopy);
+  Stopwatch peekStore, peek;
+  run(zeroCopy, true, peekStore, peek);
+  peek.report("Drain, write from the ring", written.size());
+
+  //The same frames and blocks through the byte at a time ring
+  static ByteRing ring;
+  Stopwatch byteStore, byteDrain;
+  for (uint32_t pass = 0; pass < PASSES; pass++) {
+    const uint8_t* frame = &logged[(size_t)pass * (RAWX_LENGTH + 8)];
+    byteStore.resume();
+    ring.write(frame, RAWX_LENGTH + 8);
+    byteStore.stop();
+    while (ring.used() >= BLOCK_SIZE) {
+      byteDrain.resume();
+      ring.read(block, BLOCK_SIZE);
+      writeFlash(block, BLOCK_SIZE);
+      byteDrain.stop();
+    }
+  }
+  byteStore.report("Byte at a time ring, store", bytes);
+  byteDrain.report("Byte at a time ring, drain", written.size());
+
+  TEST_ASSERT_LESS_THAN(byteDrain.seconds(), peek.seconds());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_file_buffer_speed);
+  return (UNITY_END());
+}
@@ -0,0 +1,195 @@
+//The RTCMDeltaEncoder and RTCMDeltaDecoder end to end on MSM4, MSM5 and MSM7 from the RTCMEncoder. Every frame the
+//decoder gives back must be the frame the encoder was given, byte for byte: over a clean link, over one that loses
+//5% of its frames, and when a keyframe arrives damaged
+
+#include <unity.h>
+#include <rtcm_delta.h>
+#include <rtcm_fixture.h>
+
+static const uint8_t SATELLITES = 8;                      //Per constellation
+static const uint16_t EPOCHS = 200;
+
+//Every frame of the run goes into frames, in order, with a 1005 ahead of each epoch to pass through.
+//Satellites on smooth paths, with a little noise, one rising part way through and one setting
+static void makeFrames(uint8_t type) {
+  static RTCMEncoder encoder;
+  encoder = RTCMEncoder();
+  encoder.msm(type);
+  encoder.stationId(1234);
+  frames.clear();
+  messageNumbers.clear();
+
+  struct Satellite {
+    uint8_t svId;
+    uint8_t freqId;
+    double range_m;
+    double rate_mps;
+    double acceleration;
+    double ambiguity[2];
+  } satellites[4][SATELLITES];
+  for (uint8_t g = 0; g < 4; g++)
+    for (uint8_t s = 0; s < SATELLITES; s++) {
+      Satellite& satellite = satellites[g][s];
+      satellite.svId = 2 + s * 4;
+      satellite.freqId = s % 14;
+      satellite.range_m = 20e6 + uniform() * (GNSS[g] == RTCM_BEIDOU ? 18e6 : 6e6);
+      satellite.rate_mps = (uniform() - 0.5) * 1600;
+      satellite.acceleration = (uniform() - 0.5) * 0.4;
+      satellite.ambiguity[0] = floor(uniform() * 2e7) - 1e7;
+      satellite.ambiguity[1] = floor(uniform() * 2e7) - 1e7;
+    }
+
+  static RTCMObservation observations[4 * SATELLITES * 2];
+  for (uint16_t epoch = 0; epoch < EPOCHS; epoch++) {
+    uint8_t station[RTCM_MAX_FRAME];
+    uint16_t length = encoder.encodeStation(-2694685.4567, -4293642.1234, 3857878.9876, true, true, true, station);
+    frames.push_back(std::vector<uint8_t>(station, station + length));
+
+    uint8_t count = 0;
+    for (uint8_t g = 0; g < 4; g++)
+      for (uint8_t s = 0; s < SATELLITES; s++) {
+        if ((s == 0 && epoch < EPOCHS / 3) || (s == 1 && epoch >= EPOCHS / 2))
+          continue;
+        const Satellite& satellite = satellites[g][s];
+        double range = satellite.range_m + satellite.rate_mps * epoch + 0.5 * satellite.acceleration * epoch * epoch;
+        for (uint8_t band = 0; band < 2; band++) {
+          RTCMObservation& observation = observations[count++];
+          double lambda = wavelength(GNSS[g], band, satellite.freqId);
+          double iono = (band ? 1.6 : 1.0) * (3.0 + 0.001 * epoch);
+          observation = {};
+          observation.pseudorange_m = range + iono + (uniform() - 0.5) * 0.6;
+          observation.phase_cycles = (range - iono) / lambda + satellite.ambiguity[band] + (uniform() - 0.5) * 0.01;
+          observation.doppler_Hz = -(satellite.rate_mps + satellite.acceleration * epoch) / lambda + (uniform() - 0.5) * 0.1;
+          observation.gnssId = GNSS[g];
+          observation.svId = satellite.svId;
+          observation.sigId = band ? BAND_2_SIGID[g] : 0;
+          observation.freqId = satellite.freqId;
+          observation.lockTime_ms = min(64500, epoch * 1000 + 500);
+          observation.cno = 38 + s + (uniform() < 0.2);
+          observation.pseudorangeValid = true;
+          observation.phaseValid = true;
+          observation.halfCycleResolved = true;
+        }
+      }
+    encoder.encodeEpoch(observations, count, TOW_S + epoch, 18, true, collect);
+  }
+}
+
+struct Run {
+  uint32_t sent;
+  uint32_t lost;
+  uint32_t delivered;
+  uint32_t dropped;
+  uint32_t mismatched;
+  RTCMDeltaStats encoded;
+  RTCMDeltaStats decoded;
+};
+
+static RTCMDeltaEncoder encoder;
+static RTCMDeltaDecoder decoder;
+
+//Each frame through the encoder, the link and the decoder. lossPercent of frames are lost; damage is the index of
+//a frame to arrive with one payload byte changed
+static Run run(uint8_t lossPercent, int32_t damage = -1) {
+  encoder = RTCMDeltaEncoder();
+  decoder = RTCMDeltaDecoder();
+  Run result = {};
+  for (uint32_t x = 0; x < frames.size(); x++) {
+    const std::vector<uint8_t>& frame = frames[x];
+    const uint8_t* out;
+    uint16_t length = encoder.encode(frame.data(), frame.size(), out);
+    std::vector<uint8_t> sent(out, out + length);
+    result.sent++;
+    if (uniform() * 100 < lossPercent) {
+      result.lost++;
+      continue;
+    }
+    if ((int32_t)x == damage)
+      sent[sent.size() / 2] ^= 0x10;
+
+    const uint8_t* standard;
+    uint16_t standardLength = decoder.decode(sent.data(), sent.size(), standard);
+    if (standardLength == 0) {
+      result.dropped++;
+      continue;
+    }
+    if ((int32_t)x == damage)
+      continue;
+    result.delivered++;
+    if (standardLength != frame.size() || memcmp(standard, frame.data(), standardLength) != 0)
+      result.mismatched++;
+  }
+  result.encoded = encoder.stats();
+  result.decoded = decoder.stats();
+  return (result);
+}
+
+void setUp() {
+  seed = 4321;
+}
+
+void tearDown() {}
+
+static void checkRoundTrip(uint8_t type) {
+  makeFrames(type);
+  Run result = run(0);
+  TEST_ASSERT_EQUAL(frames.size(), result.delivered);
+  TEST_ASSERT_EQUAL(0, result.mismatched);
+  TEST_ASSERT_EQUAL(0, result.dropped);
+  TEST_ASSERT_GREATER_THAN(result.encoded.keyframes, result.encoded.deltas);
+  TEST_ASSERT_EQUAL(result.encoded.keyframes, result.decoded.keyframes);
+  TEST_ASSERT_EQUAL(result.encoded.deltas, result.decoded.deltas);
+  TEST_ASSERT_LESS_THAN(result.encoded.bytesIn, result.encoded.bytesOut);
+  TEST_ASSERT_EQUAL(result.encoded.bytesIn, result.decoded.bytesOut);
+}
+
+void test_round_trip_msm4() {
+  checkRoundTrip(4);
+}
+
+void test_round_trip_msm5() {
+  checkRoundTrip(5);
+}
+
+void test_round_trip_msm7() {
+  checkRoundTrip(7);
+}
+
+//Deltas after a lost frame are dropped until the next keyframe. Nothing wrong is ever delivered
+void test_loss() {
+  for (uint8_t type : { 4, 5, 7 }) {
+    makeFrames(type);
+    Run result = run(5);
+    TEST_ASSERT_GREATER_THAN(0, result.lost);
+    TEST_ASSERT_GREATER_THAN(0, result.dropped);
+    TEST_ASSERT_EQUAL(result.dropped, result.decoded.dropped);
+    TEST_ASSERT_EQUAL(0, result.mismatched);
+    TEST_ASSERT_EQUAL(result.sent - result.lost, result.delivered + result.dropped);
+    //Most of what arrives still builds: a loss costs at most the rest of its constellation's keyframe interval
+    TEST_ASSERT_GREATER_THAN(result.sent * 3 / 4, result.delivered);
+  }
+}
+
+//A keyframe damaged on the link goes on as it is, but the deltas built on it are dropped, not rebuilt wrongly
+void test_damaged_keyframe() {
+  makeFrames(7);
+  Run clean = run(0);
+  TEST_ASSERT_EQUAL(0, clean.mismatched);
+
+  //The second GPS keyframe: each epoch is a 1005 then four MSMs, GPS first
+  uint32_t keyframe = RTCM_DELTA_KEYFRAME_INTERVAL * (1 + 4) + 1;
+  Run result = run(0, keyframe);
+  TEST_ASSERT_EQUAL(0, result.mismatched);
+  TEST_ASSERT_EQUAL(RTCM_DELTA_KEYFRAME_INTERVAL - 1, result.dropped);
+  TEST_ASSERT_EQUAL(clean.delivered - RTCM_DELTA_KEYFRAME_INTERVAL, result.delivered);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_msm4);
+  RUN_TEST(test_round_trip_msm5);
+  RUN_TEST(test_round_trip_msm7);
+  RUN_TEST(test_loss);
+  RUN_TEST(test_damaged_keyframe);
+  return (UNITY_END());
+}
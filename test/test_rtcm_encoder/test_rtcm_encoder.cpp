@@ -0,0 +1,350 @@
+//The MSM4, MSM5 and MSM7 encoder against a separate reference decoder written straight from RTCM 10403.3
+//section 3.5.12, a bit at a time. Every frame must check, every cell must decode back to its observation within
+//the field's resolution, parseMSM and packMSM must rebuild each frame bit for bit, and each band must go out as
+//one signal however many components of it the receiver reports
+
+#include <unity.h>
+#include <rtcm_fixture.h>
+#include <reference_checksums.h>
+
+static const double RANGE_MS = SPEED_OF_LIGHT * 0.001;
+static const uint8_t SATELLITES = 10;                     //Per constellation
+static const uint8_t EPOCHS = 20;
+static const uint16_t MESSAGE_BASE[] = { 1070, 1080, 1090, 1120 };
+
+//A bit at a time, so it shares nothing with RTCMBitReader
+struct ReferenceBits {
+  const uint8_t* bytes;
+  uint32_t position;
+
+  uint64_t u(uint8_t bits) {
+    uint64_t value = 0;
+    for (uint8_t x = 0; x < bits; x++, position++)
+      value = (value << 1) | ((bytes[position / 8] >> (7 - position % 8)) & 1);
+    return (value);
+  }
+
+  int64_t s(uint8_t bits) {
+    uint64_t value = u(bits);
+    return ((value >> (bits - 1)) ? (int64_t)value - ((int64_t)1 << bits) : (int64_t)value);
+  }
+};
+
+struct DecodedCell {
+  uint8_t svId;
+  uint8_t signal;
+  double pseudorange_m;      //NAN if invalid
+  double phase_m;            //NAN if invalid
+  double rate_mps;           //NAN if invalid or not sent
+  uint16_t lock;
+  double cnr;
+  uint8_t extended;
+};
+
+struct DecodedMSM {
+  uint16_t messageNumber;
+  uint16_t stationId;
+  uint32_t epoch;
+  bool more;
+  uint32_t signalMask;
+  std::vector<DecodedCell> cells;
+};
+
+static bool referenceDecode(const uint8_t* frame, uint16_t length, DecodedMSM& msm) {
+  uint16_t payloadLength = ((frame[1] & 0x03) << 8) | frame[2];
+  ReferenceBits bits = { frame + 3, 0 };
+  msm.messageNumber = bits.u(12);
+  msm.stationId = bits.u(12);
+  msm.epoch = bits.u(30);
+  msm.more = bits.u(1);
+  bits.u(3 + 7 + 2 + 2 + 1 + 3);  //IODS, reserved, clock steering, external clock, smoothing
+  uint64_t satelliteMask = bits.u(64);
+  msm.signalMask = bits.u(32);
+
+  std::vector<uint8_t> satellites, signals;
+  for (uint8_t x = 1; x <= 64; x++)
+    if ((satelliteMask >> (64 - x)) & 1)
+      satellites.push_back(x);
+  for (uint8_t x = 1; x <= 32; x++)
+    if ((msm.signalMask >> (32 - x)) & 1)
+      signals.push_back(x);
+  size_t cellBits = satellites.size() * signals.size();
+  if (cellBits == 0 || cellBits > 64)
+    return (false);
+  uint64_t cellMask = bits.u(cellBits);
+
+  uint8_t type = msm.messageNumber % 10;
+  bool extended = type != 4;
+  size_t satelliteCount = satellites.size();
+  std::vector<uint32_t> roughMs(satelliteCount), roughFine(satelliteCount), ext(satelliteCount, 0);
+  std::vector<int64_t> roughRate(satelliteCount, 0);
+  for (size_t s = 0; s < satelliteCount; s++)
+    roughMs[s] = bits.u(8);
+  if (extended)
+    for (size_t s = 0; s < satelliteCount; s++)
+      ext[s] = bits.u(4);
+  for (size_t s = 0; s < satelliteCount; s++)
+    roughFine[s] = bits.u(10);
+  if (extended)
+    for (size_t s = 0; s < satelliteCount; s++)
+      roughRate[s] = bits.s(14);
+
+  std::vector<size_t> cellSatellite, cellSignal;
+  for (size_t c = 0; c < cellBits; c++)
+    if ((cellMask >> (cellBits - 1 - c)) & 1) {
+      cellSatellite.push_back(c / signals.size());
+      cellSignal.push_back(c % signals.size());
+    }
+  size_t cells = cellSatellite.size();
+
+  bool high = type == 7;
+  uint8_t prBits = high ? 20 : 15, phaseBits = high ? 24 : 22, lockBits = high ? 10 : 4, cnrBits = high ? 10 : 6;
+  double prResolution = pow(2, high ? -29 : -24), phaseResolution = pow(2, high ? -31 : -29);
+  std::vector<int64_t> pr(cells), phase(cells), rate(cells, 0);
+  std::vector<uint64_t> lock(cells), cnr(cells);
+  for (size_t c = 0; c < cells; c++)
+    pr[c] = bits.s(prBits);
+  for (size_t c = 0; c < cells; c++)
+    phase[c] = bits.s(phaseBits);
+  for (size_t c = 0; c < cells; c++)
+    lock[c] = bits.u(lockBits);
+  for (size_t c = 0; c < cells; c++)
+    bits.u(1);
+  for (size_t c = 0; c < cells; c++)
+    cnr[c] = bits.u(cnrBits);
+  if (extended)
+    for (size_t c = 0; c < cells; c++)
+      rate[c] = bits.s(15);
+  if ((bits.position + 7) / 8 != payloadLength)
+    return (false);
+
+  msm.cells.clear();
+  for (size_t c = 0; c < cells; c++) {
+    size_t s = cellSatellite[c];
+    double rough_ms = roughMs[s] + roughFine[s] / 1024.0;
+    DecodedCell cell;
+    cell.svId = satellites[s];
+    cell.signal = signals[cellSignal[c]];
+    cell.pseudorange_m = pr[c] == -((int64_t)1 << (prBits - 1)) ? NAN : (rough_ms + pr[c] * prResolution) * RANGE_MS;
+    cell.phase_m = phase[c] == -((int64_t)1 << (phaseBits - 1)) ? NAN : (rough_ms + phase[c] * phaseResolution) * RANGE_MS;
+    cell.rate_mps = (extended && rate[c] != -16384) ? roughRate[s] + rate[c] * 0.0001 : NAN;
+    cell.lock = lock[c];
+    cell.cnr = high ? cnr[c] / 16.0 : cnr[c];
+    cell.extended = ext[s];
+    msm.cells.push_back(cell);
+  }
+  (void)length;
+  return (true);
+}
+
+struct Satellite {
+  uint8_t svId;
+  uint8_t freqId;
+  double range_m;
+  double rate_mps;
+  double ambiguity[2];
+};
+
+static Satellite satellites[4][SATELLITES];
+static RTCMEncoder encoder;
+static RTCMObservation observations[4 * SATELLITES * 2];
+
+//Both bands of every satellite, ranges moving on by their rate each epoch
+static uint8_t makeEpoch(uint8_t epoch) {
+  uint8_t count = 0;
+  for (uint8_t g = 0; g < 4; g++)
+    for (uint8_t s = 0; s < SATELLITES; s++) {
+      const Satellite& satellite = satellites[g][s];
+      for (uint8_t band = 0; band < 2; band++) {
+        RTCMObservation& observation = observations[count++];
+        double lambda = wavelength(GNSS[g], band, satellite.freqId);
+        double range = satellite.range_m + satellite.rate_mps * epoch;
+        double iono = band ? 4.8 : 3.0;
+        observation = {};
+        observation.pseudorange_m = range + iono + (uniform() - 0.5) * 0.6;
+        observation.phase_cycles = (range - iono) / lambda + satellite.ambiguity[band];
+        observation.doppler_Hz = -satellite.rate_mps / lambda;
+        observation.gnssId = GNSS[g];
+        observation.svId = satellite.svId;
+        observation.sigId = band ? BAND_2_SIGID[g] : 0;
+        observation.freqId = satellite.freqId;
+        observation.lockTime_ms = epoch * 1000 + 500;
+        observation.cno = 30 + s;
+        observation.pseudorangeValid = true;
+        observation.phaseValid = true;
+        observation.halfCycleResolved = true;
+      }
+    }
+  return (count);
+}
+
+static const RTCMObservation* findObservation(uint8_t gnssId, uint8_t svId, bool band2, uint8_t count) {
+  for (uint8_t x = 0; x < count; x++)
+    if (observations[x].gnssId == gnssId && observations[x].svId == svId && (observations[x].sigId != 0) == band2)
+      return (&observations[x]);
+  return (nullptr);
+}
+
+void setUp() {
+  seed = 2024;
+  for (uint8_t g = 0; g < 4; g++)
+    for (uint8_t s = 0; s < SATELLITES; s++) {
+      Satellite& satellite = satellites[g][s];
+      satellite.svId = 1 + s * 3;
+      satellite.freqId = s % 14;
+      satellite.range_m = 20e6 + uniform() * (GNSS[g] == RTCM_BEIDOU ? 18e6 : 6e6);
+      satellite.rate_mps = (uniform() - 0.5) * 1600;
+      satellite.ambiguity[0] = floor(uniform() * 2e7) - 1e7;
+      satellite.ambiguity[1] = floor(uniform() * 2e7) - 1e7;
+    }
+  encoder = RTCMEncoder();
+  encoder.stationId(1234);
+  frames.clear();
+  messageNumbers.clear();
+}
+
+void tearDown() {}
+
+static void checkMSM(uint8_t type) {
+  encoder.msm(type);
+  double prResolution_m = pow(2, type == 7 ? -29 : -24) * RANGE_MS;
+  double phaseResolution_m = pow(2, type == 7 ? -31 : -29) * RANGE_MS;
+
+  for (uint8_t epoch = 0; epoch < EPOCHS; epoch++) {
+    uint8_t count = makeEpoch(epoch);
+    frames.clear();
+    messageNumbers.clear();
+    TEST_ASSERT_EQUAL(4, encoder.encodeEpoch(observations, count, TOW_S + epoch, 18, true, collect));
+
+    for (uint8_t f = 0; f < frames.size(); f++) {
+      const std::vector<uint8_t>& frame = frames[f];
+      uint16_t length = frame.size();
+      TEST_ASSERT_EQUAL_HEX8(0xD3, frame[0]);
+      TEST_ASSERT_EQUAL(length - 6, ((frame[1] & 0x03) << 8) | frame[2]);
+      uint32_t crc = ((uint32_t)frame[length - 3] << 16) | (frame[length - 2] << 8) | frame[length - 1];
+      TEST_ASSERT_EQUAL_HEX32(referenceCRC24Q(frame.data(), length - 3), crc);
+
+      DecodedMSM msm;
+      TEST_ASSERT_TRUE(referenceDecode(frame.data(), length, msm));
+      TEST_ASSERT_EQUAL(MESSAGE_BASE[f] + type, msm.messageNumber);
+      TEST_ASSERT_EQUAL(messageNumbers[f], msm.messageNumber);
+      TEST_ASSERT_EQUAL(1234, msm.stationId);
+      TEST_ASSERT_EQUAL(f != frames.size() - 1, msm.more);
+      if (GNSS[f] == RTCM_GPS || GNSS[f] == RTCM_GALILEO)
+        TEST_ASSERT_EQUAL((uint32_t)((TOW_S + epoch) * 1000), msm.epoch);
+      TEST_ASSERT_EQUAL(2, __builtin_popcount(msm.signalMask));
+      TEST_ASSERT_EQUAL(SATELLITES * 2, msm.cells.size());
+
+      for (const DecodedCell& cell : msm.cells) {
+        bool band2 = cell.signal != 2;
+        const RTCMObservation* observation = findObservation(GNSS[f], cell.svId, band2, count);
+        TEST_ASSERT_NOT_NULL(observation);
+        double lambda = wavelength(GNSS[f], band2, observation->freqId);
+        TEST_ASSERT_DOUBLE_WITHIN(prResolution_m, observation->pseudorange_m, cell.pseudorange_m);
+        //Phase comes back less a whole number of cycles
+        double cycles = (cell.phase_m - observation->phase_cycles * lambda) / lambda;
+        TEST_ASSERT_DOUBLE_WITHIN(phaseResolution_m / lambda, 0.0, cycles - round(cycles));
+        TEST_ASSERT_EQUAL_FLOAT(observation->cno, cell.cnr);
+        if (type != 4) {
+          TEST_ASSERT_DOUBLE_WITHIN(0.0001, -observation->doppler_Hz * lambda, cell.rate_mps);
+          if (GNSS[f] == RTCM_GLONASS)
+            TEST_ASSERT_EQUAL(observation->freqId, cell.extended);
+        }
+      }
+
+      //Taken apart and put back together bit for bit
+      MSMFields fields;
+      uint8_t rebuilt[RTCM_MAX_FRAME];
+      TEST_ASSERT_TRUE(parseMSM(frame.data(), length, fields));
+      TEST_ASSERT_EQUAL(length, packMSM(fields, rebuilt));
+      TEST_ASSERT_EQUAL_MEMORY(frame.data(), rebuilt, length);
+    }
+  }
+}
+
+void test_msm4() {
+  checkMSM(4);
+}
+
+void test_msm5() {
+  checkMSM(5);
+}
+
+void test_msm7() {
+  checkMSM(7);
+}
+
+//Both components of GPS L2, Galileo E1 and Galileo E5b for one satellite. Each band is one signal, and the cell
+//holds the pilot whichever order the receiver reported them in
+void test_one_signal_per_band() {
+  encoder.msm(7);
+  const uint8_t components[][3] = {
+    { RTCM_GPS, 4, 3 },      //L2 CM, then L2 CL
+    { RTCM_GALILEO, 1, 0 },  //E1 B, then E1 C
+    { RTCM_GALILEO, 5, 6 },  //E5b I, then E5b Q
+  };
+  RTCMObservation observations[7] = {};
+  uint8_t count = 0;
+  RTCMObservation& l1 = observations[count++];
+  l1.gnssId = RTCM_GPS;
+  l1.svId = 5;
+  l1.sigId = 0;
+  l1.cno = 40;
+  for (const uint8_t* component : components)
+    for (uint8_t x = 1; x <= 2; x++) {
+      RTCMObservation& observation = observations[count++];
+      observation.gnssId = component[0];
+      observation.svId = 5;
+      observation.sigId = component[x];
+      observation.cno = x == 2 ? 45 : 30; //The pilot is the stronger one
+    }
+  for (RTCMObservation& observation : observations) {
+    observation.pseudorange_m = 22e6;
+    observation.pseudorangeValid = true;
+  }
+  TEST_ASSERT_EQUAL(2, encoder.encodeEpoch(observations, count, TOW_S, 18, true, collect));
+
+  DecodedMSM gps, galileo;
+  TEST_ASSERT_TRUE(referenceDecode(frames[0].data(), frames[0].size(), gps));
+  TEST_ASSERT_TRUE(referenceDecode(frames[1].data(), frames[1].size(), galileo));
+  TEST_ASSERT_EQUAL_HEX32((1u << (32 - 2)) | (1u << (32 - 16)), gps.signalMask);      //1C, 2L
+  TEST_ASSERT_EQUAL_HEX32((1u << (32 - 2)) | (1u << (32 - 15)), galileo.signalMask);  //1C, 7Q
+  TEST_ASSERT_EQUAL(2, gps.cells.size());
+  TEST_ASSERT_EQUAL(2, galileo.cells.size());
+  TEST_ASSERT_EQUAL_FLOAT(40, gps.cells[0].cnr);
+  TEST_ASSERT_EQUAL_FLOAT(45, gps.cells[1].cnr);
+  TEST_ASSERT_EQUAL_FLOAT(45, galileo.cells[0].cnr);
+  TEST_ASSERT_EQUAL_FLOAT(45, galileo.cells[1].cnr);
+}
+
+//1005 ECEF position to 0.1mm
+void test_station() {
+  uint8_t frame[RTCM_MAX_FRAME];
+  uint16_t length = encoder.encodeStation(-2694685.4567, -4293642.1234, 3857878.9876, true, true, true, frame);
+  TEST_ASSERT_EQUAL(25, length);
+  uint32_t crc = ((uint32_t)frame[length - 3] << 16) | (frame[length - 2] << 8) | frame[length - 1];
+  TEST_ASSERT_EQUAL_HEX32(referenceCRC24Q(frame, length - 3), crc);
+
+  ReferenceBits bits = { frame + 3, 0 };
+  TEST_ASSERT_EQUAL(1005, bits.u(12));
+  TEST_ASSERT_EQUAL(1234, bits.u(12));
+  bits.u(6 + 4);
+  double x = bits.s(38) * 0.0001;
+  bits.u(2);
+  double y = bits.s(38) * 0.0001;
+  bits.u(2);
+  double z = bits.s(38) * 0.0001;
+  TEST_ASSERT_DOUBLE_WITHIN(0.00005, -2694685.4567, x);
+  TEST_ASSERT_DOUBLE_WITHIN(0.00005, -4293642.1234, y);
+  TEST_ASSERT_DOUBLE_WITHIN(0.00005, 3857878.9876, z);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_msm4);
+  RUN_TEST(test_msm5);
+  RUN_TEST(test_msm7);
+  RUN_TEST(test_one_signal_per_band);
+  RUN_TEST(test_station);
+  return (UNITY_END());
+}
@@ -0,0 +1,158 @@
+//SFE_UBLOX_GNSS's framing over a mixed capture: each epoch holds RTCM MSM7 and station frames for the frame callback,
+//NAV-PVT kept in automatic storage, RAWX that nothing asked for, NMEA that nothing reads, a UBX message with a bad
+//checksum and idle bytes between them. The capture is replayed in 64 byte spans, the size checkUbloxI2CBuffered
+//hands over, once a byte at a time through process and once through processSpan. Both have to deliver the same
+//frames and messages, and log the same NAV-PVT
+
+#include <unity.h>
+#include <vector>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+#include <bench.h>
+
+static const uint16_t EPOCHS = 500;
+static const uint16_t SPAN = 64;
+
+static uint32_t seed;
+static uint8_t random8() {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16);
+}
+
+static std::vector<uint8_t> capture;
+
+//What each replay delivered
+struct Delivered {
+  std::vector<std::vector<uint8_t>> rtcm;
+  std::vector<uint32_t> ubx;    //Class, ID and length of each UBX message that passed its checksum
+  std::vector<uint8_t> logged; //The file buffer, which NAV-PVT goes to once it has been parsed
+};
+static Delivered* delivered;
+
+static void frameReady(const uint8_t* frame, uint16_t length, uint16_t, uint32_t) {
+  delivered->rtcm.push_back(std::vector<uint8_t>(frame, frame + length));
+}
+
+static void meter(uint8_t cls, uint8_t id, uint16_t length) {
+  if (cls != 0xF5) //RTCM frames are metered too
+    delivered->ubx.push_back((cls << 24) | (id << 16) | length);
+}
+
+static void addUBX(uint8_t cls, uint8_t id, uint16_t length, bool corrupt = false) {
+  std::vector<uint8_t> message = { UBX_SYNCH_1, UBX_SYNCH_2, cls, id, (uint8_t)length, (uint8_t)(length >> 8) };
+  for (uint16_t x = 0; x < length; x++)
+    message.push_back(random8());
+  uint8_t checksumA = 0, checksumB = 0;
+  fletcher8(&message[2], message.size() - 2, checksumA, checksumB);
+  message.push_back(checksumA);
+  message.push_back(corrupt ? checksumB ^ 0x01 : checksumB);
+  capture.insert(capture.end(), message.begin(), message.end());
+}
+
+static void addRTCM(uint16_t messageNumber, uint16_t length) {
+  std::vector<uint8_t> frame = { 0xD3, (uint8_t)(length >> 8), (uint8_t)length, (uint8_t)(messageNumber >> 4), (uint8_t)(messageNumber << 4) };
+  for (uint16_t x = 2; x < length; x++)
+    frame.push_back(random8());
+  uint32_t crc = crc24q(frame.data(), frame.size());
+  frame.push_back(crc >> 16);
+  frame.push_back(crc >> 8);
+  frame.push_back(crc);
+  capture.insert(capture.end(), frame.begin(), frame.end());
+}
+
+static void addNMEA(const char* sentence) {
+  uint8_t checksum = 0;
+  for (const char* c = sentence; *c != 0; c++)
+    checksum ^= *c;
+  char line[128];
+  int length = snprintf(line, sizeof(line), "$%s*%02X\r\n", sentence, checksum);
+  capture.insert(capture.end(), line, line + length);
+}
+
+void setUp() {
+  seed = 1234;
+  nativeMicros = 0;
+  capture.clear();
+  for (uint16_t epoch = 0; epoch < EPOCHS; epoch++) {
+    addRTCM(1005, 19);
+    addUBX(UBX_CLASS_RXM, UBX_RXM_RAWX, 16 + 32 * 40);
+    addRTCM(1077, 319);
+    addUBX(UBX_CLASS_NAV, UBX_NAV_PVT, UBX_NAV_PVT_LEN);
+    addNMEA("GNGGA,092725.00,4717.11399,N,00833.91590,E,1,08,1.01,499.6,M,48.0,M,,");
+    addRTCM(1087, 220);
+    addUBX(UBX_CLASS_NAV, UBX_NAV_CLOCK, UBX_NAV_CLOCK_LEN, epoch % 50 == 0); //An occasional bad checksum
+    for (uint8_t x = 0; x < 16; x++)
+      capture.push_back(0xFF); //Idle
+    addRTCM(1097, 269);
+    addNMEA("GNRMC,092725.00,A,4717.11437,N,00833.91522,E,0.004,77.52,091202,,,A,V");
+    addRTCM(1127, 319);
+    addRTCM(1230, 8);
+  }
+}
+
+void tearDown() {}
+
+static void start(SFE_UBLOX_GNSS& gnss) {
+  gnss.setFileBufferSize(4096);
+  gnss.begin(Wire, 0x42, 10);
+  gnss.setAutoPVT(true, false, 10); //Nothing answers, but the NAV-PVT storage is set up
+  gnss.logNAVPVT(true);
+  gnss.setRTCMFrameCallbackPtr(&frameReady);
+  gnss.setMessageMeterCallbackPtr(&meter);
+  gnss.setProcessNMEAMask(0);
+}
+
+//Replay the capture a span at a time, a byte at a time through process or all at once through processSpan.
+//The file buffer is emptied between spans, outside the timing
+static void replay(SFE_UBLOX_GNSS& gnss, bool spans, Stopwatch& stopwatch) {
+  static uint8_t payload[256];
+  ubxPacket packet = {};
+  packet.payload = payload;
+  for (size_t x = 0; x < capture.size(); x += SPAN) {
+    uint16_t length = min(capture.size() - x, (size_t)SPAN);
+    stopwatch.resume();
+    if (spans)
+      gnss.processSpan(&capture[x], length, &packet, 0, 0);
+    else {
+      for (uint16_t y = 0; y < length; y++)
+        gnss.process(capture[x + y], &packet, 0, 0);
+    }
+    stopwatch.stop();
+
+    uint8_t logged[4096];
+    uint16_t available = gnss.fileBufferAvailable();
+    gnss.extractFileBufferData(logged, available);
+    delivered->logged.insert(delivered->logged.end(), logged, logged + available);
+  }
+}
+
+void test_stream_parser_speed() {
+  Delivered bytewise, spanwise;
+
+  delivered = &bytewise;
+  static SFE_UBLOX_GNSS processed;
+  start(processed);
+  Stopwatch process;
+  replay(processed, false, process);
+  process.report("Mixed stream, process", capture.size());
+
+  delivered = &spanwise;
+  static SFE_UBLOX_GNSS scanned;
+  start(scanned);
+  Stopwatch processSpan;
+  replay(scanned, true, processSpan);
+  processSpan.report("Mixed stream, processSpan", capture.size());
+
+  TEST_ASSERT_EQUAL(EPOCHS * 6, bytewise.rtcm.size());
+  TEST_ASSERT_EQUAL(EPOCHS * 3 - EPOCHS / 50, bytewise.ubx.size());
+  TEST_ASSERT_EQUAL(EPOCHS * (UBX_NAV_PVT_LEN + 8), bytewise.logged.size());
+  TEST_ASSERT_TRUE(bytewise.rtcm == spanwise.rtcm);
+  TEST_ASSERT_TRUE(bytewise.ubx == spanwise.ubx);
+  TEST_ASSERT_TRUE(bytewise.logged == spanwise.logged);
+  TEST_ASSERT_LESS_THAN(process.seconds(), processSpan.seconds());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stream_parser_speed);
+  return (UNITY_END());
+}
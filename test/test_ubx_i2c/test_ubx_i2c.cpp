@@ -0,0 +1,164 @@
+//Buffered I2C reading in SFE_UBLOX_GNSS against a scripted receiver (test/native_arduino/Wire.h). A second of
+//corrections and navigation output arrives in one burst: read under a budget it must all still come through intact,
+//while no single check of the port holds the loop for more than the budget's time on the wire
+
+#include <unity.h>
+#include <vector>
+#include <SparkFun_u-blox_GNSS_Arduino_Library.h>
+
+static const uint32_t I2C_CLOCK = 400000;
+static const uint16_t READ_BUDGET = 256;
+static const uint8_t TX_READY_PIN = 5;
+
+static uint32_t seed;
+static uint8_t random8() {
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16);
+}
+
+//What the receiver sends, and what the parser gave back
+static std::vector<std::vector<uint8_t>> rtcmSent;
+static std::vector<std::vector<uint8_t>> rtcmDelivered;
+static uint32_t ubxSent;
+static uint32_t ubxDelivered;
+
+static void frameReady(const uint8_t* frame, uint16_t length, uint16_t, uint32_t) {
+  rtcmDelivered.push_back(std::vector<uint8_t>(frame, frame + length));
+}
+
+static void meter(uint8_t cls, uint8_t, uint16_t) {
+  if (cls != 0xF5)
+    ubxDelivered++;
+}
+
+static void queueUBX(uint8_t cls, uint8_t id, uint16_t length) {
+  std::vector<uint8_t> message = { 0xB5, 0x62, cls, id, (uint8_t)length, (uint8_t)(length >> 8) };
+  for (uint16_t x = 0; x < length; x++)
+    message.push_back(random8());
+  uint8_t checksumA = 0, checksumB = 0;
+  fletcher8(&message[2], message.size() - 2, checksumA, checksumB);
+  message.push_back(checksumA);
+  message.push_back(checksumB);
+  Wire.queue(message.data(), message.size());
+  ubxSent++;
+}
+
+static void queueRTCM(uint16_t messageNumber, uint16_t length) {
+  std::vector<uint8_t> frame = { 0xD3, (uint8_t)(length >> 8), (uint8_t)length, (uint8_t)(messageNumber >> 4), (uint8_t)(messageNumber << 4) };
+  for (uint16_t x = 2; x < length; x++)
+    frame.push_back(random8());
+  uint32_t crc = crc24q(frame.data(), frame.size());
+  frame.push_back(crc >> 16);
+  frame.push_back(crc >> 8);
+  frame.push_back(crc);
+  Wire.queue(frame.data(), frame.size());
+  rtcmSent.push_back(frame);
+}
+
+//One epoch of MSM7 and station messages, with RAWX and navigation solutions between them
+static void queueBurst() {
+  queueRTCM(1005, 19);
+  queueUBX(0x02, 0x15, 16 + 32 * 40);
+  queueRTCM(1077, 319);
+  queueUBX(0x01, 0x07, 92);
+  queueRTCM(1087, 220);
+  queueUBX(0x01, 0x14, 36);
+  queueRTCM(1097, 269);
+  queueUBX(0x01, 0x03, 16);
+  queueRTCM(1127, 319);
+  queueRTCM(1230, 8);
+}
+
+//begin() polls for a receiver that never answers, then the burst is queued
+static void start(SFE_UBLOX_GNSS& gnss, uint16_t bufferSize) {
+  gnss.setI2CBufferSize(bufferSize);
+  gnss.setI2CReadBudget(READ_BUDGET);
+  gnss.begin(Wire, 0x42, 10);
+  gnss.setRTCMFrameCallbackPtr(&frameReady);
+  gnss.setMessageMeterCallbackPtr(&meter);
+  gnss.clearI2CStats();
+  queueBurst();
+}
+
+//Check the port once a millisecond of loop time until the receiver has nothing left
+static void run(SFE_UBLOX_GNSS& gnss) {
+  for (uint16_t x = 0; x < 1000; x++) {
+    gnss.checkUblox();
+    nativeMicros += 1000;
+  }
+}
+
+static void checkDelivered() {
+  TEST_ASSERT_EQUAL(0, Wire.queued());
+  TEST_ASSERT_EQUAL(rtcmSent.size(), rtcmDelivered.size());
+  for (size_t x = 0; x < rtcmSent.size(); x++)
+    TEST_ASSERT_TRUE(rtcmSent[x] == rtcmDelivered[x]);
+  TEST_ASSERT_EQUAL(ubxSent, ubxDelivered);
+}
+
+void setUp() {
+  seed = 2024;
+  nativeMicros = 0;
+  Wire = TwoWire();
+  Wire.setClock(I2C_CLOCK);
+  rtcmSent.clear();
+  rtcmDelivered.clear();
+  ubxSent = 0;
+  ubxDelivered = 0;
+}
+
+void tearDown() {}
+
+void test_budgeted_reads_deliver_everything() {
+  SFE_UBLOX_GNSS gnss;
+  start(gnss, 2048);
+  run(gnss);
+  checkDelivered();
+}
+
+//The stall removed: reading everything on one check against reading at most READ_BUDGET bytes a check
+void test_stall_bounded_by_budget() {
+  SFE_UBLOX_GNSS unbuffered;
+  start(unbuffered, 0);
+  run(unbuffered);
+  checkDelivered();
+  uint32_t unbufferedStall = unbuffered.getMaxCheckStall();
+
+  setUp();
+  SFE_UBLOX_GNSS buffered;
+  start(buffered, 2048);
+  run(buffered);
+  checkDelivered();
+  uint32_t bufferedStall = buffered.getMaxCheckStall();
+
+  //The budget's bytes and their address bytes, plus the 0xFD/0xFE read, on the wire
+  uint32_t budgetTime = (READ_BUDGET + READ_BUDGET / 32 + 5) * 9 * 1000000ULL / I2C_CLOCK;
+  printf("Longest check of the port: %lu us reading everything, %lu us with a %u byte budget\r\n",
+         (unsigned long)unbufferedStall, (unsigned long)bufferedStall, READ_BUDGET);
+  TEST_ASSERT_LESS_OR_EQUAL(budgetTime, bufferedStall);
+  TEST_ASSERT_LESS_THAN(unbufferedStall / 4, bufferedStall);
+}
+
+//With a TX-ready pin the bus is left alone until the receiver raises it
+void test_tx_ready_pin() {
+  SFE_UBLOX_GNSS gnss;
+  gnss.setI2CTxReadyPin(TX_READY_PIN);
+  digitalWrite(TX_READY_PIN, LOW);
+  start(gnss, 2048);
+  uint32_t transactions = Wire.transactions;
+  run(gnss);
+  TEST_ASSERT_EQUAL(transactions, Wire.transactions);
+  TEST_ASSERT_EQUAL(0, rtcmDelivered.size());
+
+  digitalWrite(TX_READY_PIN, HIGH);
+  run(gnss);
+  checkDelivered();
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_budgeted_reads_deliver_everything);
+  RUN_TEST(test_stall_bounded_by_budget);
+  RUN_TEST(test_tx_ready_pin);
+  return (UNITY_END());
+}